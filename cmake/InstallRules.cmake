@@ -6,7 +6,7 @@ set(INSTALL_LOCATION_BIN ${INSTALL_LOCATION}/bin)
 set(INSTALL_LOCATION_ASSETS ${INSTALL_LOCATION}/assets)
 
 # Installation - common
-install(TARGETS ${EXEC_NAME} DESTINATION ${INSTALL_LOCATION_BIN})
+install(TARGETS ${EXEC_NAME} logdecode DESTINATION ${INSTALL_LOCATION_BIN})
 
 # Installation - SDL
 if(${CMAKE_SYSTEM_NAME} STREQUAL "Windows")
@@ -23,6 +23,8 @@ else()
     set(__ZLIB_PREFIX "/opt/zlib/linux")
     set(__LIBZIP_PREFIX "/opt/libzip/linux")
     set(__SDL_LIB_NAMES "${SDL_USED_VERSION}" "${SDL_USED_VERSION}_image") 
+    # async logger thread
+    set(__OTHER_LIBS "pthread")
     set(__ZLIB_LIB_NAMES "libz.a")
     set(__LIBZIP_LIB_NAMES "zip")
     # From sdl2-config --cflags
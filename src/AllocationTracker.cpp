@@ -0,0 +1,163 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+#define ALLOC_X(name) #name,
+    constexpr const char* AllocationTagNames[] = {_ALLOCATION_TAGS_};
+#undef ALLOC_X
+
+    constexpr auto TagsNum = static_cast<size_t>(GameEngine::AllocationTag::COUNT);
+
+    // Constant-initialized: operator new may be called before any dynamic initialization
+    struct ThreadCounters
+    {
+        GameEngine::AllocationStats total;
+        GameEngine::AllocationStats tags[TagsNum];
+        GameEngine::AllocationTag currentTag = GameEngine::AllocationTag::GENERAL;
+    };
+
+    thread_local ThreadCounters t_counters{};
+
+    GameEngine::AllocationStats Subtract(const GameEngine::AllocationStats& lhs, const GameEngine::AllocationStats& rhs) noexcept
+    {
+        return {lhs.allocations - rhs.allocations, lhs.deallocations - rhs.deallocations, lhs.bytes - rhs.bytes};
+    }
+
+#ifdef GAME_ENGINE_ALLOC_TRACKING
+    void* TrackedAlloc(std::size_t size)
+    {
+        if (size == 0)
+        {
+            size = 1;
+        }
+
+        for (;;)
+        {
+            if (void* const ptr = std::malloc(size))
+            {
+                auto& counters = t_counters;
+                auto& tagStats = counters.tags[static_cast<size_t>(counters.currentTag)];
+                ++counters.total.allocations;
+                counters.total.bytes += size;
+                ++tagStats.allocations;
+                tagStats.bytes += size;
+                return ptr;
+            }
+
+            const auto handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void TrackedFree(void* ptr) noexcept
+    {
+        if (ptr)
+        {
+            auto& counters = t_counters;
+            ++counters.total.deallocations;
+            ++counters.tags[static_cast<size_t>(counters.currentTag)].deallocations;
+            std::free(ptr);
+        }
+    }
+#endif
+} // namespace
+
+#ifdef GAME_ENGINE_ALLOC_TRACKING
+// Aligned (std::align_val_t) overloads are left to the standard library
+void* operator new(std::size_t size) { return TrackedAlloc(size); }
+void* operator new[](std::size_t size) { return TrackedAlloc(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return TrackedAlloc(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+#endif
+
+namespace GameEngine
+{
+    bool IsAllocationTrackingEnabled() noexcept
+    {
+#ifdef GAME_ENGINE_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocationStats GetThreadAllocationStats() noexcept
+    {
+        return t_counters.total;
+    }
+
+    AllocationStats GetThreadAllocationStats(AllocationTag tag) noexcept
+    {
+        return t_counters.tags[static_cast<size_t>(tag)];
+    }
+
+    const char* GetAllocationTagName(AllocationTag tag) noexcept
+    {
+        return tag < AllocationTag::COUNT ? ::AllocationTagNames[static_cast<size_t>(tag)] : "UNKNOWN";
+    }
+
+    AllocationTagScope::AllocationTagScope(AllocationTag tag) noexcept
+        : m_prevTag(t_counters.currentTag)
+    {
+        t_counters.currentTag = tag;
+    }
+
+    AllocationTagScope::~AllocationTagScope()
+    {
+        t_counters.currentTag = m_prevTag;
+    }
+
+    AllocationCounter::AllocationCounter() noexcept
+    {
+        Restart();
+    }
+
+    void AllocationCounter::Restart() noexcept
+    {
+        m_start = t_counters.total;
+        for (size_t i = 0; i < TagsNum; ++i)
+        {
+            m_tagStart[i] = t_counters.tags[i];
+        }
+    }
+
+    AllocationStats AllocationCounter::GetStats() const noexcept
+    {
+        return Subtract(t_counters.total, m_start);
+    }
+
+    AllocationStats AllocationCounter::GetStats(AllocationTag tag) const noexcept
+    {
+        const auto idx = static_cast<size_t>(tag);
+        return Subtract(t_counters.tags[idx], m_tagStart[idx]);
+    }
+} // namespace GameEngine
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+#define _ALLOCATION_TAGS_   \
+    ALLOC_X(GENERAL)        \
+    ALLOC_X(LOGGER)         \
+    ALLOC_X(INPUT)          \
+    ALLOC_X(GAME_LOGIC)     \
+    ALLOC_X(RENDER)         \
+
+
+namespace GameEngine
+{
+    // Subsystem the allocations of the calling thread are attributed to
+#define ALLOC_X(name) name,
+    enum class AllocationTag : unsigned int
+    {
+        _ALLOCATION_TAGS_
+        COUNT
+    };
+#undef ALLOC_X
+
+    struct AllocationStats
+    {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t bytes = 0; // allocated bytes
+    };
+
+    // true when built with ENABLE_ALLOC_TRACKING (global operator new/delete are hooked),
+    // otherwise all the stats below stay zero
+    bool IsAllocationTrackingEnabled() noexcept;
+
+    // Totals of the calling thread since its start
+    AllocationStats GetThreadAllocationStats() noexcept;
+    AllocationStats GetThreadAllocationStats(AllocationTag tag) noexcept;
+    const char* GetAllocationTagName(AllocationTag tag) noexcept;
+
+    // Attributes allocations of the calling thread to the tag while alive
+    class AllocationTagScope
+    {
+    public:
+        explicit AllocationTagScope(AllocationTag tag) noexcept;
+        AllocationTagScope(const AllocationTagScope&) = delete;
+        AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+        ~AllocationTagScope();
+
+    private:
+        const AllocationTag m_prevTag;
+    };
+
+    // Counts allocations of the calling thread made since construction or the last Restart()
+    class AllocationCounter
+    {
+    public:
+        AllocationCounter() noexcept;
+
+        void Restart() noexcept;
+        AllocationStats GetStats() const noexcept;
+        AllocationStats GetStats(AllocationTag tag) const noexcept;
+
+    private:
+        AllocationStats m_start;
+        AllocationStats m_tagStart[static_cast<size_t>(AllocationTag::COUNT)];
+    };
+} // namespace GameEngine
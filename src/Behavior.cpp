@@ -0,0 +1,422 @@
+#include "Behavior.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+
+namespace GameEngine
+{
+    namespace
+    {
+        // slabs with an intrusive free list, as ObjectPool but for a size class
+        class FrameSizeClass
+        {
+        public:
+            void* Allocate(size_t blockSize)
+            {
+                const std::scoped_lock lock(m_lock);
+                if (!m_freeList)
+                {
+                    add_slab(blockSize);
+                }
+                auto* block = m_freeList;
+                m_freeList = block->next;
+                ++m_usedBlocks;
+                return block;
+            }
+
+            void Deallocate(void* ptr) noexcept
+            {
+                const std::scoped_lock lock(m_lock);
+                auto* block = static_cast<Block*>(ptr);
+                block->next = m_freeList;
+                m_freeList = block;
+                --m_usedBlocks;
+            }
+
+            size_t GetUsedBlocks()
+            {
+                const std::scoped_lock lock(m_lock);
+                return m_usedBlocks;
+            }
+
+            size_t GetCapacity()
+            {
+                const std::scoped_lock lock(m_lock);
+                return m_capacity;
+            }
+
+        private:
+            struct Block
+            {
+                Block* next;
+            };
+            static constexpr size_t SlabSize = 16 * 1024;
+
+            void add_slab(size_t blockSize)
+            {
+                const auto blocksNum = std::max<size_t>(4, SlabSize / blockSize);
+                m_slabs.emplace_back(new std::byte[blocksNum * blockSize]);
+                auto* slab = m_slabs.back().get();
+                // link backwards so blocks are handed out in address order
+                for (size_t i = blocksNum; i > 0; --i)
+                {
+                    auto* block = reinterpret_cast<Block*>(slab + (i - 1) * blockSize);
+                    block->next = m_freeList;
+                    m_freeList = block;
+                }
+                m_capacity += blocksNum;
+            }
+
+            std::mutex m_lock;
+            std::vector<std::unique_ptr<std::byte[]>> m_slabs;
+            Block* m_freeList = nullptr;
+            size_t m_usedBlocks = 0;
+            size_t m_capacity = 0;
+        };
+
+        std::array<FrameSizeClass, CoroutineFramePool::ClassesNum>& GetSizeClasses()
+        {
+            // never destroyed: frames may outlive static destruction
+            static auto* classes = new std::array<FrameSizeClass, CoroutineFramePool::ClassesNum>();
+            return *classes;
+        }
+
+        // index of the class serving the size, ClassesNum - none
+        size_t GetSizeClass(size_t size)
+        {
+            return size ? std::min((size - 1) / CoroutineFramePool::Granularity, CoroutineFramePool::ClassesNum) : 0;
+        }
+
+        constexpr BehaviorId MakeId(uint32_t slot, uint32_t generation)
+        {
+            return (static_cast<BehaviorId>(generation) << 32) | slot;
+        }
+
+        constexpr uint32_t GetSlot(BehaviorId id)
+        {
+            return static_cast<uint32_t>(id);
+        }
+    } // namespace
+
+    void* CoroutineFramePool::Allocate(size_t size)
+    {
+        const auto sizeClass = GetSizeClass(size);
+        if (sizeClass == ClassesNum)
+        {
+            return ::operator new(size);
+        }
+        return GetSizeClasses()[sizeClass].Allocate((sizeClass + 1) * Granularity);
+    }
+
+    void CoroutineFramePool::Deallocate(void* ptr, size_t size) noexcept
+    {
+        if (!ptr)
+        {
+            return;
+        }
+        const auto sizeClass = GetSizeClass(size);
+        if (sizeClass == ClassesNum)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        GetSizeClasses()[sizeClass].Deallocate(ptr);
+    }
+
+    size_t CoroutineFramePool::GetUsedBlocks()
+    {
+        size_t used = 0;
+        for (auto& sizeClass : GetSizeClasses())
+        {
+            used += sizeClass.GetUsedBlocks();
+        }
+        return used;
+    }
+
+    size_t CoroutineFramePool::GetCapacity()
+    {
+        size_t capacity = 0;
+        for (auto& sizeClass : GetSizeClasses())
+        {
+            capacity += sizeClass.GetCapacity();
+        }
+        return capacity;
+    }
+
+    Behavior::Behavior(Handle handle)
+        : m_handle(handle)
+    {
+    }
+
+    Behavior::Behavior(Behavior&& other) noexcept
+        : m_handle(other.release())
+    {
+    }
+
+    Behavior& Behavior::operator=(Behavior&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = other.release();
+        }
+        return *this;
+    }
+
+    Behavior::~Behavior()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    Behavior::Handle Behavior::release()
+    {
+        return std::exchange(m_handle, {});
+    }
+
+    void NextFrame::await_suspend(Behavior::Handle handle) const
+    {
+        auto& promise = handle.promise();
+        promise.scheduler->make_ready(promise.id);
+    }
+
+    void Seconds::await_suspend(Behavior::Handle handle) const
+    {
+        auto& promise = handle.promise();
+        promise.scheduler->wait_time(promise.id, seconds);
+    }
+
+    void Completion::Complete()
+    {
+        std::vector<Waiter> waiters;
+        {
+            const std::scoped_lock lock(m_lock);
+            m_isDone = true;
+            waiters.swap(m_waiters);
+        }
+        for (const auto& waiter : waiters)
+        {
+            waiter.scheduler->make_ready_remote(waiter.id);
+        }
+    }
+
+    bool Completion::IsDone() const
+    {
+        const std::scoped_lock lock(m_lock);
+        return m_isDone;
+    }
+
+    bool Completion::Awaiter::await_suspend(Behavior::Handle handle) const
+    {
+        auto& promise = handle.promise();
+        const std::scoped_lock lock(completion.m_lock);
+        if (completion.m_isDone)
+        {
+            return false; // completed meanwhile, goes on
+        }
+        completion.m_waiters.push_back({ promise.scheduler, promise.id });
+        return true;
+    }
+
+    BehaviorScheduler::BehaviorScheduler(EventBus& eventBus)
+        : m_eventBus(eventBus)
+    {
+    }
+
+    BehaviorScheduler::~BehaviorScheduler()
+    {
+        for (const auto& [type, waiters] : m_eventWaiters)
+        {
+            m_eventBus.Unsubscribe(waiters->subscription);
+        }
+        for (auto& slot : m_slots)
+        {
+            if (slot.handle)
+            {
+                slot.handle.destroy();
+            }
+        }
+    }
+
+    BehaviorId BehaviorScheduler::Start(Behavior behavior)
+    {
+        auto handle = behavior.release();
+        if (!handle)
+        {
+            return 0;
+        }
+        uint32_t index = 0;
+        if (m_freeSlots.empty())
+        {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        else
+        {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        auto& slot = m_slots[index];
+        slot.handle = handle;
+        // never 0, so no id is 0
+        const auto id = MakeId(index, ++slot.generation);
+        handle.promise().scheduler = this;
+        handle.promise().id = id;
+        ++m_count;
+        resume(id);
+        return id;
+    }
+
+    void BehaviorScheduler::Stop(BehaviorId id)
+    {
+        if (!find(id))
+        {
+            return;
+        }
+        auto& slot = m_slots[GetSlot(id)];
+        if (slot.isResumed)
+        {
+            slot.isStopped = true;
+            return;
+        }
+        destroy(id);
+    }
+
+    bool BehaviorScheduler::IsRunning(BehaviorId id) const
+    {
+        return find(id) && !m_slots[GetSlot(id)].isStopped;
+    }
+
+    void BehaviorScheduler::Resume(float elapsed)
+    {
+        m_time += elapsed;
+        {
+            const std::scoped_lock lock(m_remoteLock);
+            m_ready.insert(m_ready.end(), m_remoteReady.begin(), m_remoteReady.end());
+            m_remoteReady.clear();
+        }
+        while (!m_timers.empty() && m_timers.front().time <= m_time)
+        {
+            m_ready.push_back(m_timers.front().id);
+            std::pop_heap(m_timers.begin(), m_timers.end(), std::greater<>());
+            m_timers.pop_back();
+        }
+        // behaviors made ready meanwhile are appended to m_ready and wait for the next frame
+        m_resuming.swap(m_ready);
+        for (size_t i = 0; i < m_resuming.size(); ++i)
+        {
+            try
+            {
+                resume(m_resuming[i]);
+            }
+            catch (...)
+            {
+                // the rest are resumed by the next call
+                m_ready.insert(m_ready.end(), m_resuming.begin() + static_cast<std::ptrdiff_t>(i) + 1, m_resuming.end());
+                m_resuming.clear();
+                throw;
+            }
+        }
+        m_resuming.clear();
+    }
+
+    size_t BehaviorScheduler::GetCount() const
+    {
+        return m_count;
+    }
+
+    double BehaviorScheduler::GetTime() const
+    {
+        return m_time;
+    }
+
+    bool BehaviorScheduler::HasReady() const
+    {
+        if (!m_ready.empty())
+        {
+            return true;
+        }
+        const std::scoped_lock lock(m_remoteLock);
+        return !m_remoteReady.empty();
+    }
+
+    double BehaviorScheduler::GetNextTimerTime() const
+    {
+        return m_timers.empty() ? std::numeric_limits<double>::infinity() : m_timers.front().time;
+    }
+
+    void BehaviorScheduler::make_ready(BehaviorId id)
+    {
+        m_ready.push_back(id);
+    }
+
+    void BehaviorScheduler::make_ready_remote(BehaviorId id)
+    {
+        const std::scoped_lock lock(m_remoteLock);
+        m_remoteReady.push_back(id);
+    }
+
+    void BehaviorScheduler::wait_time(BehaviorId id, float seconds)
+    {
+        m_timers.push_back({ m_time + seconds, m_timersNum++, id });
+        std::push_heap(m_timers.begin(), m_timers.end(), std::greater<>());
+    }
+
+    Behavior::Handle BehaviorScheduler::find(BehaviorId id) const
+    {
+        const auto index = GetSlot(id);
+        if (index >= m_slots.size())
+        {
+            return {};
+        }
+        const auto& slot = m_slots[index];
+        return MakeId(index, slot.generation) == id ? slot.handle : Behavior::Handle();
+    }
+
+    void BehaviorScheduler::resume(BehaviorId id)
+    {
+        // stopped ones leave stale ids in the lists
+        auto handle = find(id);
+        if (!handle)
+        {
+            return;
+        }
+        const auto index = GetSlot(id);
+        m_slots[index].isResumed = true;
+        handle.resume();
+        // by index: the slots may grow meanwhile
+        m_slots[index].isResumed = false;
+        if (m_slots[index].isStopped)
+        {
+            destroy(id);
+            return;
+        }
+        if (handle.done())
+        {
+            const auto exception = handle.promise().exception;
+            destroy(id);
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+    void BehaviorScheduler::destroy(BehaviorId id)
+    {
+        const auto index = GetSlot(id);
+        auto& slot = m_slots[index];
+        slot.handle.destroy();
+        slot.handle = {};
+        slot.isStopped = false;
+        m_freeSlots.push_back(index);
+        --m_count;
+    }
+} // namespace GameEngine
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "EventBus.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GameEngine
+{
+    class BehaviorScheduler;
+
+    // Pool of coroutine frames, sized in classes of Granularity bytes; larger frames fall back to the heap.
+    // Freed blocks are reused, slabs are kept until the process ends
+    class CoroutineFramePool
+    {
+    public:
+        static constexpr size_t Granularity = 64;
+        static constexpr size_t ClassesNum = 16; // frames up to 1 KB are pooled
+
+        static void* Allocate(size_t size);
+        static void Deallocate(void* ptr, size_t size) noexcept;
+
+        // of all the size classes
+        static size_t GetUsedBlocks();
+        static size_t GetCapacity();
+    };
+
+    // 0 - none
+    using BehaviorId = uint64_t;
+
+    // Coroutine driven by a BehaviorScheduler, e.g.
+    //   Behavior Patrol(Guard& guard)
+    //   {
+    //       for (;;)
+    //       {
+    //           guard.Turn();
+    //           co_await Seconds(0.5f);
+    //           const auto hit = co_await Event<DamageEvent>();
+    //           ...
+    //       }
+    //   }
+    // The body doesn't run until started by the scheduler, which owns it from then on.
+    // A suspended behavior is only listed by what it waits for, so it costs nothing per frame
+    class Behavior
+    {
+    public:
+        struct promise_type
+        {
+            BehaviorScheduler* scheduler = nullptr;
+            BehaviorId id = 0;
+            std::exception_ptr exception;
+
+            Behavior get_return_object()
+            {
+                return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_always final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            static void* operator new(size_t size) { return CoroutineFramePool::Allocate(size); }
+            static void operator delete(void* ptr, size_t size) noexcept { CoroutineFramePool::Deallocate(ptr, size); }
+        };
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Behavior(Behavior&& other) noexcept;
+        Behavior& operator=(Behavior&& other) noexcept;
+        Behavior(const Behavior&) = delete;
+        Behavior& operator=(const Behavior&) = delete;
+        // destroys the coroutine unless started
+        ~Behavior();
+
+    private:
+        friend class BehaviorScheduler;
+
+        explicit Behavior(Handle handle);
+        Handle release();
+
+        Handle m_handle;
+    };
+
+    // co_await NextFrame(): resumes on the next BehaviorScheduler::Resume()
+    struct NextFrame
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Behavior::Handle handle) const;
+        void await_resume() const noexcept {}
+    };
+
+    // co_await Seconds(0.5f): resumes on the first frame the scheduler time reaches the deadline
+    struct Seconds
+    {
+        float seconds;
+
+        explicit Seconds(float s) : seconds(s) {}
+        bool await_ready() const noexcept { return seconds <= 0; }
+        void await_suspend(Behavior::Handle handle) const;
+        void await_resume() const noexcept {}
+    };
+
+    // const auto e = co_await Event<DamageEvent>(): resumes on the frame after the next event of the type
+    // delivered by the EventBus, either published or dispatched
+    template <typename E>
+    struct Event
+    {
+        std::optional<E> event;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Behavior::Handle handle);
+        E await_resume() { return *event; }
+    };
+
+    // One-shot signal behaviors may wait for, e.g. an asset loaded by a worker thread:
+    //   co_await texture.loaded;
+    // Complete() may be called from any thread; waiters resume on the next frame of their scheduler,
+    // which has to outlive the signal. Waiting for a completed signal doesn't suspend
+    class Completion
+    {
+    public:
+        Completion() = default;
+        Completion(const Completion&) = delete;
+        Completion& operator=(const Completion&) = delete;
+
+        void Complete();
+        bool IsDone() const;
+
+        struct Awaiter
+        {
+            Completion& completion;
+
+            bool await_ready() const { return completion.IsDone(); }
+            bool await_suspend(Behavior::Handle handle) const;
+            void await_resume() const noexcept {}
+        };
+        Awaiter operator co_await() { return { *this }; }
+
+    private:
+        struct Waiter
+        {
+            BehaviorScheduler* scheduler;
+            BehaviorId id;
+        };
+
+        mutable std::mutex m_lock;
+        bool m_isDone = false;
+        std::vector<Waiter> m_waiters;
+    };
+
+    // Runs the behaviors of a game loop. Resume() resumes only the ready ones: those waiting for the next frame,
+    // whose time has come, which got their event or completion. Behaviors made ready during Resume() wait for the next one.
+    // Ids are reused slots, so a warmed up scheduler doesn't allocate; frames come from CoroutineFramePool
+    class BehaviorScheduler
+    {
+    public:
+        explicit BehaviorScheduler(EventBus& eventBus);
+        BehaviorScheduler(const BehaviorScheduler&) = delete;
+        BehaviorScheduler& operator=(const BehaviorScheduler&) = delete;
+        ~BehaviorScheduler();
+
+        // runs the behavior until its first suspension. An exception thrown by a behavior destroys it
+        // and is rethrown to the caller of Start() or Resume()
+        BehaviorId Start(Behavior behavior);
+        // destroys the suspended behavior, e.g. when the object it works on goes away
+        void Stop(BehaviorId id);
+        bool IsRunning(BehaviorId id) const;
+
+        void Resume(float elapsed);
+
+        size_t GetCount() const;
+        // seconds, sum of the elapsed times
+        double GetTime() const;
+        // some behavior is to be resumed by the next Resume() regardless of the time
+        bool HasReady() const;
+        // GetTime() the next waiting behavior is due at, infinity if none
+        double GetNextTimerTime() const;
+
+    private:
+        friend struct NextFrame;
+        friend struct Seconds;
+        template <typename E>
+        friend struct Event;
+        friend class Completion;
+
+        struct Slot
+        {
+            Behavior::Handle handle;
+            uint32_t generation = 0;
+            bool isResumed = false; // may start other behaviors, which may stop it
+            bool isStopped = false; // while resumed, destroyed once suspended
+        };
+
+        struct Timer
+        {
+            double time;
+            uint64_t order; // timers due at the same time resume in the order they were set
+            BehaviorId id;
+
+            bool operator>(const Timer& other) const
+            {
+                return time != other.time ? time > other.time : order > other.order;
+            }
+        };
+
+        struct IEventWaiters
+        {
+            virtual ~IEventWaiters() = default;
+
+            EventSubscription subscription;
+        };
+
+        template <typename E>
+        struct EventWaiters final : IEventWaiters
+        {
+            BehaviorScheduler* scheduler = nullptr;
+            std::vector<std::pair<BehaviorId, Event<E>*>> waiters;
+
+            void OnEvent(const E& event)
+            {
+                for (const auto& [id, awaiter] : waiters)
+                {
+                    // the awaiter lives in the coroutine frame: gone with a stopped behavior
+                    if (scheduler->IsRunning(id))
+                    {
+                        awaiter->event = event;
+                        scheduler->make_ready(id);
+                    }
+                }
+                waiters.clear();
+            }
+        };
+
+        template <typename E>
+        void wait_event(BehaviorId id, Event<E>* awaiter)
+        {
+            auto& waiters = m_eventWaiters[std::type_index(typeid(E))];
+            if (!waiters)
+            {
+                auto channel = std::make_unique<EventWaiters<E>>();
+                channel->scheduler = this;
+                channel->subscription = m_eventBus.Subscribe<E>(EventBus::Handler<E>::template Bind<&EventWaiters<E>::OnEvent>(channel.get()));
+                waiters = std::move(channel);
+            }
+            static_cast<EventWaiters<E>&>(*waiters).waiters.emplace_back(id, awaiter);
+        }
+
+        void make_ready(BehaviorId id);
+        // thread-safe, picked up by the next Resume()
+        void make_ready_remote(BehaviorId id);
+        void wait_time(BehaviorId id, float seconds);
+        // returns the handle of the running behavior, null if stopped
+        Behavior::Handle find(BehaviorId id) const;
+        void resume(BehaviorId id);
+        void destroy(BehaviorId id);
+
+        EventBus& m_eventBus;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        size_t m_count = 0;
+        std::vector<BehaviorId> m_ready;
+        std::vector<BehaviorId> m_resuming;
+        std::vector<Timer> m_timers; // min-heap
+        uint64_t m_timersNum = 0;
+        std::unordered_map<std::type_index, std::unique_ptr<IEventWaiters>> m_eventWaiters;
+        mutable std::mutex m_remoteLock;
+        std::vector<BehaviorId> m_remoteReady;
+        double m_time = 0;
+    };
+
+    template <typename E>
+    void Event<E>::await_suspend(Behavior::Handle handle)
+    {
+        auto& promise = handle.promise();
+        promise.scheduler->wait_event<E>(promise.id, this);
+    }
+} // namespace GameEngine
@@ -0,0 +1,320 @@
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Binary log file layout shared by BinaryLogChannel and logdecode tool.
+// Values are stored in the native byte order.
+//
+//  file:   Magic, uint32 Version, records...
+//  ANCHOR: int64 system clock ns, int64 steady clock ns (maps steady timestamps to wall time)
+//  SITE:   uint32 id, uint8 level, uint32 line, uint16 size + file, uint16 size + format
+//  RECORD: uint32 site id, uint32 prefix id (0 - none), int64 steady clock ns, uint16 size + encoded arguments,
+//          the last one TRUNCATED if the rest didn't fit
+//  TEXT:   int64 system clock ns, uint8 level, uint16 size + prefix, uint32 size + already formatted message
+//  PREFIX: uint32 id, uint16 size + prefix
+//
+// SITE and PREFIX are written once per file before the first RECORD referring to them.
+namespace GameEngine::BinaryLog
+{
+    constexpr std::array<char, 8> Magic = {'G', 'E', 'B', 'I', 'N', 'L', 'O', 'G'};
+    constexpr uint32_t Version = 4;
+
+    enum class RecordKind : uint8_t
+    {
+        ANCHOR,
+        SITE,
+        RECORD,
+        TEXT,
+        PREFIX,
+    };
+
+    // argument encoding: type tag followed by the value, strings are uint16 size + chars
+    enum class ArgType : uint8_t
+    {
+        INT,
+        UINT,
+        DOUBLE,
+        BOOL,
+        CHAR,
+        STRING,
+        TRUNCATED, // no value: the arguments from here on didn't fit
+    };
+
+    // appended to messages whose arguments were cut off
+    constexpr std::string_view TruncatedMarker = " [arguments truncated]";
+
+    // Encoded arguments of a single record, never allocates: what doesn't fit is cut off,
+    // the following arguments are skipped so that the rest of the message doesn't get wrong values
+    class ArgsBuffer
+    {
+    public:
+        static constexpr size_t Capacity = 192;
+
+        template <typename T>
+        void Add(const T& value)
+        {
+            using Type = std::decay_t<T>;
+            if constexpr (std::is_same_v<Type, bool>)
+            {
+                put_tagged(ArgType::BOOL, static_cast<uint8_t>(value));
+            }
+            else if constexpr (std::is_same_v<Type, char>)
+            {
+                put_tagged(ArgType::CHAR, value);
+            }
+            else if constexpr (std::is_enum_v<Type>)
+            {
+                Add(static_cast<std::underlying_type_t<Type>>(value));
+            }
+            else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+            {
+                put_tagged(ArgType::INT, static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_integral_v<Type>)
+            {
+                put_tagged(ArgType::UINT, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_floating_point_v<Type>)
+            {
+                put_tagged(ArgType::DOUBLE, static_cast<double>(value));
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                add_string(value);
+            }
+            else
+            {
+                static_assert(!sizeof(Type), "Unsupported binary log argument type");
+            }
+        }
+
+        std::span<const std::byte> GetBytes() const noexcept
+        {
+            return {m_data.data(), m_size};
+        }
+
+        bool IsTruncated() const noexcept
+        {
+            return m_truncated;
+        }
+
+    private:
+        // the last byte is kept for the TRUNCATED tag
+        static constexpr size_t ValuesCapacity = Capacity - 1;
+
+        template <typename V>
+        void put_tagged(ArgType type, V value) noexcept
+        {
+            if (m_truncated || m_size + 1 + sizeof(V) > ValuesCapacity)
+            {
+                truncate();
+                return;
+            }
+            m_data[m_size++] = static_cast<std::byte>(type);
+            std::memcpy(m_data.data() + m_size, &value, sizeof(V));
+            m_size += sizeof(V);
+        }
+
+        void add_string(std::string_view str) noexcept
+        {
+            constexpr size_t header = 1 + sizeof(uint16_t);
+            if (m_truncated || m_size + header > ValuesCapacity)
+            {
+                truncate();
+                return;
+            }
+            // a long string keeps its beginning
+            const auto size = static_cast<uint16_t>(std::min(str.size(), ValuesCapacity - m_size - header));
+            m_data[m_size++] = static_cast<std::byte>(ArgType::STRING);
+            std::memcpy(m_data.data() + m_size, &size, sizeof(size));
+            m_size += sizeof(size);
+            std::memcpy(m_data.data() + m_size, str.data(), size);
+            m_size += size;
+            if (size < str.size())
+            {
+                truncate();
+            }
+        }
+
+        void truncate() noexcept
+        {
+            if (!m_truncated)
+            {
+                m_truncated = true;
+                m_data[m_size++] = static_cast<std::byte>(ArgType::TRUNCATED);
+            }
+        }
+
+        std::array<std::byte, Capacity> m_data;
+        size_t m_size = 0;
+        bool m_truncated = false;
+    };
+
+    // Sequential reader of raw bytes, fails (returns false) instead of reading out of bounds
+    class Reader
+    {
+    public:
+        explicit Reader(std::span<const std::byte> bytes) noexcept
+            : m_bytes(bytes)
+        {
+        }
+
+        template <typename V>
+        bool Read(V& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<V>);
+            if (m_bytes.size() < sizeof(V))
+            {
+                return false;
+            }
+            std::memcpy(&value, m_bytes.data(), sizeof(V));
+            m_bytes = m_bytes.subspan(sizeof(V));
+            return true;
+        }
+
+        bool Read(std::string_view& str, size_t size) noexcept
+        {
+            if (m_bytes.size() < size)
+            {
+                return false;
+            }
+            str = {reinterpret_cast<const char*>(m_bytes.data()), size};
+            m_bytes = m_bytes.subspan(size);
+            return true;
+        }
+
+        bool IsEmpty() const noexcept
+        {
+            return m_bytes.empty();
+        }
+
+    private:
+        std::span<const std::byte> m_bytes;
+    };
+
+    // decodes the next argument and appends it as text, false at the TRUNCATED tag as well
+    inline bool AppendArg(Reader& reader, std::string& out, bool& isTruncated)
+    {
+        uint8_t type = 0;
+        if (!reader.Read(type))
+        {
+            return false;
+        }
+        switch (static_cast<ArgType>(type))
+        {
+            case ArgType::INT:
+            {
+                int64_t v = 0;
+                if (!reader.Read(v))
+                {
+                    return false;
+                }
+                out += std::to_string(v);
+                return true;
+            }
+            case ArgType::UINT:
+            {
+                uint64_t v = 0;
+                if (!reader.Read(v))
+                {
+                    return false;
+                }
+                out += std::to_string(v);
+                return true;
+            }
+            case ArgType::DOUBLE:
+            {
+                double v = 0;
+                if (!reader.Read(v))
+                {
+                    return false;
+                }
+                char buf[32];
+                const auto len = std::snprintf(buf, sizeof(buf), "%g", v);
+                out.append(buf, len > 0 ? static_cast<size_t>(len) : 0);
+                return true;
+            }
+            case ArgType::BOOL:
+            {
+                uint8_t v = 0;
+                if (!reader.Read(v))
+                {
+                    return false;
+                }
+                out += v ? "true" : "false";
+                return true;
+            }
+            case ArgType::CHAR:
+            {
+                char v = 0;
+                if (!reader.Read(v))
+                {
+                    return false;
+                }
+                out += v;
+                return true;
+            }
+            case ArgType::STRING:
+            {
+                uint16_t size = 0;
+                std::string_view v;
+                if (!reader.Read(size) || !reader.Read(v, size))
+                {
+                    return false;
+                }
+                out += v;
+                return true;
+            }
+            case ArgType::TRUNCATED:
+            {
+                isTruncated = true;
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Substitutes "{}" placeholders of format with the encoded arguments in order,
+    // the message of truncated arguments ends with TruncatedMarker
+    inline std::string FormatMessage(std::string_view format, std::span<const std::byte> args)
+    {
+        std::string out;
+        out.reserve(format.size() + args.size() + TruncatedMarker.size());
+        Reader reader(args);
+        bool isTruncated = false;
+        size_t pos = 0;
+        while (true)
+        {
+            const auto placeholder = format.find("{}", pos);
+            if (placeholder == std::string_view::npos)
+            {
+                out += format.substr(pos);
+                break;
+            }
+            out += format.substr(pos, placeholder - pos);
+            if (isTruncated || !AppendArg(reader, out, isTruncated))
+            {
+                out += "{}"; // missing or cut off argument
+            }
+            pos = placeholder + 2;
+        }
+        // a string cut off for the last placeholder is followed by the tag as well
+        uint8_t type = 0;
+        if (isTruncated || (reader.Read(type) && static_cast<ArgType>(type) == ArgType::TRUNCATED))
+        {
+            out += TruncatedMarker;
+        }
+        return out;
+    }
+
+} // GameEngine::BinaryLog
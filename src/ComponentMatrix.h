@@ -2,7 +2,11 @@
 #pragma once
 
 #include "IGameObjectComponent.h"
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include <span>
 
@@ -12,8 +16,17 @@ namespace GameEngine {
     template<typename T>
     concept COMPONENT = std::is_base_of_v<IGameObjectComponent, T>;
 
+    /// Cell storage policies
+    // every cell is a separately owned std::shared_ptr<C>
+    struct SharedCellStorage {};
+    // cells are kept by value in one contiguous buffer
+    struct ValueCellStorage {};
+
+    template<COMPONENT C, typename Storage = SharedCellStorage>
+    class ComponentMatrix;
+
     template<COMPONENT C>
-    class ComponentMatrix : public IGameObjectComponent {
+    class ComponentMatrix<C, SharedCellStorage> : public IGameObjectComponent {
     private:
         struct RowIdxLen {
             size_t start = 0;
@@ -65,4 +78,254 @@ namespace GameEngine {
 
     };
 
+    template<COMPONENT C>
+    class ComponentMatrix<C, ValueCellStorage> : public IGameObjectComponent {
+    private:
+        struct RowIdxLen {
+            size_t start = 0;
+            size_t len = 0;
+        };
+        C *m_cells = nullptr;
+        size_t m_size = 0;
+        size_t m_capacity = 0;
+        std::vector<RowIdxLen> m_rowMap;
+
+        static constexpr bool IsRelocatable = std::is_move_constructible_v<C>;
+
+        void destroy_cells() noexcept {
+            std::destroy_n(m_cells, m_size);
+            std::allocator<C>().deallocate(m_cells, m_capacity);
+            m_cells = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+        }
+
+        // moves cells into a new buffer, leaving a gap of `gap` uninitialized cells at `gap_pos`
+        void relocate(size_t capacity, size_t gap_pos = 0, size_t gap = 0) requires IsRelocatable {
+            auto *cells = std::allocator<C>().allocate(capacity);
+            size_t moved = 0;
+            try {
+                for (; moved < gap_pos; ++moved) {
+                    ::new (static_cast<void *>(cells + moved)) C(std::move(m_cells[moved]));
+                }
+                for (; moved < m_size; ++moved) {
+                    ::new (static_cast<void *>(cells + moved + gap)) C(std::move(m_cells[moved]));
+                }
+            } catch (...) {
+                std::destroy_n(cells, std::min(moved, gap_pos));
+                if (moved > gap_pos) {
+                    std::destroy_n(cells + gap_pos + gap, moved - gap_pos);
+                }
+                std::allocator<C>().deallocate(cells, capacity);
+                throw;
+            }
+            const auto size = m_size;
+            destroy_cells();
+            m_cells = cells;
+            m_size = size;
+            m_capacity = capacity;
+        }
+
+        // moves `count` cells from `src` to the lower index `dst`
+        void move_cells_down(size_t src, size_t dst, size_t count) requires IsRelocatable {
+            for (size_t i = 0; i < count; ++i) {
+                ::new (static_cast<void *>(m_cells + dst + i)) C(std::move(m_cells[src + i]));
+                std::destroy_at(m_cells + src + i);
+            }
+        }
+
+        void ensure_capacity(size_t cells) {
+            if (cells <= m_capacity) {
+                return;
+            }
+            if constexpr (IsRelocatable) {
+                relocate(std::max(cells, m_capacity * 2));
+            } else {
+                if (m_size) {
+                    throw std::length_error("ComponentMatrix: Reserve() all cells of non-movable components upfront");
+                }
+                auto *new_cells = std::allocator<C>().allocate(cells);
+                std::allocator<C>().deallocate(m_cells, m_capacity);
+                m_cells = new_cells;
+                m_capacity = cells;
+            }
+        }
+
+        // make(col) returns C by value, the prvalue initializes the cell in place
+        template<typename Factory>
+        void construct_cells(C *cells, size_t from, size_t to, Factory &make) {
+            size_t col = from;
+            try {
+                for (; col < to; ++col) {
+                    ::new (static_cast<void *>(cells + col - from)) C(make(col));
+                }
+            } catch (...) {
+                std::destroy_n(cells, col - from);
+                throw;
+            }
+        }
+    protected:
+        ComponentMatrix() = default;
+        friend class GameObject;
+    public:
+        ComponentMatrix(const ComponentMatrix&) = delete;
+        ComponentMatrix &operator=(const ComponentMatrix&) = delete;
+        ComponentMatrix(ComponentMatrix&&) = delete;
+        ComponentMatrix &operator=(ComponentMatrix&&) = delete;
+        ~ComponentMatrix() {
+            destroy_cells();
+        }
+
+        // strided view over the cells of one column (rows that are too short are skipped)
+        template<bool IsConst>
+        class ColumnView {
+        private:
+            using Matrix = std::conditional_t<IsConst, const ComponentMatrix, ComponentMatrix>;
+            Matrix *m_matrix;
+            size_t m_col;
+        public:
+            class Iterator {
+            private:
+                Matrix *m_matrix;
+                size_t m_col;
+                size_t m_row;
+                void skip_short_rows() {
+                    while (m_row < m_matrix->m_rowMap.size() && m_matrix->m_rowMap[m_row].len <= m_col) {
+                        ++m_row;
+                    }
+                }
+            public:
+                using value_type = C;
+                using difference_type = std::ptrdiff_t;
+                Iterator() = default;
+                Iterator(Matrix *matrix, size_t col, size_t row)
+                    : m_matrix(matrix), m_col(col), m_row(row) {
+                    skip_short_rows();
+                }
+                auto &operator*() const {
+                    return m_matrix->m_cells[m_matrix->m_rowMap[m_row].start + m_col];
+                }
+                Iterator &operator++() {
+                    ++m_row;
+                    skip_short_rows();
+                    return *this;
+                }
+                Iterator operator++(int) {
+                    auto tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+                size_t GetRow() const {
+                    return m_row;
+                }
+                bool operator==(const Iterator &other) const {
+                    return m_row == other.m_row;
+                }
+            };
+
+            ColumnView(Matrix *matrix, size_t col)
+                : m_matrix(matrix), m_col(col) {}
+            Iterator begin() const {
+                return {m_matrix, m_col, 0};
+            }
+            Iterator end() const {
+                return {m_matrix, m_col, m_matrix->m_rowMap.size()};
+            }
+        };
+
+        // non-movable components can't be relocated: reserve all the cells before adding rows
+        void Reserve(size_t cells) {
+            ensure_capacity(cells);
+        }
+
+        // appends a row of `len` cells, make(col) returns C by value (empty rows are ignored)
+        template<typename Factory>
+        void EmplaceRow(size_t len, Factory &&make) {
+            if (!len) {
+                return;
+            }
+            ensure_capacity(m_size + len);
+            construct_cells(m_cells + m_size, 0, len, make);
+            m_rowMap.emplace_back(RowIdxLen{m_size, len});
+            m_size += len;
+        }
+
+        // shrinks or grows (with make(col) for new cells) a row, cells of the following rows are moved
+        template<typename Factory>
+        void ResizeRow(size_t row_idx, size_t len, Factory &&make) requires IsRelocatable {
+            if (!len) {
+                throw std::invalid_argument("ComponentMatrix: row can't be empty");
+            }
+            auto &row = m_rowMap.at(row_idx);
+            const auto row_end = row.start + row.len;
+            if (len < row.len) {
+                // shift the tail over the dropped cells
+                std::destroy_n(m_cells + row.start + len, row.len - len);
+                move_cells_down(row_end, row.start + len, m_size - row_end);
+            } else if (len > row.len) {
+                const auto grow = len - row.len;
+                relocate(std::max(m_size + grow, m_capacity), row_end, grow);
+                try {
+                    construct_cells(m_cells + row_end, row.len, len, make);
+                } catch (...) {
+                    // close the gap back
+                    move_cells_down(row_end + grow, row_end, m_size - row_end);
+                    throw;
+                }
+            } else {
+                return;
+            }
+            const auto diff = static_cast<std::ptrdiff_t>(len) - static_cast<std::ptrdiff_t>(row.len);
+            row.len = len;
+            m_size += diff;
+            for (auto idx = row_idx + 1; idx < m_rowMap.size(); ++idx) {
+                m_rowMap[idx].start += diff;
+            }
+        }
+
+        size_t GetRowsNum() const {
+            return m_rowMap.size();
+        }
+        std::span<const C> GetRow(size_t row_idx) const {
+            const auto &rowIdxLen = m_rowMap.at(row_idx);
+            return {m_cells + rowIdxLen.start, rowIdxLen.len};
+        }
+        std::span<C> GetRow(size_t row_idx) {
+            const auto &rowIdxLen = m_rowMap.at(row_idx);
+            return {m_cells + rowIdxLen.start, rowIdxLen.len};
+        }
+        ColumnView<true> GetColumn(size_t col_idx) const {
+            return {this, col_idx};
+        }
+        ColumnView<false> GetColumn(size_t col_idx) {
+            return {this, col_idx};
+        }
+        const C &At(size_t row_idx, size_t col_idx) const {
+            return GetRow(row_idx)[col_idx];
+        }
+        C &At(size_t row_idx, size_t col_idx) {
+            return GetRow(row_idx)[col_idx];
+        }
+        // all cells row by row
+        std::span<const C> GetSerializedMatrix() const {
+            return {m_cells, m_size};
+        }
+        std::span<C> GetSerializedMatrix() {
+            return {m_cells, m_size};
+        }
+        // fn(row, col, cell) for every cell row by row
+        template<typename Fn>
+        void ForEach(Fn &&fn) {
+            for (size_t r = 0; r < m_rowMap.size(); ++r) {
+                const auto &row = m_rowMap[r];
+                for (size_t c = 0; c < row.len; ++c) {
+                    fn(r, c, m_cells[row.start + c]);
+                }
+            }
+        }
+
+        void OnUpdate() override {};
+
+    };
+
 } // GameEngine
\ No newline at end of file
@@ -0,0 +1,133 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace GameEngine {
+
+    // Typed pool of fixed-size blocks: contiguous slabs with an intrusive free list.
+    // Freed blocks are reused, slabs of the shared Instance() are kept until the process ends
+    template<typename T>
+    class ObjectPool {
+    private:
+        union Block {
+            Block *next;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+        static constexpr size_t BlocksPerSlab = std::max<size_t>(16, 4096 / sizeof(Block));
+
+        std::mutex m_lock;
+        std::vector<std::unique_ptr<Block[]>> m_slabs;
+        Block *m_freeList = nullptr;
+        size_t m_usedBlocks = 0;
+
+        void add_slab() {
+            m_slabs.emplace_back(new Block[BlocksPerSlab]);
+            auto *slab = m_slabs.back().get();
+            // link backwards so blocks are handed out in address order
+            for (size_t i = BlocksPerSlab; i > 0; --i) {
+                slab[i - 1].next = m_freeList;
+                m_freeList = &slab[i - 1];
+            }
+        }
+    public:
+        ObjectPool() = default; // a pool of its own, its slabs are freed with it
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        static ObjectPool &Instance() {
+            // never destroyed: pooled objects may outlive static destruction
+            static auto *pool = new ObjectPool();
+            return *pool;
+        }
+
+        void *Allocate() {
+            const std::scoped_lock lock(m_lock);
+            if (!m_freeList) {
+                add_slab();
+            }
+            auto *block = m_freeList;
+            m_freeList = block->next;
+            ++m_usedBlocks;
+            return block->storage;
+        }
+
+        void Deallocate(void *ptr) noexcept {
+            if (ptr) {
+                const std::scoped_lock lock(m_lock);
+                auto *block = static_cast<Block *>(ptr);
+                block->next = m_freeList;
+                m_freeList = block;
+                --m_usedBlocks;
+            }
+        }
+
+        size_t GetUsedBlocks() {
+            const std::scoped_lock lock(m_lock);
+            return m_usedBlocks;
+        }
+
+        size_t GetCapacity() {
+            const std::scoped_lock lock(m_lock);
+            return m_slabs.size() * BlocksPerSlab;
+        }
+    };
+
+    // Wraps a callable returning the object to construct by value
+    template<typename F>
+    struct PooledFactory {
+        F make;
+    };
+
+    // Allocator serving single objects from ObjectPool (arrays fall back to the heap)
+    template<typename T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n) {
+            if (n == 1) {
+                return static_cast<T *>(ObjectPool<T>::Instance().Allocate());
+            }
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept {
+            if (n == 1) {
+                ObjectPool<T>::Instance().Deallocate(ptr);
+            } else {
+                std::allocator<T>().deallocate(ptr, n);
+            }
+        }
+
+        // the returned prvalue initializes the object in place:
+        // neither a move nor access to a non-public constructor is required here
+        template<typename U, typename F>
+        void construct(U *ptr, PooledFactory<F> &&factory) {
+            ::new (static_cast<void *>(ptr)) U(factory.make());
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U> &) const noexcept {
+            return true;
+        }
+    };
+
+    // Creates an object sharing a single pool block with its reference counter.
+    // make() returns T by value, so it may be a lambda of a friend class calling a protected constructor
+    template<typename T, typename F>
+    std::shared_ptr<T> MakePooled(F &&make) {
+        return std::allocate_shared<T>(PoolAllocator<T>(), PooledFactory<std::decay_t<F>>{std::forward<F>(make)});
+    }
+
+} // GameEngine
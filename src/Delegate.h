@@ -0,0 +1,71 @@
+#pragma once
+
+#include <utility>
+
+namespace GameEngine
+{
+    template <typename Signature>
+    class Delegate;
+
+    // Non-owning callable: an object pointer and a plain function calling the bound method.
+    // Two pointers, no allocation and no virtual call; the bound object must outlive the delegate, e.g.
+    // Delegate<void(int)>::Bind<&Player::OnDamage>(&player)
+    template <typename R, typename... Args>
+    class Delegate<R(Args...)>
+    {
+    private:
+        using Function = R (*)(void*, Args...);
+
+        void* m_object = nullptr;
+        Function m_function = nullptr;
+
+        Delegate(void* object, Function function)
+            : m_object(object)
+            , m_function(function)
+        {
+        }
+
+    public:
+        Delegate() = default;
+
+        template <auto Method, typename T>
+        static Delegate Bind(T* object)
+        {
+            return { const_cast<void*>(static_cast<const void*>(object)), [](void* o, Args... args) -> R
+            {
+                return (static_cast<T*>(o)->*Method)(std::forward<Args>(args)...);
+            } };
+        }
+
+        template <auto FreeFunction>
+        static Delegate Bind()
+        {
+            return { nullptr, [](void*, Args... args) -> R
+            {
+                return FreeFunction(std::forward<Args>(args)...);
+            } };
+        }
+
+        // binds a lambda or other functor by reference
+        template <typename F>
+        static Delegate Bind(F& functor)
+        {
+            return { const_cast<void*>(static_cast<const void*>(&functor)), [](void* o, Args... args) -> R
+            {
+                return (*static_cast<F*>(o))(std::forward<Args>(args)...);
+            } };
+        }
+
+        R operator()(Args... args) const
+        {
+            return m_function(m_object, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_function != nullptr;
+        }
+
+        bool operator==(const Delegate&) const = default;
+    };
+} // namespace GameEngine
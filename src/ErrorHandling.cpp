@@ -1,5 +1,8 @@
 #include "ErrorHandling.h"
 
+#include <chrono>
+#include <utility>
+
 namespace GameEngine
 {
     CheckFailedException::CheckFailedException(const char* file, int line, const std::string& message)
@@ -24,6 +27,8 @@ namespace GameEngine
         std::stringstream ss;
         ss << "EXPECTATION FAILED: [" << message << "] at " << file << ":" << line;
         logger.Log(LogLevel::ERROR, ss);
+        // buffered channels and the crash ring write out what has led to the failure
+        FlushLogger();
 
         throw CheckFailedException(file, line, message);
     }
@@ -51,4 +56,37 @@ namespace GameEngine
             logger.Log(LogLevel::ERROR, ss);
         }
     }
+
+    namespace
+    {
+        thread_local size_t t_frameErrors = 0;
+    }
+
+    bool FrameErrorSite::Record() noexcept
+    {
+        CountFrameError();
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto next = m_nextReportNs.load(std::memory_order_relaxed);
+        if (now >= next && m_nextReportNs.compare_exchange_strong(next, now + ReportIntervalNs, std::memory_order_relaxed))
+        {
+            return true;
+        }
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint32_t FrameErrorSite::TakeSuppressed() noexcept
+    {
+        return m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    void CountFrameError() noexcept
+    {
+        ++t_frameErrors;
+    }
+
+    size_t TakeFrameErrors() noexcept
+    {
+        return std::exchange(t_frameErrors, 0);
+    }
 } // namespace GameEngine
@@ -1,10 +1,17 @@
 #pragma once
 #include "Logger.h"
 
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <sstream>
 #include <string>
 
+// Tier of per-frame checks (see FRAME_CHECK_LEVEL in CMakeLists.txt)
+#ifndef GAME_ENGINE_FRAME_CHECK_LEVEL
+#define GAME_ENGINE_FRAME_CHECK_LEVEL 2
+#endif
+
 namespace GameEngine
 {
     class CheckFailedException : public std::runtime_error
@@ -20,6 +27,27 @@ namespace GameEngine
 
     void HandleFailedExpectation(ILogger& logger, const char* file, int line, const std::string& message);
     void HandleException(ILogger& logger, const std::string& message = {});
+
+    // Call site of EXPECT_FRAME_MSG: reports a failure at most once per interval, the rest are only counted
+    class FrameErrorSite
+    {
+    public:
+        static constexpr int64_t ReportIntervalNs = 1'000'000'000;
+
+        // counts the failure, returns true if it should be reported
+        bool Record() noexcept;
+        // failures not reported since the last report
+        uint32_t TakeSuppressed() noexcept;
+
+    private:
+        std::atomic<int64_t> m_nextReportNs = 0;
+        std::atomic<uint32_t> m_suppressed = 0;
+    };
+
+    // counts a failed per-frame check of the calling thread
+    void CountFrameError() noexcept;
+    // failed per-frame checks of the calling thread since the last call (the game loop takes them every frame)
+    size_t TakeFrameErrors() noexcept;
 } // namespace GameEngine
 
 #define HANDLE_EXCEPTION() HandleException(*GetLogger())
@@ -38,3 +66,22 @@ namespace GameEngine
 
 #define EXPECT_MSG(condition, message) \
 	do { if (!(condition)) GameEngine::HandleFailedExpectation(*GetLogger(), __FILE__, __LINE__, static_cast<std::ostringstream&&>(std::ostringstream() << message).str()); } while (false); 
+
+// Non-throwing expectation for per-frame calls: the failure is counted and the frame goes on.
+// The condition is always evaluated, the message only when the failure is reported
+#if GAME_ENGINE_FRAME_CHECK_LEVEL >= 2
+#define EXPECT_FRAME_MSG(condition, message) \
+	do { if (!(condition)) { \
+		static GameEngine::FrameErrorSite frameErrorSite; \
+		if (frameErrorSite.Record()) { \
+			LOG_ERROR("FRAME EXPECTATION FAILED: [" << message << "] at " << __FILE__ << ":" << __LINE__ \
+			          << " (" << frameErrorSite.TakeSuppressed() << " more since last report)"); \
+		} \
+	} } while (false);
+#elif GAME_ENGINE_FRAME_CHECK_LEVEL == 1
+#define EXPECT_FRAME_MSG(condition, message) \
+	do { if (!(condition)) GameEngine::CountFrameError(); } while (false);
+#else
+#define EXPECT_FRAME_MSG(condition, message) \
+	do { (void)(condition); } while (false);
+#endif
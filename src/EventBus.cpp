@@ -0,0 +1,61 @@
+#include "EventBus.h"
+
+#include <atomic>
+
+namespace GameEngine
+{
+    void EventBus::Unsubscribe(EventSubscription subscription)
+    {
+        if (subscription.id && subscription.type < m_channels.size() && m_channels[subscription.type])
+        {
+            m_channels[subscription.type]->Remove(subscription.id);
+        }
+    }
+
+    size_t EventBus::Dispatch()
+    {
+        if (m_dispatching)
+        {
+            return 0; // called by a handler
+        }
+        m_dispatching = true;
+        size_t total = 0;
+        for (size_t round = 0; round < MaxDispatchRounds; ++round)
+        {
+            size_t delivered = 0;
+            // by index: handlers may add channels
+            for (size_t i = 0; i < m_channels.size(); ++i)
+            {
+                if (m_channels[i])
+                {
+                    delivered += m_channels[i]->DeliverQueued();
+                }
+            }
+            total += delivered;
+            if (!delivered)
+            {
+                break;
+            }
+        }
+        m_dispatching = false;
+        return total;
+    }
+
+    bool EventBus::HasQueued() const
+    {
+        for (const auto& channel : m_channels)
+        {
+            if (channel && channel->HasQueued())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t EventBus::next_type_id()
+    {
+        static std::atomic<uint32_t> nextId = 0;
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+} // namespace GameEngine
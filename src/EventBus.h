@@ -0,0 +1,224 @@
+#pragma once
+
+#include "Delegate.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace GameEngine
+{
+    struct EventSubscription
+    {
+        uint32_t type = 0;
+        uint32_t id = 0; // 0 - not subscribed
+    };
+
+    // Typed event bus of the game thread, events are plain copyable structs.
+    //  Publish(): handlers are called right away.
+    //  Enqueue(): the event is appended to the contiguous queue of its type and delivered by Dispatch(),
+    //             which the game loop calls after updating the objects. Every handler gets all the queued
+    //             events of the type before the next handler does.
+    // Handlers are non-virtual delegates; they may publish, enqueue, subscribe and unsubscribe,
+    // handlers subscribed during delivery get the next events. Queues keep their capacity,
+    // so a warmed up bus doesn't allocate
+    class EventBus
+    {
+    public:
+        template <typename Event>
+        using Handler = Delegate<void(const Event&)>;
+        template <typename Event>
+        using BatchHandler = Delegate<void(std::span<const Event>)>;
+
+        // rounds of Dispatch() for the events enqueued by handlers, the rest are left for the next one
+        static constexpr size_t MaxDispatchRounds = 8;
+
+        EventBus() = default;
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        template <typename Event>
+        EventSubscription Subscribe(Handler<Event> handler)
+        {
+            return get_channel<Event>().Add(handler, {});
+        }
+
+        template <typename Event>
+        EventSubscription SubscribeBatch(BatchHandler<Event> handler)
+        {
+            return get_channel<Event>().Add({}, handler);
+        }
+
+        void Unsubscribe(EventSubscription subscription);
+
+        template <typename Event>
+        void Publish(const Event& event)
+        {
+            get_channel<Event>().Deliver({ &event, 1 });
+        }
+
+        template <typename Event>
+        void Enqueue(const Event& event)
+        {
+            get_channel<Event>().m_queue.push_back(event);
+        }
+
+        // delivers the queued events, returns number of them. Does nothing when called by a handler
+        size_t Dispatch();
+
+        // of any type
+        bool HasQueued() const;
+
+        template <typename Event>
+        size_t GetQueuedCount() const
+        {
+            const auto type = get_type_id<Event>();
+            return type < m_channels.size() && m_channels[type] ? static_cast<const Channel<Event>&>(*m_channels[type]).m_queue.size() : 0;
+        }
+
+    private:
+        struct IChannel
+        {
+            virtual ~IChannel() = default;
+            virtual void Remove(uint32_t id) = 0;
+            // returns number of delivered events
+            virtual size_t DeliverQueued() = 0;
+            virtual bool HasQueued() const = 0;
+        };
+
+        template <typename Event>
+        class Channel final : public IChannel
+        {
+        public:
+            explicit Channel(uint32_t type)
+                : m_type(type)
+            {
+            }
+
+            EventSubscription Add(Handler<Event> handler, BatchHandler<Event> batchHandler)
+            {
+                m_entries.push_back({ ++m_lastId, handler, batchHandler });
+                return { m_type, m_lastId };
+            }
+
+            void Remove(uint32_t id) override
+            {
+                for (auto& entry : m_entries)
+                {
+                    if (entry.id == id)
+                    {
+                        // erased when no delivery is running
+                        entry.id = 0;
+                        m_hasRemoved = true;
+                    }
+                }
+                compact();
+            }
+
+            void Deliver(std::span<const Event> events)
+            {
+                ++m_delivering;
+                // handlers added meanwhile wait for the next events
+                const auto count = m_entries.size();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const auto entry = m_entries[i];
+                    if (!entry.id)
+                    {
+                        continue;
+                    }
+                    if (entry.batchHandler)
+                    {
+                        entry.batchHandler(events);
+                        continue;
+                    }
+                    for (const auto& event : events)
+                    {
+                        entry.handler(event);
+                        if (!m_entries[i].id)
+                        {
+                            break; // unsubscribed by itself
+                        }
+                    }
+                }
+                --m_delivering;
+                compact();
+            }
+
+            size_t DeliverQueued() override
+            {
+                if (m_queue.empty())
+                {
+                    return 0;
+                }
+                // handlers may enqueue more events of the type meanwhile
+                m_delivered.swap(m_queue);
+                Deliver(m_delivered);
+                const auto count = m_delivered.size();
+                m_delivered.clear();
+                return count;
+            }
+
+            bool HasQueued() const override
+            {
+                return !m_queue.empty();
+            }
+
+            std::vector<Event> m_queue;
+
+        private:
+            struct Entry
+            {
+                uint32_t id;
+                Handler<Event> handler;
+                BatchHandler<Event> batchHandler;
+            };
+
+            void compact()
+            {
+                if (m_hasRemoved && !m_delivering)
+                {
+                    std::erase_if(m_entries, [](const Entry& entry) { return !entry.id; });
+                    m_hasRemoved = false;
+                }
+            }
+
+            const uint32_t m_type;
+            uint32_t m_lastId = 0;
+            std::vector<Entry> m_entries;
+            std::vector<Event> m_delivered;
+            size_t m_delivering = 0;
+            bool m_hasRemoved = false;
+        };
+
+        static uint32_t next_type_id();
+
+        template <typename Event>
+        static uint32_t get_type_id()
+        {
+            static_assert(std::is_trivially_copyable_v<Event>, "Events are expected to be plain structs");
+            static const uint32_t id = next_type_id();
+            return id;
+        }
+
+        template <typename Event>
+        Channel<Event>& get_channel()
+        {
+            const auto type = get_type_id<Event>();
+            if (type >= m_channels.size())
+            {
+                m_channels.resize(type + 1);
+            }
+            if (!m_channels[type])
+            {
+                m_channels[type] = std::make_unique<Channel<Event>>(type);
+            }
+            return static_cast<Channel<Event>&>(*m_channels[type]);
+        }
+
+        std::vector<std::unique_ptr<IChannel>> m_channels; // indexed by event type id
+        bool m_dispatching = false;
+    };
+} // namespace GameEngine
@@ -0,0 +1,288 @@
+#include "EventRouter.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace GameEngine
+{
+    namespace
+    {
+        // not used by the engine: IME composition, keymap changes.
+        // Joystick events stay enabled: SDL derives the controller events from them
+        constexpr uint32_t DefaultDisabledTypes[] = { SDL_SYSWMEVENT, SDL_TEXTEDITING, SDL_KEYMAPCHANGED };
+
+        uint64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    EventRouter::EventRouter(EventBus& bus)
+        : m_bus(bus)
+        , m_disabledTypes(std::begin(DefaultDisabledTypes), std::end(DefaultDisabledTypes))
+        , m_windowEventMask(~0u)
+    {
+    }
+
+    EventRouter::~EventRouter()
+    {
+        if (m_isInstalled)
+        {
+            SDL_SetEventFilter(nullptr, nullptr);
+        }
+        for (const auto& [id, controller] : m_controllers)
+        {
+            SDL_GameControllerClose(controller);
+        }
+    }
+
+    void EventRouter::Install()
+    {
+        for (const auto type : m_disabledTypes)
+        {
+            SDL_EventState(type, SDL_IGNORE);
+        }
+        SDL_SetEventFilter(&EventRouter::filter_event, this);
+        m_isInstalled = true;
+    }
+
+    void EventRouter::SetEventEnabled(uint32_t type, bool isEnabled)
+    {
+        const auto it = std::find(m_disabledTypes.begin(), m_disabledTypes.end(), type);
+        if (isEnabled && it != m_disabledTypes.end())
+        {
+            m_disabledTypes.erase(it);
+        }
+        else if (!isEnabled && it == m_disabledTypes.end())
+        {
+            m_disabledTypes.push_back(type);
+        }
+        if (m_isInstalled)
+        {
+            SDL_EventState(type, isEnabled ? SDL_ENABLE : SDL_IGNORE);
+        }
+    }
+
+    bool EventRouter::IsEventEnabled(uint32_t type) const
+    {
+        return std::find(m_disabledTypes.begin(), m_disabledTypes.end(), type) == m_disabledTypes.end();
+    }
+
+    void EventRouter::SetWindowEventEnabled(SDL_WindowEventID event, bool isEnabled)
+    {
+        const auto bit = 1u << event;
+        if (isEnabled)
+        {
+            m_windowEventMask.fetch_or(bit, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_windowEventMask.fetch_and(~bit, std::memory_order_relaxed);
+        }
+    }
+
+    bool EventRouter::IsWindowEventEnabled(SDL_WindowEventID event) const
+    {
+        return m_windowEventMask.load(std::memory_order_relaxed) & (1u << event);
+    }
+
+    void EventRouter::SetMouseMotionCoalescing(bool isEnabled)
+    {
+        m_isCoalescing = isEnabled;
+    }
+
+    bool EventRouter::Accept(const SDL_Event& event) const
+    {
+        if (event.type == SDL_WINDOWEVENT)
+        {
+            return IsWindowEventEnabled(static_cast<SDL_WindowEventID>(event.window.event));
+        }
+        return true;
+    }
+
+    void EventRouter::BeginFrame()
+    {
+        m_frameStats = {};
+        m_frameStart = now_ns();
+    }
+
+    std::span<const SDL_Event> EventRouter::Route(const SDL_Event& event)
+    {
+        ++m_frameStats.polled;
+        if (event.type == SDL_MOUSEMOTION && m_isCoalescing)
+        {
+            if (m_hasPendingMotion && m_pendingMotion.motion.windowID != event.motion.windowID)
+            {
+                // motions of different windows aren't merged
+                m_ready[0] = m_pendingMotion;
+                m_pendingMotion = event;
+                publish(m_ready[0]);
+                return { m_ready.data(), 1 };
+            }
+            if (m_hasPendingMotion)
+            {
+                auto& pending = m_pendingMotion.motion;
+                pending.timestamp = event.motion.timestamp;
+                pending.state = event.motion.state;
+                pending.x = event.motion.x;
+                pending.y = event.motion.y;
+                pending.xrel += event.motion.xrel;
+                pending.yrel += event.motion.yrel;
+                ++m_frameStats.coalesced;
+            }
+            else
+            {
+                m_pendingMotion = event;
+                m_hasPendingMotion = true;
+            }
+            return {};
+        }
+
+        size_t count = 0;
+        if (m_hasPendingMotion)
+        {
+            m_ready[count++] = m_pendingMotion;
+            m_hasPendingMotion = false;
+        }
+        m_ready[count++] = event;
+        for (size_t i = 0; i < count; ++i)
+        {
+            publish(m_ready[i]);
+        }
+        return { m_ready.data(), count };
+    }
+
+    std::span<const SDL_Event> EventRouter::Flush()
+    {
+        if (!m_hasPendingMotion)
+        {
+            return {};
+        }
+        m_hasPendingMotion = false;
+        m_ready[0] = m_pendingMotion;
+        publish(m_ready[0]);
+        return { m_ready.data(), 1 };
+    }
+
+    void EventRouter::EndFrame()
+    {
+        m_frameStats.timeNs = now_ns() - m_frameStart;
+        m_frameStats.filtered = m_filtered.exchange(0, std::memory_order_relaxed);
+        m_lastFrameStats = m_frameStats;
+    }
+
+    const EventPollStats& EventRouter::GetLastFrameStats() const
+    {
+        return m_lastFrameStats;
+    }
+
+    size_t EventRouter::GetControllersNum() const
+    {
+        return m_controllers.size();
+    }
+
+    int EventRouter::filter_event(void* userdata, SDL_Event* event)
+    {
+        auto* router = static_cast<EventRouter*>(userdata);
+        if (router->Accept(*event))
+        {
+            return 1;
+        }
+        router->m_filtered.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    void EventRouter::publish(const SDL_Event& event)
+    {
+        switch (event.type)
+        {
+            case SDL_WINDOWEVENT:
+            {
+                m_bus.Publish(WindowEvent{ event.window.windowID, static_cast<SDL_WindowEventID>(event.window.event),
+                                           event.window.data1, event.window.data2 });
+                break;
+            }
+            case SDL_MOUSEMOTION:
+            {
+                m_bus.Publish(MouseMotionEvent{ event.motion.windowID, { event.motion.x, event.motion.y },
+                                                { event.motion.xrel, event.motion.yrel }, event.motion.state });
+                break;
+            }
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            {
+                m_bus.Publish(MouseButtonEvent{ event.button.windowID, { event.button.x, event.button.y }, event.button.button,
+                                                event.button.clicks, event.type == SDL_MOUSEBUTTONDOWN });
+                break;
+            }
+            case SDL_MOUSEWHEEL:
+            {
+                m_bus.Publish(MouseWheelEvent{ event.wheel.windowID, { event.wheel.x, event.wheel.y } });
+                break;
+            }
+            case SDL_CONTROLLERAXISMOTION:
+            {
+                m_bus.Publish(ControllerAxisEvent{ event.caxis.which, event.caxis.axis, event.caxis.value });
+                break;
+            }
+            case SDL_CONTROLLERBUTTONDOWN:
+            case SDL_CONTROLLERBUTTONUP:
+            {
+                m_bus.Publish(ControllerButtonEvent{ event.cbutton.which, event.cbutton.button,
+                                                     event.type == SDL_CONTROLLERBUTTONDOWN });
+                break;
+            }
+            case SDL_CONTROLLERDEVICEADDED:
+            {
+                // which is the device index, the other events carry the instance id
+                const auto controller = open_controller(event.cdevice.which);
+                if (controller >= 0)
+                {
+                    m_bus.Publish(ControllerDeviceEvent{ controller, ControllerDeviceChange::ADDED });
+                }
+                break;
+            }
+            case SDL_CONTROLLERDEVICEREMOVED:
+            {
+                close_controller(event.cdevice.which);
+                m_bus.Publish(ControllerDeviceEvent{ event.cdevice.which, ControllerDeviceChange::REMOVED });
+                break;
+            }
+            case SDL_CONTROLLERDEVICEREMAPPED:
+            {
+                m_bus.Publish(ControllerDeviceEvent{ event.cdevice.which, ControllerDeviceChange::REMAPPED });
+                break;
+            }
+        }
+    }
+
+    int32_t EventRouter::open_controller(int32_t deviceIndex)
+    {
+        auto* controller = SDL_GameControllerOpen(deviceIndex);
+        if (!controller)
+        {
+            return -1;
+        }
+        const auto id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller));
+        const auto it = std::find_if(m_controllers.begin(), m_controllers.end(), [id](const auto& c) { return c.first == id; });
+        if (it != m_controllers.end())
+        {
+            // reported again, e.g. connected before SDL was initialized: SDL counts the opens
+            SDL_GameControllerClose(controller);
+            return id;
+        }
+        m_controllers.emplace_back(id, controller);
+        return id;
+    }
+
+    void EventRouter::close_controller(int32_t id)
+    {
+        const auto it = std::find_if(m_controllers.begin(), m_controllers.end(), [id](const auto& c) { return c.first == id; });
+        if (it != m_controllers.end())
+        {
+            SDL_GameControllerClose(it->second);
+            m_controllers.erase(it);
+        }
+    }
+} // namespace GameEngine
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "EventBus.h"
+#include "Types.h"
+
+#include "sdl.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace GameEngine
+{
+    // Typed events published on the EventBus by EventRouter while the SDL events are polled
+    struct WindowEvent
+    {
+        uint32_t windowId = 0;
+        SDL_WindowEventID event = SDL_WINDOWEVENT_NONE;
+        int32_t data1 = 0; // e.g. the new size or position
+        int32_t data2 = 0;
+    };
+
+    struct MouseMotionEvent
+    {
+        uint32_t windowId = 0; // with the mouse focus
+        Pos2D position;
+        Pos2D delta; // sum of the coalesced motions
+        uint32_t buttons = 0; // SDL_BUTTON_*MASK
+    };
+
+    struct MouseButtonEvent
+    {
+        uint32_t windowId = 0;
+        Pos2D position;
+        uint8_t button = 0;
+        uint8_t clicks = 0;
+        bool isDown = false;
+    };
+
+    struct MouseWheelEvent
+    {
+        uint32_t windowId = 0;
+        Pos2D delta;
+    };
+
+    struct ControllerAxisEvent
+    {
+        int32_t controller = 0;
+        uint8_t axis = 0;
+        int16_t value = 0;
+    };
+
+    struct ControllerButtonEvent
+    {
+        int32_t controller = 0;
+        uint8_t button = 0;
+        bool isDown = false;
+    };
+
+    enum class ControllerDeviceChange : uint8_t
+    {
+        ADDED,
+        REMOVED,
+        REMAPPED,
+    };
+
+    struct ControllerDeviceEvent
+    {
+        int32_t controller = 0;
+        ControllerDeviceChange change = ControllerDeviceChange::ADDED;
+    };
+
+    // SDL event polling cost of a frame
+    struct EventPollStats
+    {
+        size_t polled = 0;    // events taken from the SDL queue
+        size_t coalesced = 0; // mouse motions merged into the previous one
+        size_t filtered = 0;  // dropped by the event filter before reaching the queue
+        uint64_t timeNs = 0;
+    };
+
+    // Routes the SDL events polled by the game loop.
+    //  - Unwanted event types are disabled with SDL_EventState(), so SDL doesn't queue them at all;
+    //    window events are filtered by kind in the SDL event filter.
+    //  - Consecutive mouse motions are merged into one with the summed delta. A pending motion is
+    //    handed out before any other event, so clicks keep their position.
+    //  - Window, mouse and controller events are published on the EventBus as typed events.
+    //    Added game controllers are opened, so SDL reports their input, and closed once removed;
+    //    the controller of the events is the joystick instance id.
+    class EventRouter
+    {
+    public:
+        explicit EventRouter(EventBus& bus);
+        ~EventRouter();
+
+        EventRouter(const EventRouter&) = delete;
+        EventRouter& operator=(const EventRouter&) = delete;
+
+        // applies the event states and sets the SDL event filter, SDL has to be initialized
+        void Install();
+
+        void SetEventEnabled(uint32_t type, bool isEnabled);
+        bool IsEventEnabled(uint32_t type) const;
+        void SetWindowEventEnabled(SDL_WindowEventID event, bool isEnabled);
+        bool IsWindowEventEnabled(SDL_WindowEventID event) const;
+        void SetMouseMotionCoalescing(bool isEnabled);
+
+        // decision of the SDL event filter, may be called by any thread
+        bool Accept(const SDL_Event& event) const;
+
+        void BeginFrame();
+        // returns the events to handle now: none if the event is merged into the pending mouse motion,
+        // otherwise the pending motion, if any, followed by the event
+        std::span<const SDL_Event> Route(const SDL_Event& event);
+        // returns the pending mouse motion, if any
+        std::span<const SDL_Event> Flush();
+        void EndFrame();
+
+        const EventPollStats& GetLastFrameStats() const;
+        // game controllers open
+        size_t GetControllersNum() const;
+
+    private:
+        static int filter_event(void* userdata, SDL_Event* event);
+        void publish(const SDL_Event& event);
+        // returns the instance id, -1 if the controller can't be opened
+        int32_t open_controller(int32_t deviceIndex);
+        void close_controller(int32_t id);
+
+        EventBus& m_bus;
+        std::vector<uint32_t> m_disabledTypes;
+        std::atomic<uint32_t> m_windowEventMask;
+        std::atomic<size_t> m_filtered = 0;
+        bool m_isInstalled = false;
+        bool m_isCoalescing = true;
+
+        bool m_hasPendingMotion = false;
+        SDL_Event m_pendingMotion{};
+        std::array<SDL_Event, 2> m_ready{};
+
+        EventPollStats m_frameStats;
+        EventPollStats m_lastFrameStats;
+        uint64_t m_frameStart = 0;
+
+        std::vector<std::pair<int32_t, SDL_GameController*>> m_controllers; // by instance id
+    };
+} // namespace GameEngine
@@ -2,106 +2,629 @@
 #include "ErrorHandling.h"
 
 #include "IInputEvent.h"    // KeyCodes
+#include "InputState.h"
+#include "TransformComponent.h"
 
 #include "sdl.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
 namespace GameEngine
 {
-    constexpr KeyCodes SdlScancodeToKeyCodes(SDL_Scancode scancode)
+    GameLoop::GameLoop(GameLoopMode mode)
+        : Logable("GameLoop")
+        , InputEventPublisher()
+        , m_mode(mode)
+        , m_frameRate(mode == GameLoopMode::HEADLESS ? 0 : 60)
+        , m_eventRouter(m_eventBus)
+        , m_behaviors(m_eventBus)
+    {
+        if (!IsHeadless())
+        {
+            EXPECT_MSG(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) == 0, "SDL_Init failed: " << SDL_GetError());
+            m_eventRouter.Install();
+            m_eventBus.Subscribe<WindowEvent>(EventBus::Handler<WindowEvent>::Bind<&GameLoop::on_window_event>(this));
+        }
+    }
+
+    GameLoop::~GameLoop()
     {
-        switch (scancode)
+        if (m_inputRecorder)
+        {
+            m_inputRecorder->Finish(m_framesNum);
+        }
+        if (!IsHeadless())
         {
-            case SDL_SCANCODE_UP: return KeyCodes::ARROW_UP;
-            case SDL_SCANCODE_LEFT: return KeyCodes::ARROW_LEFT;
-            case SDL_SCANCODE_DOWN: return KeyCodes::ARROW_DOWN;
-            case SDL_SCANCODE_RIGHT: return KeyCodes::ARROW_RIGHT;
+            SDL_Quit();
+        }
+    }
 
-            case SDL_SCANCODE_W: return KeyCodes::W;
-            case SDL_SCANCODE_A: return KeyCodes::A;
-            case SDL_SCANCODE_S: return KeyCodes::S;
-            case SDL_SCANCODE_D: return KeyCodes::D;
+    void GameLoop::SetWindow(const std::shared_ptr<IWindow>& window)
+    {
+        m_windows.clear();
+        AddWindow(window);
+    }
 
-            default: return KeyCodes::UNSUPPORTED;
+    void GameLoop::AddWindow(const std::shared_ptr<IWindow>& window)
+    {
+        EXPECT(window);
+        if (!find_window(*window))
+        {
+            m_windows.push_back({ window });
         }
     }
 
-    GameLoop::GameLoop()
-        : Logable("GameLoop")
-        , InputEventPublisher()
+    void GameLoop::RemoveWindow(const IWindow& window)
     {
-        EXPECT_MSG(SDL_Init(SDL_INIT_VIDEO) == 0, "SDL_Init failed: " << SDL_GetError());
+        std::erase_if(m_windows, [&window](const WindowSlot &slot) { return slot.window.get() == &window; });
     }
 
-    GameLoop::~GameLoop()
+    void GameLoop::SetWindowRefreshRate(const IWindow &window, unsigned int refreshRate)
     {
-        SDL_Quit();
+        auto *slot = find_window(window);
+        EXPECT_MSG(slot, "Window isn't added to the loop");
+        slot->interval = refreshRate ? 1.0f / static_cast<float>(refreshRate) : 0;
     }
 
-    void GameLoop::SetWindow(const std::shared_ptr<IWindow>& window)
+    void GameLoop::SetWindowUpdateThreads(size_t threadsNum)
     {
-        // TODO: collection of windows?
-        m_window = window;
+        m_updateWorkers = threadsNum ? std::make_unique<WorkerPool>(threadsNum) : nullptr;
     }
 
-    void GameLoop::Run()
+    IWindow *GameLoop::FindWindow(uint32_t windowId)
+    {
+        auto *slot = find_window(windowId);
+        return slot ? slot->window.get() : nullptr;
+    }
+
+    IWindow *GameLoop::GetFocusedWindow()
     {
-        EXPECT(m_window);
+        return m_focusedWindowId ? FindWindow(m_focusedWindowId) : nullptr;
+    }
 
+    void GameLoop::Run()
+    {
         LOG_INFO("Starting");
+        RunFrames(std::numeric_limits<size_t>::max());
+        if (m_inputRecorder)
+        {
+            m_inputRecorder->Finish(m_framesNum);
+        }
+        log_stats();
+        LOG_INFO("Stopped");
+    }
+
+    void GameLoop::RunFrames(size_t framesNum)
+    {
+        EXPECT(!m_windows.empty());
+
+        m_mainThread = std::this_thread::get_id();
+        auto nextFrame = std::chrono::steady_clock::now();
+        m_lastFrameStart = nextFrame;
+        size_t frame = 0;
+        while (frame < framesNum && !m_isStopRequested.load(std::memory_order_relaxed))
+        {
+            PollLogger();
+            if (is_idle())
+            {
+                // nothing to clear, update nor present until something happens
+                const bool hasEvent = wait_events();
+                nextFrame = std::chrono::steady_clock::now();
+                if (!hasEvent)
+                {
+                    continue;
+                }
+            }
+            ++frame;
+            if (run_frame())
+            {
+                break;
+            }
+            wait_next_frame(nextFrame);
+        }
+        m_isStopRequested.store(false, std::memory_order_relaxed);
+    }
+
+    void GameLoop::Stop()
+    {
+        m_isStopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    void GameLoop::SetFrameRate(unsigned int frameRate)
+    {
+        m_frameRate = frameRate;
+    }
+
+    void GameLoop::SetFixedTimeStep(float seconds)
+    {
+        m_fixedTimeStep = seconds;
+    }
+
+    bool GameLoop::IsHeadless() const
+    {
+        return m_mode == GameLoopMode::HEADLESS;
+    }
+
+    void GameLoop::SetIdleMode(bool isEnabled)
+    {
+        m_isIdleMode = isEnabled;
+    }
+
+    void GameLoop::RequestRedraw()
+    {
+        if (!m_isRedrawRequested.exchange(true) && m_isIdleMode && !IsHeadless())
+        {
+            // wakes the idle wait
+            SDL_Event event{};
+            event.type = SDL_USEREVENT;
+            SDL_PushEvent(&event);
+        }
+    }
+
+    size_t GameLoop::GetFramesNum() const
+    {
+        return m_framesNum;
+    }
 
+    bool GameLoop::run_frame()
+    {
         bool isStopped = false;
-        while (!isStopped)
+        m_frameAllocations.Restart();
         {
+            const AllocationTagScope tag(AllocationTag::INPUT);
             isStopped = poll_events();
+            CompactSubscribers();
+        }
+        if (is_idle())
+        {
+            // the events changed nothing: the presented frame stays
+            finish_frame_stats();
+            return isStopped;
+        }
+        // measured since the previous full frame
+        const auto frameTime = get_frame_time();
+        m_isRedrawRequested.store(false);
+        schedule_windows(frameTime);
+        {
+            const AllocationTagScope tag(AllocationTag::RENDER);
+            for (const auto &slot : m_windows)
+            {
+                if (is_rendered(slot))
+                {
+                    slot.window->Clear();
+                }
+            }
+        }
+        {
+            const AllocationTagScope tag(AllocationTag::GAME_LOGIC);
+            update_windows();
+            m_behaviors.Resume(frameTime);
+            m_eventBus.Dispatch();
+        }
+        {
+            const AllocationTagScope tag(AllocationTag::RENDER);
+            for (const auto &slot : m_windows)
+            {
+                if (is_rendered(slot))
+                {
+                    slot.window->Present();
+                }
+            }
+        }
+        // changes are consumed by this frame's systems
+        TransformComponent::ClearChanged();
+        finish_frame_stats();
+        return isStopped;
+    }
 
-            m_window->Clear();
-            m_window->Update();
-            m_window->Present();
-            // calculates to 60 fps
-            SDL_Delay(1000 / 60);
+    bool GameLoop::is_idle() const
+    {
+        if (!m_isIdleMode || IsHeadless() || m_inputReplayer)
+        {
+            return false;
+        }
+        const auto isWindowBusy = std::any_of(m_windows.begin(), m_windows.end(), [](const WindowSlot &slot) { return !slot.window->IsIdle(); });
+        if (m_isRedrawRequested.load() || isWindowBusy || m_behaviors.HasReady() || m_tasks.GetCount()
+            || m_eventBus.HasQueued() || !TransformComponent::GetChanged().empty())
+        {
+            return false;
         }
+        const auto nextTimer = m_behaviors.GetNextTimerTime();
+        if (nextTimer == std::numeric_limits<double>::infinity())
+        {
+            return true;
+        }
+        // a fixed time step doesn't advance while waiting
+        const auto sinceLastFrame = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_lastFrameStart).count();
+        return m_fixedTimeStep <= 0 && m_behaviors.GetTime() + sinceLastFrame < nextTimer;
+    }
 
-        LOG_INFO("Stopped");
+    bool GameLoop::wait_events()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto timeoutMs = IdleWaitMs;
+        const auto nextTimer = m_behaviors.GetNextTimerTime();
+        if (nextTimer != std::numeric_limits<double>::infinity())
+        {
+            const auto sinceLastFrame = std::chrono::duration<double>(start - m_lastFrameStart).count();
+            const auto untilTimer = (nextTimer - m_behaviors.GetTime() - sinceLastFrame) * 1000;
+            timeoutMs = std::clamp(static_cast<int>(std::ceil(untilTimer)), 0, IdleWaitMs);
+        }
+        // the event is left in the queue for the frame to poll
+        const bool hasEvent = SDL_WaitEventTimeout(nullptr, timeoutMs) != 0;
+        ++m_idleWaitsNum;
+        m_idleTimeNs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        return hasEvent;
+    }
+
+    void GameLoop::on_window_event(const WindowEvent &event)
+    {
+        if (event.event == SDL_WINDOWEVENT_FOCUS_GAINED)
+        {
+            m_focusedWindowId = event.windowId;
+        }
+        else if (event.event == SDL_WINDOWEVENT_FOCUS_LOST && m_focusedWindowId == event.windowId)
+        {
+            m_focusedWindowId = 0;
+        }
+        auto *slot = find_window(event.windowId);
+        if (!slot)
+        {
+            return;
+        }
+        switch (event.event)
+        {
+            case SDL_WINDOWEVENT_MINIMIZED:
+            case SDL_WINDOWEVENT_HIDDEN:
+                slot->isHidden = true;
+                break;
+            case SDL_WINDOWEVENT_SHOWN:
+            case SDL_WINDOWEVENT_RESTORED:
+            case SDL_WINDOWEVENT_MAXIMIZED:
+                slot->isHidden = false;
+                slot->isRedrawRequested = true;
+                m_isRedrawRequested.store(true);
+                break;
+            case SDL_WINDOWEVENT_EXPOSED:
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+                // the content has to be drawn again
+                slot->isRedrawRequested = true;
+                m_isRedrawRequested.store(true);
+                break;
+            default:
+                break;
+        }
+    }
+
+    GameLoop::WindowSlot *GameLoop::find_window(uint32_t windowId)
+    {
+        if (!windowId)
+        {
+            return nullptr;
+        }
+        const auto it = std::find_if(m_windows.begin(), m_windows.end(), [windowId](const WindowSlot &slot) { return slot.window->GetId() == windowId; });
+        return it == m_windows.end() ? nullptr : &*it;
+    }
+
+    GameLoop::WindowSlot *GameLoop::find_window(const IWindow &window)
+    {
+        const auto it = std::find_if(m_windows.begin(), m_windows.end(), [&window](const WindowSlot &slot) { return slot.window.get() == &window; });
+        return it == m_windows.end() ? nullptr : &*it;
+    }
+
+    void GameLoop::schedule_windows(float frameTime)
+    {
+        constexpr auto hiddenInterval = 1.0f / HiddenFrameRate;
+        for (auto &slot : m_windows)
+        {
+            slot.pendingTime += frameTime;
+            const auto interval = slot.isHidden ? std::max(slot.interval, hiddenInterval) : slot.interval;
+            // slack for the rounding of the summed frame times
+            slot.isDue = slot.isRedrawRequested || slot.pendingTime >= interval * 0.999f;
+            slot.isRedrawRequested = false;
+        }
+    }
+
+    void GameLoop::update_windows()
+    {
+        m_parallelWindows.clear();
+        for (size_t i = 0; i < m_windows.size(); ++i)
+        {
+            auto &slot = m_windows[i];
+            if (!slot.isDue)
+            {
+                continue;
+            }
+            // objects drawing with SDL stay on this thread
+            if (m_updateWorkers && !slot.window->HasRenderer())
+            {
+                m_parallelWindows.push_back(i);
+                continue;
+            }
+            update_window(slot);
+        }
+        if (!m_parallelWindows.empty())
+        {
+            m_frameChanged = &TransformComponent::GetChangedList();
+            m_updateWorkers->Run(m_parallelWindows.size(), WorkerPool::Job::Bind<&GameLoop::update_parallel_window>(this));
+        }
+    }
+
+    void GameLoop::update_window(WindowSlot &slot)
+    {
+        slot.window->Update(slot.pendingTime);
+        slot.pendingTime = 0;
+    }
+
+    void GameLoop::update_parallel_window(size_t index)
+    {
+        update_window(m_windows[m_parallelWindows[index]]);
+        if (std::this_thread::get_id() != m_mainThread)
+        {
+            // per-thread state of the worker is handed to the loop thread: the frame's systems and the idle check see the changes
+            TransformComponent::GetChangedList().MoveTo(*m_frameChanged);
+            m_workerFrameErrors.fetch_add(TakeFrameErrors(), std::memory_order_relaxed);
+        }
+    }
+
+    bool GameLoop::is_rendered(const WindowSlot &slot) const
+    {
+        return !IsHeadless() && slot.isDue && !slot.isHidden;
+    }
+
+    bool GameLoop::are_windows_hidden() const
+    {
+        return !m_windows.empty() && std::all_of(m_windows.begin(), m_windows.end(), [](const WindowSlot &slot) { return slot.isHidden; });
+    }
+
+    unsigned int GameLoop::get_frame_rate() const
+    {
+        if (m_isIdleMode && are_windows_hidden())
+        {
+            return m_frameRate ? std::min(m_frameRate, HiddenFrameRate) : HiddenFrameRate;
+        }
+        return m_frameRate;
+    }
+
+    float GameLoop::get_frame_time()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto measured = std::chrono::duration<float>(now - m_lastFrameStart).count();
+        m_lastFrameStart = now;
+        return m_fixedTimeStep > 0 ? m_fixedTimeStep : measured;
+    }
+
+    void GameLoop::wait_next_frame(std::chrono::steady_clock::time_point &nextFrame)
+    {
+        const auto frameRate = get_frame_rate();
+        if (!frameRate || (m_inputReplayer && m_isReplayMaxSpeed))
+        {
+            run_tasks(m_taskBudget);
+            return;
+        }
+        // fixed rate: the time spent on the frame is included
+        nextFrame += std::chrono::nanoseconds(1'000'000'000 / frameRate);
+        const auto now = std::chrono::steady_clock::now();
+        if (nextFrame < now)
+        {
+            // late frame: the next ones aren't rushed to catch up, only starving tasks are run
+            nextFrame = now;
+            run_tasks(std::chrono::nanoseconds::zero());
+            return;
+        }
+        // stops short of the deadline: the last step may overrun the budget
+        constexpr auto margin = std::chrono::microseconds(500);
+        run_tasks(std::min<std::chrono::nanoseconds>(m_taskBudget, nextFrame - now - margin));
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    void GameLoop::run_tasks(std::chrono::nanoseconds budget)
+    {
+        m_tasks.Run(budget);
+        const auto &stats = m_tasks.GetLastStats();
+        m_totalTaskStats.budgetNs += stats.budgetNs;
+        m_totalTaskStats.usedNs += stats.usedNs;
+        m_totalTaskStats.steps += stats.steps;
+        m_totalTaskStats.completed += stats.completed;
+    }
+
+    void GameLoop::log_stats()
+    {
+        if (IsAllocationTrackingEnabled())
+        {
+            LOG_INFO("Frames: " << m_framesNum << ", peak allocations per frame: " << m_peakFrameAllocations.allocations
+                     << " (" << m_peakFrameAllocations.bytes << " bytes)");
+        }
+        if (m_totalFrameErrors)
+        {
+            LOG_WARNING("Failed per-frame checks: " << m_totalFrameErrors);
+        }
+        if (m_totalTaskStats.steps)
+        {
+            LOG_INFO("Task steps: " << m_totalTaskStats.steps << ", completed tasks: " << m_totalTaskStats.completed
+                     << ", used " << m_totalTaskStats.usedNs / 1000 << " of " << m_totalTaskStats.budgetNs / 1000 << " us of budget");
+        }
+        if (m_idleWaitsNum)
+        {
+            LOG_INFO("Idle waits: " << m_idleWaitsNum << ", idle for " << m_idleTimeNs / 1'000'000 << " ms");
+        }
+        if (m_framesNum && !IsHeadless())
+        {
+            LOG_INFO("Polled events: " << m_totalPollStats.polled << " (coalesced " << m_totalPollStats.coalesced
+                     << ", filtered " << m_totalPollStats.filtered << "), polling per frame: average "
+                     << m_totalPollStats.timeNs / m_framesNum / 1000 << " us, peak " << m_peakPollTimeNs / 1000 << " us");
+        }
+    }
+
+    const AllocationStats &GameLoop::GetLastFrameAllocations() const
+    {
+        return m_lastFrameAllocations;
+    }
+
+    size_t GameLoop::GetLastFrameErrors() const
+    {
+        return m_lastFrameErrors;
+    }
+
+    const InputState &GameLoop::GetInputState() const
+    {
+        return m_input;
     }
 
-    void GameLoop::handle_key_events(const SDL_Event &event) {
+    EventBus &GameLoop::GetEventBus()
+    {
+        return m_eventBus;
+    }
+
+    EventRouter &GameLoop::GetEventRouter()
+    {
+        return m_eventRouter;
+    }
+
+    const EventPollStats &GameLoop::GetLastPollStats() const
+    {
+        return m_eventRouter.GetLastFrameStats();
+    }
+
+    BehaviorScheduler &GameLoop::GetBehaviors()
+    {
+        return m_behaviors;
+    }
+
+    TaskScheduler &GameLoop::GetTasks()
+    {
+        return m_tasks;
+    }
+
+    void GameLoop::SetTaskBudget(std::chrono::nanoseconds budget)
+    {
+        m_taskBudget = budget;
+    }
+
+    const TaskStats &GameLoop::GetLastTaskStats() const
+    {
+        return m_tasks.GetLastStats();
+    }
+
+    void GameLoop::RecordInput(std::unique_ptr<InputRecorder> recorder)
+    {
+        m_inputRecorder = std::move(recorder);
+    }
+
+    void GameLoop::ReplayInput(std::unique_ptr<InputReplayer> replayer, bool isMaxSpeed)
+    {
+        m_inputReplayer = std::move(replayer);
+        m_isReplayMaxSpeed = isMaxSpeed;
+    }
+
+    void GameLoop::finish_frame_stats()
+    {
+        ++m_framesNum;
+        m_lastFrameAllocations = m_frameAllocations.GetStats();
+        if (m_lastFrameAllocations.allocations > m_peakFrameAllocations.allocations)
+        {
+            m_peakFrameAllocations = m_lastFrameAllocations;
+        }
+        m_lastFrameErrors = TakeFrameErrors() + m_workerFrameErrors.exchange(0, std::memory_order_relaxed);
+        m_totalFrameErrors += m_lastFrameErrors;
+        const auto &poll = m_eventRouter.GetLastFrameStats();
+        m_totalPollStats.polled += poll.polled;
+        m_totalPollStats.coalesced += poll.coalesced;
+        m_totalPollStats.filtered += poll.filtered;
+        m_totalPollStats.timeNs += poll.timeNs;
+        m_peakPollTimeNs = std::max(m_peakPollTimeNs, poll.timeNs);
+    }
+
+    void GameLoop::handle_key_event(const InputEvent &event) {
         // don't handle repeated events (pressed-and-held keys)
-        if (event.key.repeat) return;
-        const auto keyCode = SdlScancodeToKeyCodes(event.key.keysym.scancode);
+        if (event.repeat) return;
         switch (event.type) {
-            case SDL_KEYDOWN:
+            case InputEventType::KEY_DOWN:
                 // handle keydown
-                OnKeyDown(keyCode);
+                OnKeyDown(event.keyCode);
                 break;
-            case SDL_KEYUP:
+            case InputEventType::KEY_UP:
                 // handle keyup
-                OnKeyUp(keyCode);
+                OnKeyUp(event.keyCode);
                 break;
+            default:
+                break;
+        }
+    }
+
+    bool GameLoop::handle_event(const SDL_Event &event)
+    {
+        if (event.type == SDL_QUIT)
+        {
+            return true;
+        }
+        if (m_input.HandleEvent(event))
+        {
+            // per-event delivery to IInputEventSubscriber
+            handle_key_event(m_input.GetEvents().back());
         }
+        return false;
     }
 
     bool GameLoop::poll_events()
     {
         SDL_Event event;
+        bool isQuit = false;
+        m_input.BeginFrame();
+        m_eventRouter.BeginFrame();
 
-        while (SDL_PollEvent(&event))
+        // no video, no events: only the replayed input, if any
+        while (!IsHeadless() && !isQuit && SDL_PollEvent(&event))
         {
-            switch (event.type)
+            if (m_inputReplayer && InputState::IsInputEvent(event))
             {
-                case SDL_QUIT:
-                {
-                    return true;
-                }
-                // filter keyboard keys events
-                case SDL_KEYDOWN:
-                case SDL_KEYUP:
-                {
-                    handle_key_events(event);
-                }
+                // the recorded input replaces the user's one, window events are still handled
+                continue;
+            }
+            for (const auto &routed : m_eventRouter.Route(event))
+            {
+                isQuit |= handle_event(routed);
             }
         }
+        for (const auto &routed : m_eventRouter.Flush())
+        {
+            handle_event(routed);
+        }
+        m_eventRouter.EndFrame();
+        if (isQuit || (m_inputReplayer && replay_events()))
+        {
+            return true;
+        }
+        if (m_inputRecorder)
+        {
+            m_inputRecorder->RecordFrame(m_framesNum, SDL_GetTicks(), m_input.GetEvents());
+        }
+
+        // batch subscribers get the whole frame at once
+        if (!m_input.GetEvents().empty())
+        {
+            PublishInputEvents(m_input.GetEvents(), m_input);
+        }
 
         return false;
     }
 
+    bool GameLoop::replay_events()
+    {
+        if (m_inputReplayer->IsFinished(m_framesNum))
+        {
+            LOG_INFO("Input replay finished");
+            return true;
+        }
+        for (const auto &event : m_inputReplayer->GetFrameEvents(m_framesNum))
+        {
+            m_input.Apply(event);
+            handle_key_event(event);
+        }
+        return false;
+    }
+
 } //namespace GameEngine
\ No newline at end of file
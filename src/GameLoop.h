@@ -4,29 +4,185 @@
 
 #include "Logger.h"
 #include "InputEventPublisher.h"
+#include "InputState.h"
+#include "InputRecording.h"
+#include "EventBus.h"
+#include "EventRouter.h"
+#include "Behavior.h"
+#include "TaskScheduler.h"
+#include "WorkerPool.h"
+#include "AllocationTracker.h"
 
 #include "sdl.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace GameEngine
 {
+    enum class GameLoopMode
+    {
+        WINDOWED,
+        // no video: SDL isn't initialized, nothing is polled nor rendered, objects are only updated.
+        // Independent headless loops may run in parallel, one per thread
+        HEADLESS,
+    };
+
     class GameLoop : private Logable,
                      public InputEventPublisher,
                      public IGameLoop
     {
     private:
-        std::shared_ptr<IWindow> m_window;
+        struct WindowSlot
+        {
+            std::shared_ptr<IWindow> window;
+            float interval = 0; // seconds between updates, 0 - every frame
+            float pendingTime = 0; // since the last update
+            bool isHidden = false; // minimized or hidden
+            bool isRedrawRequested = false;
+            bool isDue = false; // updated in this frame
+        };
+
+        const GameLoopMode m_mode;
+        std::vector<WindowSlot> m_windows;
+        std::vector<size_t> m_parallelWindows; // due windows without a renderer, updated by the workers
+        std::unique_ptr<WorkerPool> m_updateWorkers;
+        std::thread::id m_mainThread;
+        std::atomic<size_t> m_workerFrameErrors = 0;
+        ChangedTransforms *m_frameChanged = nullptr; // changed list of the loop thread, takes the workers' changes
+        uint32_t m_focusedWindowId = 0;
+        unsigned int m_frameRate;
+        float m_fixedTimeStep = 0;
+        std::chrono::steady_clock::time_point m_lastFrameStart;
+        std::atomic<bool> m_isStopRequested = false;
+        // idle mode
+        bool m_isIdleMode = false;
+        std::atomic<bool> m_isRedrawRequested = false;
+        size_t m_idleWaitsNum = 0;
+        uint64_t m_idleTimeNs = 0;
+        InputState m_input;
+        EventBus m_eventBus;
+        EventRouter m_eventRouter;
+        BehaviorScheduler m_behaviors;
+        TaskScheduler m_tasks;
+        std::chrono::nanoseconds m_taskBudget = std::chrono::milliseconds(4);
+        TaskStats m_totalTaskStats;
+        std::unique_ptr<InputRecorder> m_inputRecorder;
+        std::unique_ptr<InputReplayer> m_inputReplayer;
+        bool m_isReplayMaxSpeed = false;
+        // per-frame allocations (zero unless built with ENABLE_ALLOC_TRACKING)
+        AllocationCounter m_frameAllocations;
+        AllocationStats m_lastFrameAllocations;
+        AllocationStats m_peakFrameAllocations;
+        size_t m_framesNum = 0;
+        // failed per-frame checks (see EXPECT_FRAME_MSG)
+        size_t m_lastFrameErrors = 0;
+        size_t m_totalFrameErrors = 0;
+        // SDL event polling
+        EventPollStats m_totalPollStats;
+        uint64_t m_peakPollTimeNs = 0;
 
     private:
+        // returns true when the loop has to stop after the frame
+        bool run_frame();
+        // idle mode: nothing would change if a frame was run
+        bool is_idle() const;
+        // blocks until an SDL event, a behavior's time or IdleWaitMs, returns true when an event is waiting
+        bool wait_events();
+        void on_window_event(const WindowEvent &event);
+        WindowSlot *find_window(uint32_t windowId);
+        WindowSlot *find_window(const IWindow &window);
+        // marks the windows due in this frame
+        void schedule_windows(float frameTime);
+        void update_windows();
+        void update_window(WindowSlot &slot);
+        void update_parallel_window(size_t index);
+        bool is_rendered(const WindowSlot &slot) const;
+        bool are_windows_hidden() const;
+        unsigned int get_frame_rate() const;
+        // seconds since the previous frame, or the fixed time step
+        float get_frame_time();
+        // runs the tasks in the time left over by the frame, then sleeps until the next one
+        void wait_next_frame(std::chrono::steady_clock::time_point &nextFrame);
+        void run_tasks(std::chrono::nanoseconds budget);
+        void log_stats();
         bool poll_events();
-        void handle_key_events(const SDL_Event &event);
+        // replaces the input by the recorded one, returns true when the recording is over
+        bool replay_events();
+        // returns true on SDL_QUIT
+        bool handle_event(const SDL_Event &event);
+        void handle_key_event(const InputEvent &event);
+        void finish_frame_stats();
     public:
-        GameLoop();
+        // idle waits are bounded, e.g. for Stop() or completions from other threads
+        static constexpr int IdleWaitMs = 100;
+        // of minimized and hidden windows, and of the whole loop in idle mode when all of them are
+        static constexpr unsigned int HiddenFrameRate = 10;
+
+        explicit GameLoop(GameLoopMode mode = GameLoopMode::WINDOWED);
         ~GameLoop();
 
         // IGameLoop
         void SetWindow(const std::shared_ptr<IWindow>& window) override;
+        // windows are updated and presented one after another, minimized and hidden ones aren't rendered
+        // and are updated at HiddenFrameRate. Not to be called by objects during the update
+        void AddWindow(const std::shared_ptr<IWindow>& window) override;
+        void RemoveWindow(const IWindow& window) override;
+        // runs until quit or Stop()
         void Run() override;
+
+        // updates per second of the window, e.g. 10 for a stats window, 0 - every frame (default).
+        // Objects get the time since the window's previous update
+        void SetWindowRefreshRate(const IWindow &window, unsigned int refreshRate);
+        // windows without a renderer are updated by the given number of threads along with the calling one.
+        // Their objects have to be independent: no shared objects, bus, behaviors nor tasks. 0 - no threads (default)
+        void SetWindowUpdateThreads(size_t threadsNum);
+        // by SDL window ID, nullptr if none
+        IWindow *FindWindow(uint32_t windowId);
+        // with the keyboard focus, which keyboard input goes to. nullptr if none
+        IWindow *GetFocusedWindow();
+
+        // runs the given number of frames unless stopped earlier, e.g. server ticks
+        void RunFrames(size_t framesNum);
+        // the loop stops after the current frame, may be called from any thread
+        void Stop();
+        // frames per second, 0 - as fast as possible. Defaults to 60 when windowed, 0 when headless
+        void SetFrameRate(unsigned int frameRate);
+        // objects get this time per frame instead of the measured one, e.g. for reproducible replays. 0 - measured
+        void SetFixedTimeStep(float seconds);
+        bool IsHeadless() const;
+        // windowed loops only: while no object is awake or sleeps for some frames, no behavior or task is due and
+        // nothing is queued on the bus, frames are skipped and the loop blocks until an SDL event arrives.
+        // The loop runs at HiddenFrameRate while all the windows are minimized or hidden
+        void SetIdleMode(bool isEnabled);
+        // the next frame is run even if idle, may be called from any thread
+        void RequestRedraw();
+        size_t GetFramesNum() const;
+
+        const AllocationStats &GetLastFrameAllocations() const;
+        size_t GetLastFrameErrors() const;
+        // input of the current frame, may be queried by objects instead of subscribing
+        const InputState &GetInputState() const;
+        // events enqueued during the update are dispatched right after it, before presenting the frame
+        EventBus &GetEventBus();
+        // which SDL events are polled; window, mouse and controller events are published on the bus while polling
+        EventRouter &GetEventRouter();
+        const EventPollStats &GetLastPollStats() const;
+        // behaviors are resumed right after the objects are updated, before the events are dispatched
+        BehaviorScheduler &GetBehaviors();
+        // tasks run after the frame is presented, in the time left until the next one but no longer than the budget.
+        // Unpaced loops give them the whole budget every frame
+        TaskScheduler &GetTasks();
+        void SetTaskBudget(std::chrono::nanoseconds budget);
+        const TaskStats &GetLastTaskStats() const;
+
+        // writes the input of every frame, until the loop stops
+        void RecordInput(std::unique_ptr<InputRecorder> recorder);
+        // feeds the recorded input at the same frames instead of the user's one, the loop stops after
+        // the last recorded frame. At max speed frames aren't delayed
+        void ReplayInput(std::unique_ptr<InputReplayer> replayer, bool isMaxSpeed = false);
     };
 } // namespace GameEngine
\ No newline at end of file
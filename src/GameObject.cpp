@@ -1,7 +1,9 @@
 
 #include "GameObject.h"
+#include "ComponentPool.h"
 #include "ErrorHandling.h"
 
+#include <algorithm>
 
 namespace GameEngine {
 
@@ -9,6 +11,13 @@ namespace GameEngine {
         :m_name(std::move(name))
         {}
 
+    GameObject::~GameObject() {
+        // children may be kept elsewhere: they mustn't point back to this object
+        for (const auto &child : m_children) {
+            detach_child(*child);
+        }
+    }
+
     void GameObject::AddComponent(GameObjectComponentType type) {
         AddComponent(type, std::any()); // call with default no-value
     }
@@ -18,11 +27,11 @@ namespace GameEngine {
                    "Invalid argument type");
         std::shared_ptr<TransformComponent> new_transform;
         if (arg.has_value()) {
-            const auto pos = std::any_cast<Size2D>(arg);
-            new_transform.reset(new TransformComponent(pos));
+            const auto size = std::any_cast<Size2D>(arg);
+            new_transform = MakePooled<TransformComponent>([&size] { return TransformComponent(size); });
         }
         else {
-            new_transform.reset(new TransformComponent());
+            new_transform = MakePooled<TransformComponent>([] { return TransformComponent(); });
         }
         m_components[GameObjectComponentType::TRANSFORM] = new_transform;
     }
@@ -34,7 +43,7 @@ namespace GameEngine {
         const auto transform = GetComponent<const TransformComponent>();
         const auto context = std::any_cast<RenderContext>(arg);
         m_components[GameObjectComponentType::RENDERER] =
-                std::shared_ptr<RendererComponent>(new RendererComponent(context, transform));
+                MakePooled<RendererComponent>([&] { return RendererComponent(context, transform); });
     }
 
     void GameObject::add_texture(const std::any &arg) {
@@ -45,10 +54,10 @@ namespace GameEngine {
         const auto renderer = GetComponent<const RendererComponent>();
         if (arg.type() == typeid(std::string)) {
             const auto name = std::any_cast<std::string>(arg);
-            new_texture.reset(new TextureComponent(renderer->GetRenderContext(), name));
+            new_texture = MakePooled<TextureComponent>([&] { return TextureComponent(renderer->GetRenderContext(), name); });
         }else {
             const auto size = std::any_cast<Size2D>(arg);
-            new_texture.reset(new TextureComponent(renderer->GetRenderContext(), size));
+            new_texture = MakePooled<TextureComponent>([&] { return TextureComponent(renderer->GetRenderContext(), size); });
         }
         m_components[GameObjectComponentType::TEXTURE] = new_texture;
     }
@@ -60,18 +69,20 @@ namespace GameEngine {
         // check if Renderer exists
         const auto renderer = GetComponent<const RendererComponent>();
         const auto tex_files = std::any_cast<tex_files_list_type>(arg);
-        using TexturePtr = std::shared_ptr<TextureComponent>;
-        // populate with textures
-        std::vector<std::vector<TexturePtr>> rows;
+        const auto context = renderer->GetRenderContext();
+        auto matrix = MakePooled<TextureMatrixComponent>([] { return TextureMatrixComponent(); });
+        // textures are not movable: all the cells are reserved upfront
+        size_t cells = 0;
         for (const auto &row : tex_files) {
-            std::vector<TexturePtr> tex_row;
-            for (const auto &filename : row) {
-                tex_row.emplace_back(new TextureComponent(renderer->GetRenderContext(), filename));
-            }
-            rows.emplace_back(std::move(tex_row));
+            cells += row.size();
+        }
+        matrix->Reserve(cells);
+        // populate with textures constructed in place
+        for (const auto &row : tex_files) {
+            const auto *files = row.begin();
+            matrix->EmplaceRow(row.size(), [&](size_t col) { return TextureComponent(context, files[col]); });
         }
-        m_components[GameObjectComponentType::TEXTURE_MATRIX] =
-                std::shared_ptr<TextureMatrixComponent>(new TextureMatrixComponent(std::move(rows)));
+        m_components[GameObjectComponentType::TEXTURE_MATRIX] = matrix;
     }
 
     void GameObject::AddComponent(GameObjectComponentType type, std::any arg) {
@@ -107,14 +118,50 @@ namespace GameEngine {
         return m_components.at(type);
     }
 
-    void GameObject::Update() {
+    void GameObject::AddChild(const std::shared_ptr<IGameObject> &child) {
+        auto child_obj = std::dynamic_pointer_cast<GameObject>(child);
+        EXPECT_MSG(child_obj, "Child must be a GameObject");
+        EXPECT_MSG(!child_obj->m_parent, "Child " << child_obj->m_name << " already has a parent");
+        for (const auto *obj = this; obj; obj = obj->m_parent) {
+            EXPECT_MSG(obj != child_obj.get(), "Cyclic hierarchy of " << m_name);
+        }
+        // check if Transforms exist
+        const auto transform = GetComponent<TransformComponent>();
+        const auto child_transform = child_obj->GetComponent<TransformComponent>();
+        TransformHierarchy::Attach(*transform, *child_transform);
+        child_obj->m_parent = this;
+        // awoken once, a child moved to another parent keeps its state
+        if (!child_obj->m_awoken) {
+            child_obj->m_awoken = true;
+            child->Awake();
+        }
+        m_children.push_back(std::move(child_obj));
+    }
+
+    void GameObject::RemoveChild(const std::shared_ptr<IGameObject> &child) {
+        const auto it = std::find(m_children.begin(), m_children.end(), child);
+        EXPECT_MSG(it != m_children.end(), "Not a child of " << m_name);
+        detach_child(**it);
+        m_children.erase(it);
+    }
+
+    void GameObject::detach_child(GameObject &child) {
+        TransformHierarchy::Detach(*child.GetComponent<TransformComponent>());
+        child.m_parent = nullptr;
+    }
+
+    void GameObject::Update(float elapsed) {
+        m_elapsed = elapsed;
         // call OnUpdate()
         this->OnUpdate();
         // call OnUpdate for all components
         for(const auto &[key, val] : m_components) {
             val->OnUpdate();
         }
-        //todo: children?
+        // children after the parent
+        for (const auto &child : m_children) {
+            child->Update(elapsed);
+        }
     }
     
 } // GameEngine
\ No newline at end of file
@@ -15,27 +15,36 @@ namespace GameEngine {
         using ComponentPtr = std::shared_ptr<IGameObjectComponent>;
         std::string m_name;
         std::map<GameObjectComponentType, ComponentPtr> m_components;
-        void Update() final; // cannot be overridden
+        std::vector<std::shared_ptr<GameObject>> m_children;
+        const GameObject *m_parent = nullptr; // cleared when the parent goes away
+        bool m_awoken = false; // Awake() called by a parent
+        float m_elapsed = 0;
+        void Update(float elapsed) final; // cannot be overridden
         void add_transform(const std::any &arg);
         void add_renderer(const std::any &arg);
         void add_texture(const std::any &arg);
         void add_texture_matrix(const std::any &arg);
+        void detach_child(GameObject &child);
     protected:
         void OnUpdate() override {};
         void Awake() override {};
         void OnEnable() override {};
         void OnDisable() override {};
+        // seconds since the previous update, for OnUpdate() of objects updated at a lower rate
+        float GetElapsedTime() const { return m_elapsed; }
     public:
         explicit GameObject(std::string name);
         GameObject(const GameObject &) = delete;
         GameObject &operator=(const GameObject &) = delete;
         GameObject(GameObject &&) = delete;
         GameObject &operator=(GameObject &&) = delete;
-        ~GameObject() override = default;
+        ~GameObject() override; // children kept elsewhere become roots
 
         void AddComponent(GameObjectComponentType type) final; // cannot be overridden
         void AddComponent(GameObjectComponentType type, std::any arg) final; // cannot be overridden
         std::shared_ptr<IGameObjectComponent> GetComponent(GameObjectComponentType type) const override;
+        void AddChild(const std::shared_ptr<IGameObject> &child) override;
+        void RemoveChild(const std::shared_ptr<IGameObject> &child) override;
 
         /// template GetComponent
         template<typename T>
@@ -38,7 +38,7 @@ namespace GameEngine {
         static constexpr const char* name = "Texture";
     };
 
-    using TextureMatrixComponent = ComponentMatrix<TextureComponent>;
+    using TextureMatrixComponent = ComponentMatrix<TextureComponent, ValueCellStorage>;
 
     template<>
     struct ComponentTypes<TextureMatrixComponent> {
@@ -10,7 +10,10 @@ namespace GameEngine
     {
         virtual ~IGameLoop() = default;
 
+        // the only window
         virtual void SetWindow(const std::shared_ptr<IWindow>& window) = 0;
+        virtual void AddWindow(const std::shared_ptr<IWindow>& window) = 0;
+        virtual void RemoveWindow(const IWindow& window) = 0;
         virtual void Run() = 0;
     };
 } // namespace GameEngine
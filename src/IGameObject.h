@@ -16,9 +16,14 @@ namespace GameEngine {
         virtual void AddComponent(GameObjectComponentType type) = 0;
         virtual void AddComponent(GameObjectComponentType type, std::any arg) = 0;
         virtual std::shared_ptr<IGameObjectComponent> GetComponent(GameObjectComponentType type) const = 0;
-        //todo: AddChild()
+        // child is updated after the parent, its transform becomes local to the parent.
+        // The child is awoken on its first attach. It must not be appended to a window as well:
+        // the window would awake it again and update it a second time each frame
+        virtual void AddChild(const std::shared_ptr<IGameObject> &child) = 0;
+        // child becomes a root again, keeping its world position
+        virtual void RemoveChild(const std::shared_ptr<IGameObject> &child) = 0;
         virtual void OnUpdate() = 0;
-        virtual void Update() = 0;
+        virtual void Update(float elapsed) = 0; // elapsed: seconds since the object's previous update
         virtual void Awake() = 0; // call once when instantiated
         virtual void OnEnable() = 0;
         virtual void OnDisable() = 0;
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "Types.h"
+
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <string_view>
 
 namespace GameEngine
 {
@@ -19,6 +25,47 @@ namespace GameEngine
         D,
     };
 
+    enum class InputEventType : uint8_t
+    {
+        KEY_DOWN,
+        KEY_UP,
+        MOUSE_MOTION,
+        MOUSE_BUTTON_DOWN,
+        MOUSE_BUTTON_UP,
+        MOUSE_WHEEL,
+        TEXT_INPUT,
+    };
+
+    // Input event of a frame, fields not related to the type are zero
+    struct InputEvent
+    {
+        InputEventType type = InputEventType::KEY_DOWN;
+        uint32_t timestamp = 0; // ms since SDL initialization
+        uint16_t scancode = 0; // KEY_*: SDL scancode, any key
+        KeyCodes keyCode = KeyCodes::UNSUPPORTED; // KEY_*
+        bool repeat = false; // KEY_DOWN: auto-repeat of a held key
+        uint8_t button = 0; // MOUSE_BUTTON_*: SDL_BUTTON_LEFT, ...
+        Pos2D position; // MOUSE_*
+        Pos2D delta; // MOUSE_MOTION: relative motion, MOUSE_WHEEL: scroll amount
+        std::array<char, 32> text{}; // TEXT_INPUT: null-terminated UTF-8
+
+        std::string_view GetText() const noexcept
+        {
+            return { text.data(), std::char_traits<char>::length(text.data()) };
+        }
+    };
+
+    class InputState;
+
+    // Receives all the input events of a frame at once
+    struct IInputBatchSubscriber
+    {
+        virtual ~IInputBatchSubscriber() = default;
+
+        // events in order of arrival, state is the snapshot after all of them
+        virtual void OnInputEvents(std::span<const InputEvent> events, const InputState& state) = 0;
+    };
+
     struct IInputEventSubscriber
     {
         virtual ~IInputEventSubscriber() = default;
@@ -33,5 +80,7 @@ namespace GameEngine
 
         virtual void SubscribeToInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub) = 0;
         virtual void UnsubscribeFromInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub) = 0;
+        virtual void SubscribeToInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub) = 0;
+        virtual void UnsubscribeFromInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub) = 0;
     };
 } // namespace GameEngine
\ No newline at end of file
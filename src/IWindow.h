@@ -4,12 +4,17 @@
 #include "IGameObject.h"
 #include "Types.h"
 
+#include <cstdint>
 #include <memory>
 
 namespace GameEngine {
 
     struct IWindow {
         virtual ~IWindow() = default;
+        /// SDL window ID events are routed by, 0 - none
+        virtual uint32_t GetId() const = 0;
+        /// Objects of a window with a renderer draw during Update(), which has to stay on the main thread
+        virtual bool HasRenderer() const = 0;
         /// Size
         virtual void Resize(const Size2D &size) const = 0;
         /// Position
@@ -29,7 +34,7 @@ namespace GameEngine {
         virtual void SetAlwaysOnTop(bool on_top) = 0;
 
         virtual void Clear() const = 0; // clear screen
-        virtual void Update() const = 0; // refresh textures (coordinates, flip, angle)
+        virtual void Update(float elapsed) const = 0; // refresh textures (coordinates, flip, angle), elapsed: seconds since the previous frame
         virtual void Present() const = 0; // update changes made to screen
         /// GameObject
         virtual GameObjectId AppendObject(const std::shared_ptr<IGameObject>& obj) = 0;
@@ -37,5 +42,13 @@ namespace GameEngine {
         virtual void RemoveObject(GameObjectId id) = 0;
         virtual IGameObject *GetObject(GameObjectId id) const = 0;
         virtual void SetObjectActive(GameObjectId id, bool active) = 0;
+        /// Sleeping active objects aren't updated
+        virtual void SleepObject(GameObjectId id) = 0; // until WakeObject()
+        virtual void SleepObjectFor(GameObjectId id, uint32_t frames) = 0; // updated again the given number of frames later
+        virtual void WakeObject(GameObjectId id) = 0;
+        /// Objects updated every few frames, see UpdateTier
+        virtual void SetObjectUpdateInterval(GameObjectId id, uint32_t frames) = 0;
+        /// No awake active objects and no timed sleeps: Update() would change nothing
+        virtual bool IsIdle() const = 0;
     };
 }
@@ -1,26 +1,46 @@
-
 #include "InputEventPublisher.h"
 
 namespace GameEngine
 {
     void InputEventPublisher::SubscribeToInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub)
     {
-        m_subscribers.push_back(sub);
+        m_subscribers.Add(sub);
     }
 
     void InputEventPublisher::UnsubscribeFromInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub)
     {
-        remove_subscriber(sub);
+        m_subscribers.Remove(sub);
+    }
+
+    void InputEventPublisher::SubscribeToInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub)
+    {
+        m_batchSubscribers.Add(sub);
+    }
+
+    void InputEventPublisher::UnsubscribeFromInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub)
+    {
+        m_batchSubscribers.Remove(sub);
     }
 
     void InputEventPublisher::OnKeyUp(KeyCodes keyCode)
     {
-        call_subscribers(&IInputEventSubscriber::OnKeyUp, keyCode);
+        call_subscribers(m_subscribers, &IInputEventSubscriber::OnKeyUp, keyCode);
     }
 
     void InputEventPublisher::OnKeyDown(KeyCodes keyCode)
     {
-        call_subscribers(&IInputEventSubscriber::OnKeyDown, keyCode);
+        call_subscribers(m_subscribers, &IInputEventSubscriber::OnKeyDown, keyCode);
+    }
+
+    void InputEventPublisher::PublishInputEvents(std::span<const InputEvent> events, const InputState& state)
+    {
+        call_subscribers(m_batchSubscribers, &IInputBatchSubscriber::OnInputEvents, events, state);
+    }
+
+    void InputEventPublisher::CompactSubscribers()
+    {
+        m_subscribers.Compact();
+        m_batchSubscribers.Compact();
     }
 
 } // namespace GameEngine
@@ -2,64 +2,50 @@
 
 #include "ErrorHandling.h"
 #include "IInputEvent.h"
+#include "SubscriberList.h"
 
-#include <algorithm>
-#include <vector>
 #include <functional>
 
 namespace GameEngine
 {
+    // Subscriptions may change from any thread and from within the subscribers' callbacks
     class InputEventPublisher : public IInputEventSubscriber, public IInputEventPublisher
     {
     private:
-        std::vector<std::weak_ptr<IInputEventSubscriber>> m_subscribers;
+        SubscriberList<IInputEventSubscriber> m_subscribers;
+        SubscriberList<IInputBatchSubscriber> m_batchSubscribers;
 
     private:
-        auto remove_subscriber(const std::shared_ptr<IInputEventSubscriber>& sub)
+        template <typename Subscriber, typename Callable, typename ...Args>
+        static void call_subscribers(SubscriberList<Subscriber>& subscribers, Callable c, const Args& ... args)
         {
-            auto it = std::remove_if(m_subscribers.begin(), m_subscribers.end(),
-                [&sub](const std::weak_ptr<IInputEventSubscriber>& wp)
-                {
-                    return !sub.owner_before(wp) && !wp.owner_before(sub);
-                });
-
-            return m_subscribers.erase(it, m_subscribers.end());
-        }
-
-        template <typename Callable, typename ...Args>
-        void call_subscribers(Callable c, Args&& ... args)
-        {
-            for (auto it = m_subscribers.begin(); it != m_subscribers.end();)
+            subscribers.ForEach([&](Subscriber& sub)
             {
                 try
                 {
-                    const auto sp = it->lock();
-
-                    if (sp)
-                    {
-                        ++it;
-                        std::invoke(c, sp.get(), std::forward<Args>(args)...);
-                    }
-                    else
-                    {
-                        // Subscriber has expired - remove
-                        it = remove_subscriber(sp);
-                    }
+                    std::invoke(c, sub, args...);
                 }
                 catch (const std::exception&)
                 {
                     HANDLE_EXCEPTION_MSG("Subscriber throws");
                 }
-            }
+            });
         }
 
     public:
         // IInputEventPublisher
         void SubscribeToInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub) override;
         void UnsubscribeFromInputEvents(const std::shared_ptr<IInputEventSubscriber>& sub) override;
+        void SubscribeToInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub) override;
+        void UnsubscribeFromInputBatches(const std::shared_ptr<IInputBatchSubscriber>& sub) override;
 
         // IInputEventSubscriber
         void OnKeyUp(KeyCodes keyCode) override;
         void OnKeyDown(KeyCodes keyCode) override;
+
+        // a single call per batch subscriber, however many events there are
+        void PublishInputEvents(std::span<const InputEvent> events, const InputState& state);
+        // drops destroyed subscribers, allocates only if there are any
+        void CompactSubscribers();
     };
-} // namespace GameEngine
\ No newline at end of file
+} // namespace GameEngine
@@ -0,0 +1,153 @@
+#include "InputRecording.h"
+#include "ErrorHandling.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <type_traits>
+
+namespace GameEngine
+{
+    static_assert(std::is_trivially_copyable_v<InputEvent>, "InputEvent is written as is");
+
+    namespace
+    {
+        struct FrameHeader
+        {
+            uint64_t frame;
+            uint32_t timeMs;
+            uint32_t count;
+        };
+
+        template <typename T>
+        bool Read(std::FILE* file, T& value)
+        {
+            return std::fread(&value, sizeof(value), 1, file) == 1;
+        }
+    }
+
+    InputRecorder::InputRecorder(const std::string& path)
+        : Logable("InputRecorder")
+        , m_file(std::fopen(path.c_str(), "wb"))
+    {
+        EXPECT_MSG(m_file, "Unable to create input recording " << path);
+        const uint32_t header[] = { InputRecording::Version, sizeof(InputEvent) };
+        std::fwrite(InputRecording::Magic.data(), 1, InputRecording::Magic.size(), m_file);
+        std::fwrite(header, sizeof(header), 1, m_file);
+        LOG_INFO("Recording input to " << path);
+    }
+
+    InputRecorder::~InputRecorder()
+    {
+        if (m_file)
+        {
+            std::fclose(m_file);
+        }
+    }
+
+    void InputRecorder::RecordFrame(uint64_t frame, uint32_t timeMs, std::span<const InputEvent> events)
+    {
+        if (!m_file || events.empty())
+        {
+            return;
+        }
+        EXPECT_MSG(events.size() <= InputRecording::MaxFrameEvents, "Too many input events in frame " << frame << ": " << events.size());
+        const FrameHeader header{ frame, timeMs, static_cast<uint32_t>(events.size()) };
+        std::fwrite(&header, sizeof(header), 1, m_file);
+        std::fwrite(events.data(), sizeof(InputEvent), events.size(), m_file);
+    }
+
+    void InputRecorder::Finish(uint64_t framesNum)
+    {
+        if (!m_file)
+        {
+            return;
+        }
+        const FrameHeader end{ framesNum, 0, InputRecording::EndMarker };
+        std::fwrite(&end, sizeof(end), 1, m_file);
+        std::fclose(m_file);
+        m_file = nullptr;
+        LOG_INFO("Recorded " << framesNum << " frames");
+    }
+
+    InputReplayer::InputReplayer(const std::string& path)
+        : Logable("InputReplayer")
+    {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        EXPECT_MSG(file, "Unable to open input recording " << path);
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(path, ec);
+
+        std::array<char, 8> magic{};
+        uint32_t version = 0;
+        uint32_t eventSize = 0;
+        const bool isValid = std::fread(magic.data(), 1, magic.size(), file) == magic.size() && magic == InputRecording::Magic
+                          && Read(file, version) && version == InputRecording::Version
+                          && Read(file, eventSize) && eventSize == sizeof(InputEvent);
+        if (!isValid)
+        {
+            std::fclose(file);
+            EXPECT_MSG(false, "Not an input recording of this build: " << path);
+        }
+
+        bool isComplete = false;
+        FrameHeader header{};
+        while (Read(file, header))
+        {
+            if (header.count == InputRecording::EndMarker)
+            {
+                m_framesNum = header.frame;
+                isComplete = true;
+                break;
+            }
+            if (header.count > InputRecording::MaxFrameEvents)
+            {
+                std::fclose(file);
+                EXPECT_MSG(false, "Not an input recording of this build: " << path);
+            }
+            // the rest of the file bounds the allocation: the events of a cut off frame are missing
+            const auto position = std::ftell(file);
+            if (ec || position < 0 || header.count * sizeof(InputEvent) > fileSize - static_cast<uint64_t>(position))
+            {
+                break;
+            }
+            const auto first = m_events.size();
+            m_events.resize(first + header.count);
+            if (std::fread(m_events.data() + first, sizeof(InputEvent), header.count, file) != header.count)
+            {
+                m_events.resize(first);
+                break;
+            }
+            m_frames.push_back({ header.frame, static_cast<uint32_t>(first), header.count });
+        }
+        std::fclose(file);
+
+        if (!isComplete)
+        {
+            // e.g. the recording session crashed
+            m_framesNum = m_frames.empty() ? 0 : m_frames.back().index + 1;
+            LOG_WARNING("Input recording " << path << " is cut off, replaying " << m_framesNum << " frames");
+        }
+        LOG_INFO("Loaded " << m_events.size() << " input events of " << m_framesNum << " frames from " << path);
+    }
+
+    std::span<const InputEvent> InputReplayer::GetFrameEvents(uint64_t frame) const
+    {
+        const auto it = std::lower_bound(m_frames.begin(), m_frames.end(), frame,
+            [](const Frame& f, uint64_t index) { return f.index < index; });
+        if (it == m_frames.end() || it->index != frame)
+        {
+            return {};
+        }
+        return { m_events.data() + it->first, it->count };
+    }
+
+    uint64_t InputReplayer::GetFramesNum() const
+    {
+        return m_framesNum;
+    }
+
+    bool InputReplayer::IsFinished(uint64_t frame) const
+    {
+        return frame >= m_framesNum;
+    }
+} // namespace GameEngine
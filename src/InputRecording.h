@@ -0,0 +1,72 @@
+#pragma once
+
+#include "IInputEvent.h"
+#include "Logger.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+// Input recording file layout, values are stored in the native byte order.
+//
+//  file:   Magic, uint32 Version, uint32 sizeof(InputEvent), frames...
+//  FRAME:  uint64 frame index, uint32 ms since SDL initialization, uint32 count, InputEvent[count]
+//  END:    uint64 number of recorded frames, uint32 0, uint32 EndMarker
+//
+// Only the frames with input are written, at most MaxFrameEvents events per frame.
+namespace GameEngine
+{
+    namespace InputRecording
+    {
+        constexpr std::array<char, 8> Magic = {'G', 'E', 'I', 'N', 'P', 'U', 'T', '\0'};
+        constexpr uint32_t Version = 1;
+        constexpr uint32_t EndMarker = 0xFFFFFFFF;
+        // sanity limit: a larger count means a corrupt file
+        constexpr uint32_t MaxFrameEvents = 64 * 1024;
+    }
+
+    // Writes the translated input events of the game loop frames
+    class InputRecorder : private Logable
+    {
+    public:
+        explicit InputRecorder(const std::string& path);
+        ~InputRecorder();
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        void RecordFrame(uint64_t frame, uint32_t timeMs, std::span<const InputEvent> events);
+        // writes the end of the recording, further frames are ignored
+        void Finish(uint64_t framesNum);
+
+    private:
+        std::FILE* m_file = nullptr;
+    };
+
+    // Recorded input loaded in memory, served by frame index
+    class InputReplayer : private Logable
+    {
+    public:
+        explicit InputReplayer(const std::string& path);
+
+        std::span<const InputEvent> GetFrameEvents(uint64_t frame) const;
+        // number of frames of the recorded session
+        uint64_t GetFramesNum() const;
+        bool IsFinished(uint64_t frame) const;
+
+    private:
+        struct Frame
+        {
+            uint64_t index;
+            uint32_t first; // in m_events
+            uint32_t count;
+        };
+
+        std::vector<Frame> m_frames; // by index
+        std::vector<InputEvent> m_events;
+        uint64_t m_framesNum = 0;
+    };
+} // namespace GameEngine
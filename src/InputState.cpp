@@ -0,0 +1,281 @@
+#include "InputState.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace GameEngine
+{
+    KeyCodes SdlScancodeToKeyCodes(SDL_Scancode scancode)
+    {
+        switch (scancode)
+        {
+            case SDL_SCANCODE_UP: return KeyCodes::ARROW_UP;
+            case SDL_SCANCODE_LEFT: return KeyCodes::ARROW_LEFT;
+            case SDL_SCANCODE_DOWN: return KeyCodes::ARROW_DOWN;
+            case SDL_SCANCODE_RIGHT: return KeyCodes::ARROW_RIGHT;
+
+            case SDL_SCANCODE_W: return KeyCodes::W;
+            case SDL_SCANCODE_A: return KeyCodes::A;
+            case SDL_SCANCODE_S: return KeyCodes::S;
+            case SDL_SCANCODE_D: return KeyCodes::D;
+
+            default: return KeyCodes::UNSUPPORTED;
+        }
+    }
+
+    SDL_Scancode KeyCodesToSdlScancode(KeyCodes keyCode)
+    {
+        switch (keyCode)
+        {
+            case KeyCodes::ARROW_UP: return SDL_SCANCODE_UP;
+            case KeyCodes::ARROW_LEFT: return SDL_SCANCODE_LEFT;
+            case KeyCodes::ARROW_DOWN: return SDL_SCANCODE_DOWN;
+            case KeyCodes::ARROW_RIGHT: return SDL_SCANCODE_RIGHT;
+
+            case KeyCodes::W: return SDL_SCANCODE_W;
+            case KeyCodes::A: return SDL_SCANCODE_A;
+            case KeyCodes::S: return SDL_SCANCODE_S;
+            case KeyCodes::D: return SDL_SCANCODE_D;
+
+            default: return SDL_SCANCODE_UNKNOWN;
+        }
+    }
+
+    void InputState::BeginFrame()
+    {
+        m_pressed.reset();
+        m_released.reset();
+        m_buttonsPressed.reset();
+        m_buttonsReleased.reset();
+        m_mouseDelta = {};
+        m_mouseWheel = {};
+        m_text.clear();
+        m_events.clear();
+    }
+
+    bool InputState::IsInputEvent(const SDL_Event& event)
+    {
+        switch (event.type)
+        {
+            case SDL_KEYDOWN:
+            case SDL_KEYUP:
+            case SDL_MOUSEMOTION:
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            case SDL_MOUSEWHEEL:
+            case SDL_TEXTINPUT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool InputState::HandleEvent(const SDL_Event& event)
+    {
+        InputEvent e;
+        switch (event.type)
+        {
+            case SDL_KEYDOWN:
+            case SDL_KEYUP:
+            {
+                e.type = event.type == SDL_KEYDOWN ? InputEventType::KEY_DOWN : InputEventType::KEY_UP;
+                e.timestamp = event.key.timestamp;
+                e.scancode = static_cast<uint16_t>(event.key.keysym.scancode);
+                e.keyCode = SdlScancodeToKeyCodes(event.key.keysym.scancode);
+                e.repeat = event.key.repeat != 0;
+                break;
+            }
+            case SDL_MOUSEMOTION:
+            {
+                e.type = InputEventType::MOUSE_MOTION;
+                e.timestamp = event.motion.timestamp;
+                e.position = { event.motion.x, event.motion.y };
+                e.delta = { event.motion.xrel, event.motion.yrel };
+                break;
+            }
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            {
+                e.type = event.type == SDL_MOUSEBUTTONDOWN ? InputEventType::MOUSE_BUTTON_DOWN : InputEventType::MOUSE_BUTTON_UP;
+                e.timestamp = event.button.timestamp;
+                e.button = event.button.button;
+                e.position = { event.button.x, event.button.y };
+                break;
+            }
+            case SDL_MOUSEWHEEL:
+            {
+                e.type = InputEventType::MOUSE_WHEEL;
+                e.timestamp = event.wheel.timestamp;
+                e.position = m_mousePosition;
+                e.delta = { event.wheel.x, event.wheel.y };
+                break;
+            }
+            case SDL_TEXTINPUT:
+            {
+                e.type = InputEventType::TEXT_INPUT;
+                e.timestamp = event.text.timestamp;
+                std::copy(std::begin(event.text.text), std::end(event.text.text), e.text.begin());
+                e.text.back() = '\0';
+                break;
+            }
+            default:
+            {
+                return false;
+            }
+        }
+        Apply(e);
+        return true;
+    }
+
+    void InputState::Apply(const InputEvent& event)
+    {
+        m_events.push_back(event);
+        switch (event.type)
+        {
+            case InputEventType::KEY_DOWN:
+            case InputEventType::KEY_UP:
+            {
+                handle_key(event);
+                break;
+            }
+            case InputEventType::MOUSE_MOTION:
+            {
+                m_mousePosition = event.position;
+                m_mouseDelta.x += event.delta.x;
+                m_mouseDelta.y += event.delta.y;
+                break;
+            }
+            case InputEventType::MOUSE_BUTTON_DOWN:
+            case InputEventType::MOUSE_BUTTON_UP:
+            {
+                handle_mouse_button(event);
+                break;
+            }
+            case InputEventType::MOUSE_WHEEL:
+            {
+                m_mouseWheel.x += event.delta.x;
+                m_mouseWheel.y += event.delta.y;
+                break;
+            }
+            case InputEventType::TEXT_INPUT:
+            {
+                m_text += event.GetText();
+                break;
+            }
+        }
+    }
+
+    bool InputState::IsHeld(SDL_Scancode scancode) const
+    {
+        return is_valid(scancode) && m_held[scancode];
+    }
+
+    bool InputState::WasPressed(SDL_Scancode scancode) const
+    {
+        return is_valid(scancode) && m_pressed[scancode];
+    }
+
+    bool InputState::WasReleased(SDL_Scancode scancode) const
+    {
+        return is_valid(scancode) && m_released[scancode];
+    }
+
+    bool InputState::IsHeld(KeyCodes keyCode) const
+    {
+        return IsHeld(KeyCodesToSdlScancode(keyCode));
+    }
+
+    bool InputState::WasPressed(KeyCodes keyCode) const
+    {
+        return WasPressed(KeyCodesToSdlScancode(keyCode));
+    }
+
+    bool InputState::WasReleased(KeyCodes keyCode) const
+    {
+        return WasReleased(KeyCodesToSdlScancode(keyCode));
+    }
+
+    bool InputState::IsMouseButtonHeld(uint8_t button) const
+    {
+        return button < MouseButtonCount && m_buttonsHeld[button];
+    }
+
+    bool InputState::WasMouseButtonPressed(uint8_t button) const
+    {
+        return button < MouseButtonCount && m_buttonsPressed[button];
+    }
+
+    bool InputState::WasMouseButtonReleased(uint8_t button) const
+    {
+        return button < MouseButtonCount && m_buttonsReleased[button];
+    }
+
+    const Pos2D& InputState::GetMousePosition() const
+    {
+        return m_mousePosition;
+    }
+
+    const Pos2D& InputState::GetMouseDelta() const
+    {
+        return m_mouseDelta;
+    }
+
+    const Pos2D& InputState::GetMouseWheel() const
+    {
+        return m_mouseWheel;
+    }
+
+    std::string_view InputState::GetText() const
+    {
+        return m_text;
+    }
+
+    std::span<const InputEvent> InputState::GetEvents() const
+    {
+        return m_events;
+    }
+
+    bool InputState::is_valid(SDL_Scancode scancode)
+    {
+        return scancode > SDL_SCANCODE_UNKNOWN && static_cast<size_t>(scancode) < KeyCount;
+    }
+
+    void InputState::handle_key(const InputEvent& key)
+    {
+        const auto scancode = static_cast<SDL_Scancode>(key.scancode);
+        if (!is_valid(scancode) || key.repeat)
+        {
+            return;
+        }
+        const bool isDown = key.type == InputEventType::KEY_DOWN;
+        // both edges are kept when a key is pressed and released within a frame
+        if (isDown)
+        {
+            m_pressed[scancode] = true;
+        }
+        else
+        {
+            m_released[scancode] = true;
+        }
+        m_held[scancode] = isDown;
+    }
+
+    void InputState::handle_mouse_button(const InputEvent& button)
+    {
+        m_mousePosition = button.position;
+        if (button.button >= MouseButtonCount)
+        {
+            return;
+        }
+        if (button.type == InputEventType::MOUSE_BUTTON_DOWN)
+        {
+            m_buttonsPressed[button.button] = true;
+            m_buttonsHeld[button.button] = true;
+        }
+        else
+        {
+            m_buttonsReleased[button.button] = true;
+            m_buttonsHeld[button.button] = false;
+        }
+    }
+} // namespace GameEngine
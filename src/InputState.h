@@ -0,0 +1,69 @@
+#pragma once
+
+#include "IInputEvent.h"
+
+#include "sdl.h"
+
+#include <bitset>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GameEngine
+{
+    KeyCodes SdlScancodeToKeyCodes(SDL_Scancode scancode);
+    SDL_Scancode KeyCodesToSdlScancode(KeyCodes keyCode);
+
+    // Snapshot of the input of a frame: held keys and mouse buttons with their pressed/released edges,
+    // mouse position and motion, text input and all the events in order of arrival.
+    // Queries are bit tests, so any number of objects may poll it every frame
+    class InputState
+    {
+    public:
+        static constexpr size_t KeyCount = SDL_NUM_SCANCODES;
+        static constexpr size_t MouseButtonCount = 8;
+
+        // clears the edges and events of the previous frame, held keys are kept
+        void BeginFrame();
+        // translates and applies the SDL event, returns false for events which aren't input
+        bool HandleEvent(const SDL_Event& event);
+        // the SDL event types HandleEvent translates: keyboard, mouse and text input
+        static bool IsInputEvent(const SDL_Event& event);
+        // applies an already translated event, e.g. a replayed one
+        void Apply(const InputEvent& event);
+
+        bool IsHeld(SDL_Scancode scancode) const;
+        bool WasPressed(SDL_Scancode scancode) const; // since the previous frame
+        bool WasReleased(SDL_Scancode scancode) const;
+        bool IsHeld(KeyCodes keyCode) const;
+        bool WasPressed(KeyCodes keyCode) const;
+        bool WasReleased(KeyCodes keyCode) const;
+
+        bool IsMouseButtonHeld(uint8_t button) const;
+        bool WasMouseButtonPressed(uint8_t button) const;
+        bool WasMouseButtonReleased(uint8_t button) const;
+        const Pos2D& GetMousePosition() const;
+        const Pos2D& GetMouseDelta() const; // motion accumulated over the frame
+        const Pos2D& GetMouseWheel() const;
+
+        std::string_view GetText() const; // text input of the frame
+        std::span<const InputEvent> GetEvents() const;
+
+    private:
+        static bool is_valid(SDL_Scancode scancode);
+        void handle_key(const InputEvent& key);
+        void handle_mouse_button(const InputEvent& button);
+
+        std::bitset<KeyCount> m_held;
+        std::bitset<KeyCount> m_pressed;
+        std::bitset<KeyCount> m_released;
+        std::bitset<MouseButtonCount> m_buttonsHeld;
+        std::bitset<MouseButtonCount> m_buttonsPressed;
+        std::bitset<MouseButtonCount> m_buttonsReleased;
+        Pos2D m_mousePosition;
+        Pos2D m_mouseDelta;
+        Pos2D m_mouseWheel;
+        std::string m_text; // capacity is reused between frames
+        std::vector<InputEvent> m_events; // capacity is reused between frames
+    };
+} // namespace GameEngine
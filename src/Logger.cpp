@@ -1,165 +1,1549 @@
 #include "Logger.h"
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <vector>
 #include <mutex>
 #include <fstream>
 #include <ctime>
 #include <chrono>
-#include <iomanip>
 #include <iostream>
 #include <thread>
 #include <filesystem>
 
+#ifdef WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
-namespace
-{
-#define LOG_X(name) #name,
-    constexpr const char* LogLevelTags[] = {_LOG_LEVELS_};
-#undef LOG_X
+namespace
+{
+#define LOG_X(name) #name,
+    constexpr const char* LogLevelTags[] = {_LOG_LEVELS_};
+#undef LOG_X
+
+    class DummyLogger : public GameEngine::ILogger
+    {
+        void Log(GameEngine::LogLevel, const char*) noexcept override {}
+        void Log(GameEngine::LogLevel, const std::string&) noexcept override {}
+        void Log(GameEngine::LogLevel, const std::string_view) noexcept override {}
+        void Log(GameEngine::LogLevel, const std::stringstream&) noexcept override {}
+        void Log(GameEngine::LogLevel, const std::string_view, const std::string_view) noexcept override {}
+    };
+
+    std::vector<std::unique_ptr<GameEngine::ILogChannel>> g_channels;
+    std::shared_ptr<GameEngine::ILogger> g_globalLogger = std::make_shared<DummyLogger>();
+    std::recursive_mutex g_logLock;
+    // channels don't flush every line on the async writer thread: it flushes per batch
+    thread_local bool t_isAsyncLogWriter = false;
+
+    // sequential ids of the threads logging messages
+    std::atomic<uint32_t> g_nextLogThreadId = 0;
+    thread_local const uint32_t t_logThreadId = g_nextLogThreadId.fetch_add(1, std::memory_order_relaxed);
+
+    // Channel keeping the records of every thread on its own: it gets them on the logging thread,
+    // without the log lock and before the async queue, instead of Log()/LogBinary()
+    struct IThreadLogChannel : GameEngine::ILogChannel
+    {
+        virtual void LogOnThread(std::chrono::system_clock::time_point timestamp, GameEngine::LogLevel level, const std::string_view prefix, const std::string_view message) noexcept = 0;
+        virtual void LogOnThread(const GameEngine::LogSite& site, uint32_t prefixId, std::chrono::steady_clock::time_point timestamp, std::span<const std::byte> args) noexcept = 0;
+    };
+
+    void WriteToChannels(std::chrono::system_clock::time_point timestamp, GameEngine::LogLevel level, const std::string_view prefix, const std::string_view message)
+    {
+        const std::scoped_lock lock(g_logLock);
+        for (auto& channel : g_channels)
+        {
+            channel->Log(timestamp, level, prefix, message);
+        }
+    }
+
+    // Log categories, entries never move: Logable classes keep pointers to the levels,
+    // LOG_FMT records refer to the names by id
+    struct LogCategory
+    {
+        LogCategory(const std::string_view name, uint32_t id)
+            : name(name)
+            , id(id)
+            , level(GameEngine::g_logLevel.load())
+        {
+        }
+
+        const std::string name;
+        const uint32_t id; // index + 1, 0 - no prefix
+        std::atomic<GameEngine::LogLevel> level;
+        bool hasOwnLevel = false; // otherwise follows the global level
+    };
+    std::deque<LogCategory> g_logCategories;
+
+    // expects g_logLock
+    LogCategory& GetLogCategory(const std::string_view name)
+    {
+        const auto found = std::find_if(g_logCategories.begin(), g_logCategories.end(), [&](const auto& category) { return category.name == name; });
+        return found != g_logCategories.end() ? *found : g_logCategories.emplace_back(name, static_cast<uint32_t>(g_logCategories.size() + 1));
+    }
+
+    // expects g_logLock
+    std::string_view GetLogPrefix(uint32_t prefixId)
+    {
+        return prefixId && prefixId <= g_logCategories.size() ? std::string_view{ g_logCategories[prefixId - 1].name } : std::string_view{};
+    }
+
+    // expects g_logLock
+    void SetGlobalLogLevel(GameEngine::LogLevel level)
+    {
+        GameEngine::g_logLevel = level;
+        for (auto& category : g_logCategories)
+        {
+            if (!category.hasOwnLevel)
+            {
+                category.level = level;
+            }
+        }
+    }
+
+    // LOG_FMT sites
+    std::atomic<uint32_t> g_nextLogSiteId = 0;
+    // maps steady clock of LOG_FMT records to the wall time
+    const auto g_systemAnchor = std::chrono::system_clock::now();
+    const auto g_steadyAnchor = std::chrono::steady_clock::now();
+
+    void WriteToChannels(const GameEngine::LogSite& site, uint32_t prefixId, std::chrono::steady_clock::time_point timestamp, std::span<const std::byte> args)
+    {
+        const std::scoped_lock lock(g_logLock);
+        const GameEngine::LogRecord record{ site, timestamp, args, prefixId, GetLogPrefix(prefixId) };
+        for (auto& channel : g_channels)
+        {
+            channel->LogBinary(record);
+        }
+    }
+
+    std::chrono::system_clock::time_point ToSystemTime(std::chrono::steady_clock::time_point timestamp)
+    {
+        return g_systemAnchor + std::chrono::duration_cast<std::chrono::system_clock::duration>(timestamp - g_steadyAnchor);
+    }
+
+    void NotifyIdle()
+    {
+        const std::scoped_lock lock(g_logLock);
+        for (auto& channel : g_channels)
+        {
+            channel->OnIdle();
+        }
+    }
+
+    // Bounded lock-free multi-producer single-consumer queue (D. Vyukov's algorithm):
+    // every slot has a sequence number telling whether it is free for the producer at given position
+    // or ready for the consumer
+    class AsyncLogWriter
+    {
+    public:
+        AsyncLogWriter(const GameEngine::AsyncLogConfig& config)
+            : m_slots(std::bit_ceil(std::max<size_t>(config.queueSize, 2)))
+            , m_mask(m_slots.size() - 1)
+            , m_policy(config.overflowPolicy)
+        {
+            for (size_t i = 0; i < m_slots.size(); ++i)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            m_thread = std::thread([this] { Run(); });
+        }
+
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+        ~AsyncLogWriter()
+        {
+            {
+                const std::scoped_lock lock(m_waitLock);
+                m_stopping = true;
+            }
+            m_wakeUp.notify_one();
+            m_thread.join();
+        }
+
+        void Push(std::chrono::system_clock::time_point timestamp, GameEngine::LogLevel level, const std::string_view prefix, const std::string_view message)
+        {
+            size_t pos = 0;
+            auto* slot = Acquire(level, pos);
+            if (!slot)
+            {
+                return;
+            }
+            slot->site = nullptr;
+            slot->thread = t_logThreadId;
+            slot->timestamp = timestamp;
+            slot->level = level;
+            // prefix is copied as well: the logger owning it may be gone before the message is written
+            slot->prefixSize = prefix.size();
+            slot->size = prefix.size() + message.size();
+            if (slot->size <= Slot::InlineSize)
+            {
+                std::memcpy(slot->inlineText, prefix.data(), prefix.size());
+                std::memcpy(slot->inlineText + prefix.size(), message.data(), message.size());
+            }
+            else
+            {
+                // long messages spill to the heap, the capacity is reused by next ones
+                slot->longText.assign(prefix).append(message);
+            }
+            slot->sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        void Push(const GameEngine::LogSite& site, uint32_t prefixId, std::chrono::steady_clock::time_point timestamp, std::span<const std::byte> args)
+        {
+            static_assert(GameEngine::BinaryLog::ArgsBuffer::Capacity <= Slot::InlineSize);
+            size_t pos = 0;
+            auto* slot = Acquire(site.level, pos);
+            if (!slot)
+            {
+                return;
+            }
+            slot->site = &site;
+            slot->thread = t_logThreadId;
+            slot->steadyTimestamp = timestamp;
+            slot->level = site.level;
+            slot->prefixId = prefixId;
+            slot->size = args.size();
+            std::memcpy(slot->inlineText, args.data(), args.size());
+            slot->sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        void Flush()
+        {
+            const auto target = m_enqueuePos.load(std::memory_order_acquire);
+            std::unique_lock lock(m_waitLock);
+            m_flushRequested = true;
+            m_wakeUp.notify_one();
+            m_written.wait(lock, [&] { return m_writtenPos >= target; });
+        }
+
+        size_t GetDropped() const
+        {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+        // For fatal signal handlers: the writer thread writes the messages queued so far and flushes the channels.
+        // Only atomics, clock_gettime and sched_yield are used, so it is async-signal-safe. The wait is bounded:
+        // the writer may be waiting for the log lock held by the crashed thread
+        bool DrainFromSignal(std::chrono::steady_clock::duration timeout) noexcept
+        {
+            const auto target = m_enqueuePos.load(std::memory_order_acquire);
+            m_drainRequestPos.store(target, std::memory_order_release);
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (m_drainedPos.load(std::memory_order_acquire) < target)
+            {
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+            return true;
+        }
+
+    private:
+        struct Slot
+        {
+            static constexpr size_t InlineSize = 200;
+
+            std::atomic<size_t> sequence;
+            const GameEngine::LogSite* site; // LOG_FMT record with encoded arguments if set
+            uint32_t thread;
+            std::chrono::system_clock::time_point timestamp;
+            std::chrono::steady_clock::time_point steadyTimestamp;
+            GameEngine::LogLevel level;
+            uint32_t prefixId; // of a LOG_FMT record, the text keeps the prefix otherwise
+            size_t prefixSize;
+            size_t size;
+            char inlineText[InlineSize];
+            std::string longText;
+
+            std::string_view GetText() const
+            {
+                return size <= InlineSize ? std::string_view{ inlineText, size } : std::string_view{ longText };
+            }
+        };
+
+        static constexpr size_t MaxBatchSize = 256;
+        static constexpr auto IdleWait = std::chrono::milliseconds(5);
+
+        // reserves a slot at pos, nullptr if the message is dropped
+        Slot* Acquire(GameEngine::LogLevel level, size_t& pos)
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto& candidate = m_slots[pos & m_mask];
+                const auto seq = candidate.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0)
+                {
+                    if (ShouldDrop(pos, level, false))
+                    {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        return &candidate;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // full
+                    if (ShouldDrop(pos, level, true))
+                    {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    std::this_thread::yield();
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool ShouldDrop(size_t pos, GameEngine::LogLevel level, bool isFull) const
+        {
+            using GameEngine::LogLevel;
+            using GameEngine::LogOverflowPolicy;
+            switch (m_policy)
+            {
+                case LogOverflowPolicy::BLOCK:
+                    return false;
+                case LogOverflowPolicy::DROP:
+                    return isFull;
+                case LogOverflowPolicy::DROP_LOWEST_LEVEL:
+                {
+                    if (level <= LogLevel::INFO)
+                    {
+                        return false;
+                    }
+                    // keep the last quarter of the queue for important messages
+                    const auto used = pos - m_dequeuePos.load(std::memory_order_relaxed);
+                    return isFull || used >= m_slots.size() - m_slots.size() / 4;
+                }
+            }
+            return false;
+        }
+
+        // returns number of messages written
+        size_t WriteBatch()
+        {
+            size_t count = 0;
+            auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+            {
+                const std::scoped_lock lock(g_logLock);
+                for (; count < MaxBatchSize; ++count, ++pos)
+                {
+                    auto& slot = m_slots[pos & m_mask];
+                    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+                    {
+                        break;
+                    }
+                    if (slot.site)
+                    {
+                        const std::span args{ reinterpret_cast<const std::byte*>(slot.inlineText), slot.size };
+                        WriteToChannels(*slot.site, slot.prefixId, slot.steadyTimestamp, args);
+                    }
+                    else
+                    {
+                        const auto text = slot.GetText();
+                        WriteToChannels(slot.timestamp, slot.level, text.substr(0, slot.prefixSize), text.substr(slot.prefixSize));
+                    }
+                    slot.sequence.store(pos + m_slots.size(), std::memory_order_release);
+                    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+                }
+                if (count)
+                {
+                    for (auto& channel : g_channels)
+                    {
+                        channel->OnBatchWritten();
+                    }
+                }
+            }
+            if (count)
+            {
+                const std::scoped_lock lock(m_waitLock);
+                m_writtenPos = pos;
+                m_written.notify_all();
+            }
+            return count;
+        }
+
+        // the signal handler can't notify, the request is seen at the latest after IdleWait
+        void DrainIfRequested()
+        {
+            const auto requested = m_drainRequestPos.load(std::memory_order_acquire);
+            if (requested <= m_drainedPos.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            const auto written = m_dequeuePos.load(std::memory_order_relaxed);
+            {
+                const std::scoped_lock lock(g_logLock);
+                for (auto& channel : g_channels)
+                {
+                    channel->Flush();
+                }
+            }
+            m_drainedPos.store(written, std::memory_order_release);
+        }
+
+        void Run()
+        {
+            t_isAsyncLogWriter = true;
+            while (true)
+            {
+                if (WriteBatch())
+                {
+                    continue;
+                }
+                DrainIfRequested();
+                std::unique_lock lock(m_waitLock);
+                if (m_stopping)
+                {
+                    lock.unlock();
+                    // messages published right before the stop
+                    while (WriteBatch()) {}
+                    break;
+                }
+                if (m_flushRequested)
+                {
+                    // nothing is ready yet: messages are still being published
+                    m_flushRequested = false;
+                    lock.unlock();
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (m_wakeUp.wait_for(lock, IdleWait) == std::cv_status::timeout)
+                {
+                    lock.unlock();
+                    NotifyIdle();
+                }
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        const size_t m_mask;
+        const GameEngine::LogOverflowPolicy m_policy;
+        alignas(64) std::atomic<size_t> m_enqueuePos = 0;
+        alignas(64) std::atomic<size_t> m_dequeuePos = 0;
+        std::atomic<size_t> m_dropped = 0;
+        // set by a fatal signal handler, waiting until the writer has written and flushed the messages before it
+        std::atomic<size_t> m_drainRequestPos = 0;
+        std::atomic<size_t> m_drainedPos = 0;
+
+        // the writer thread sleeps while the queue is empty, producers never touch the lock
+        std::mutex m_waitLock;
+        std::condition_variable m_wakeUp;
+        std::condition_variable m_written;
+        size_t m_writtenPos = 0;
+        bool m_flushRequested = false;
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+
+    // Targets used by the logging threads without the log lock: the async writer and the thread channel.
+    // Setting and resetting them is serialized by g_logTargetsLock, producers only read the pointers
+    std::mutex g_logTargetsLock;
+    std::unique_ptr<AsyncLogWriter> g_asyncWriterOwner;
+    std::atomic<AsyncLogWriter*> g_asyncWriter = nullptr;
+    std::atomic<IThreadLogChannel*> g_threadChannel = nullptr; // owned by g_channels
+    // threads using the targets: a target is destroyed once they are gone
+    std::atomic<uint32_t> g_logTargetUsers = 0;
+    std::terminate_handler g_prevTerminateHandler = nullptr;
+
+    // pins the current targets, if any, for the scope
+    class LogTargetsRef
+    {
+    public:
+        LogTargetsRef()
+        {
+            // seq_cst pairs with WaitLogTargetUsers(): either a target is seen as gone or the user is counted
+            g_logTargetUsers.fetch_add(1);
+            m_writer = g_asyncWriter.load();
+            m_threadChannel = g_threadChannel.load();
+        }
+
+        LogTargetsRef(const LogTargetsRef&) = delete;
+        LogTargetsRef& operator=(const LogTargetsRef&) = delete;
+
+        ~LogTargetsRef()
+        {
+            g_logTargetUsers.fetch_sub(1, std::memory_order_release);
+        }
+
+        AsyncLogWriter* GetAsyncWriter() const
+        {
+            return m_writer;
+        }
+
+        IThreadLogChannel* GetThreadChannel() const
+        {
+            return m_threadChannel;
+        }
+
+    private:
+        AsyncLogWriter* m_writer = nullptr;
+        IThreadLogChannel* m_threadChannel = nullptr;
+    };
+
+    // a target has been reset: producers which have seen it are still using it
+    void WaitLogTargetUsers()
+    {
+        while (g_logTargetUsers.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // g_logTargetsLock is held
+    void StopAsyncWriter()
+    {
+        g_asyncWriter.store(nullptr);
+        WaitLogTargetUsers();
+        // the destructor writes the rest of the queue
+        g_asyncWriterOwner.reset();
+    }
+
+    // before the channel is destroyed
+    void StopThreadChannel()
+    {
+        const std::scoped_lock lock(g_logTargetsLock);
+        g_threadChannel.store(nullptr);
+        WaitLogTargetUsers();
+    }
+
+    // messages queued before a fatal signal, the handler returns with false on timeout
+    bool DrainAsyncWriterFromSignal(std::chrono::steady_clock::duration timeout) noexcept
+    {
+        if (t_isAsyncLogWriter)
+        {
+            // crashed on the writer thread
+            return false;
+        }
+        const LogTargetsRef targets;
+        auto* writer = targets.GetAsyncWriter();
+        return !writer || writer->DrainFromSignal(timeout);
+    }
+
+    void Log(GameEngine::LogLevel level, const std::string_view prefix, const std::string_view message) noexcept
+    {
+        try
+        {
+            // the level is checked by the callers: against the global level or the category of a prefix logger
+            const auto timestamp = std::chrono::system_clock::now();
+            const LogTargetsRef targets;
+            if (auto* channel = targets.GetThreadChannel())
+            {
+                channel->LogOnThread(timestamp, level, prefix, message);
+            }
+            if (auto* writer = targets.GetAsyncWriter())
+            {
+                writer->Push(timestamp, level, prefix, message);
+                return;
+            }
+
+            WriteToChannels(timestamp, level, prefix, message);
+        }
+        catch (...)
+        {
+            std::cerr << "Log failed" << std::endl; 
+        }
+    }
+
+    void LogFormattedRecord(const GameEngine::LogSite& site, uint32_t prefixId, std::span<const std::byte> args) noexcept
+    {
+        try
+        {
+            const auto timestamp = std::chrono::steady_clock::now();
+            const LogTargetsRef targets;
+            if (auto* channel = targets.GetThreadChannel())
+            {
+                channel->LogOnThread(site, prefixId, timestamp, args);
+            }
+            if (auto* writer = targets.GetAsyncWriter())
+            {
+                writer->Push(site, prefixId, timestamp, args);
+                return;
+            }
+
+            WriteToChannels(site, prefixId, timestamp, args);
+        }
+        catch (...)
+        {
+            std::cerr << "Log failed" << std::endl;
+        }
+    }
+
+    void OnTerminate()
+    {
+        // don't lose the messages explaining the crash
+        if (!t_isAsyncLogWriter)
+        {
+            GameEngine::FlushLogger();
+        }
+        if (g_prevTerminateHandler)
+        {
+            g_prevTerminateHandler();
+        }
+        std::abort();
+    }
+} // namespace
+
+namespace GameEngine
+{
+    std::atomic<LogLevel> g_logLevel = LogLevel::DEBUG;
+
+    LogSite::LogSite(LogLevel level, const char* file, unsigned int line, const char* format)
+        : id(::g_nextLogSiteId.fetch_add(1, std::memory_order_relaxed))
+        , level(level)
+        , file(file)
+        , line(line)
+        , format(format)
+    {
+    }
+
+    void ILogChannel::LogBinary(const LogRecord& record) noexcept
+    {
+        try
+        {
+            Log(::ToSystemTime(record.timestamp), record.site.level, record.prefix, BinaryLog::FormatMessage(record.site.format, record.args));
+        }
+        catch (...)
+        {
+            std::cerr << "ILogChannel::LogBinary failed" << std::endl;
+        }
+    }
+
+    void LogSiteRecord(const LogSite& site, uint32_t prefixId, std::span<const std::byte> args) noexcept
+    {
+        ::LogFormattedRecord(site, prefixId, args);
+    }
+
+    LogStreamBuffer::int_type LogStreamBuffer::overflow(int_type ch)
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            return traits_type::not_eof(ch);
+        }
+        grow(GetView().size() + 1);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    std::streamsize LogStreamBuffer::xsputn(const char* s, std::streamsize n)
+    {
+        if (epptr() - pptr() < n)
+        {
+            grow(GetView().size() + n);
+        }
+        std::memcpy(pptr(), s, n);
+        pbump(static_cast<int>(n));
+        return n;
+    }
+
+    void LogStreamBuffer::grow(size_t required)
+    {
+        const auto used = GetView().size();
+        std::string bigger(std::max(required, 2 * static_cast<size_t>(epptr() - pbase())), '\0');
+        std::memcpy(bigger.data(), pbase(), used);
+        m_spill.swap(bigger);
+        setp(m_spill.data(), m_spill.data() + m_spill.size());
+        pbump(static_cast<int>(used));
+    }
+
+    // Formats "mmdd-HH:MM:SS.mmm" timestamps: the calendar part is recomputed once per second,
+    // otherwise only the milliseconds are patched
+    class TimestampCache
+    {
+    public:
+        std::string_view Format(std::chrono::system_clock::time_point timestamp)
+        {
+            const auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(timestamp).time_since_epoch().count();
+            const auto second = static_cast<std::time_t>(ms / 1000);
+            if (second != m_second)
+            {
+                std::tm tm;
+#ifdef WIN32
+                localtime_s(&tm, &second);
+#else
+                localtime_r(&second, &tm);
+#endif
+                std::strftime(m_text, sizeof(m_text), "%m%d-%H:%M:%S", &tm);
+                m_text[SecondsSize] = '.';
+                m_second = second;
+            }
+            const auto millis = static_cast<int>(ms % 1000);
+            m_text[SecondsSize + 1] = static_cast<char>('0' + millis / 100);
+            m_text[SecondsSize + 2] = static_cast<char>('0' + millis / 10 % 10);
+            m_text[SecondsSize + 3] = static_cast<char>('0' + millis % 10);
+            return { m_text, SecondsSize + 4 };
+        }
+
+    private:
+        static constexpr size_t SecondsSize = 13; // "mmdd-HH:MM:SS"
+
+        std::time_t m_second = -1;
+        char m_text[SecondsSize + 8] = {};
+    };
+
+    // returns number of characters written
+    static size_t LogToStream(std::ostream& stream, TimestampCache& timestampCache, std::chrono::system_clock::time_point timestamp,
+                              LogLevel level, const std::string_view prefix, const std::string_view message)
+    {
+        const auto time = timestampCache.Format(timestamp);
+        const std::string_view tag = ::LogLevelTags[static_cast<int>(level)];
+        stream << time << " [" << tag << "] ";
+        size_t size = time.size() + tag.size() + 4;
+        if (!prefix.empty())
+        {
+            stream << prefix << ' ';
+            size += prefix.size() + 1;
+        }
+        stream << message;
+        size += message.size();
+
+        if (message.empty() || (message.back() != '\n' && message.back() != '\r'))
+        {
+            stream << '\n';
+            ++size;
+        }
+        return size;
+    }
+
+    class FileLogChannel final : public ILogChannel
+    {
+    public:
+        explicit FileLogChannel(const fs::path& filename, const FileLogConfig& config)
+            : m_config(config)
+            , m_filePath(filename)
+            , m_buffer(config.bufferBytes)
+        {
+            if (m_config.maxLogFileBytes <= 0)
+            {
+                throw std::runtime_error("FileLogChannel expects maxLogFileBytes > 0");
+            }
+            if (!Initialize())
+            {
+                throw std::runtime_error("FileLogChannel Initialize() failed");
+            }
+        }
+
+        void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept override
+        {
+            try
+            {
+                if (!m_file.is_open() && !Initialize())
+                {
+                    std::cerr << "FileLogChannel '" << m_filePath << "' open failed" << std::endl;
+                    return;
+                }
+
+                if (m_file.fail() || m_file.bad())
+                {
+                    // restore stream when e.g. disk full on last write
+                    m_file.clear();
+                }
+
+                m_fileBytes += LogToStream(m_file, m_timestampCache, timestamp, level, prefix, message);
+                m_hasUnflushed = true;
+
+                if (m_config.bufferBytes == 0 || (m_config.flushOnError && level == LogLevel::ERROR) || IsFlushTime(timestamp))
+                {
+                    Flush();
+                }
+
+                // counted instead of tellp(): it seeks the file and flushes the buffer
+                if (m_fileBytes > m_config.maxLogFileBytes)
+                {
+                    m_file.close();
+                }
+            }
+            catch (...)
+            {  
+                std::cerr << "FileLogChannel::Log failed" << std::endl;
+            }
+        }
+
+        void Flush() noexcept override
+        {
+            try
+            {
+                if (m_file.is_open())
+                {
+                    m_file.flush();
+                }
+                m_lastFlush = std::chrono::system_clock::now();
+                m_hasUnflushed = false;
+            }
+            catch (...)
+            {
+                std::cerr << "FileLogChannel::Flush failed" << std::endl;
+            }
+        }
+
+        void OnBatchWritten() noexcept override
+        {
+            // the buffer is written out by the flush policy
+        }
+
+        void OnIdle() noexcept override
+        {
+            // the last messages don't wait for the next one
+            if (m_hasUnflushed && IsFlushTime(std::chrono::system_clock::now()))
+            {
+                Flush();
+            }
+        }
+
+    private:
+        bool IsFlushTime(std::chrono::system_clock::time_point timestamp) const
+        {
+            return m_config.flushInterval.count() > 0 && timestamp - m_lastFlush >= m_config.flushInterval;
+        }
+
+        fs::path GetGenerationPath(size_t generation) const
+        {
+            auto path = fs::path(m_filePath).concat(".bak");
+            return generation == 0 ? path : path.concat('.' + std::to_string(generation));
+        }
+
+        bool Initialize()
+        {
+            // name.bak.(N-2) -> name.bak.(N-1), ..., name.bak -> name.bak.1, name -> name.bak
+            std::error_code ec;
+            for (auto generation = m_config.generations; generation > 1; --generation)
+            {
+                fs::rename(GetGenerationPath(generation - 2), GetGenerationPath(generation - 1), ec);
+            }
+            if (m_config.generations > 0)
+            {
+                fs::rename(m_filePath, GetGenerationPath(0), ec);
+            }
+            if (!m_buffer.empty())
+            {
+                // must be set before opening
+                m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+            }
+            m_file.open(m_filePath, std::ios::out | std::ios::trunc);
+            m_fileBytes = 0;
+            m_lastFlush = std::chrono::system_clock::now();
+            return m_file.is_open();
+        }
+
+        const FileLogConfig m_config;
+        const fs::path m_filePath;
+        std::vector<char> m_buffer;
+        std::ofstream m_file;
+        size_t m_fileBytes = 0;
+        TimestampCache m_timestampCache;
+        std::chrono::system_clock::time_point m_lastFlush;
+        bool m_hasUnflushed = false;
+    };
+
+    class StdoutLogChannel final : public ILogChannel
+    {
+    public:
+        void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept override
+        {
+            try
+            {
+                LogToStream(std::cout, m_timestampCache, timestamp, level, prefix, message);
+                // the async writer flushes once per batch
+                if (!::t_isAsyncLogWriter)
+                {
+                    std::cout.flush();
+                }
+            }
+            catch (...)
+            {
+                std::cerr << "StdoutLogChannel::LogToStream failed" << std::endl;
+            }
+        }
+
+        void Flush() noexcept override
+        {
+            try
+            {
+                std::cout.flush();
+            }
+            catch (...)
+            {
+                std::cerr << "StdoutLogChannel::Flush failed" << std::endl;
+            }
+        }
+
+    private:
+        TimestampCache m_timestampCache;
+    };
+
+    class BinaryLogChannel final : public ILogChannel
+    {
+    public:
+        explicit BinaryLogChannel(const fs::path& filename, size_t maxLogFileBytes)
+            : m_maxLogFileBytes(maxLogFileBytes)
+            , m_filePath(filename)
+            , m_bakFilePath(fs::path(filename).concat(".bak"))
+        {
+            if (m_maxLogFileBytes <= 0)
+            {
+                throw std::runtime_error("BinaryLogChannel expects m_maxLogFileBytes > 0");
+            }
+            if (!Initialize())
+            {
+                throw std::runtime_error("BinaryLogChannel Initialize() failed");
+            }
+        }
+
+        void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept override
+        {
+            try
+            {
+                if (!Prepare())
+                {
+                    return;
+                }
+                Put(BinaryLog::RecordKind::TEXT);
+                Put(ToNanoseconds(timestamp));
+                Put(static_cast<uint8_t>(level));
+                PutString(prefix);
+                Put(static_cast<uint32_t>(message.size()));
+                Write(message.data(), message.size());
+                Finish();
+            }
+            catch (...)
+            {
+                std::cerr << "BinaryLogChannel::Log failed" << std::endl;
+            }
+        }
+
+        void LogBinary(const LogRecord& record) noexcept override
+        {
+            try
+            {
+                if (!Prepare())
+                {
+                    return;
+                }
+                const auto& site = record.site;
+                // site table is written lazily: once per file, before the first record of the site
+                if (site.id >= m_writtenSites.size())
+                {
+                    m_writtenSites.resize(site.id + 1);
+                }
+                if (!m_writtenSites[site.id])
+                {
+                    m_writtenSites[site.id] = true;
+                    Put(BinaryLog::RecordKind::SITE);
+                    Put(site.id);
+                    Put(static_cast<uint8_t>(site.level));
+                    Put(static_cast<uint32_t>(site.line));
+                    PutString(site.file);
+                    PutString(site.format);
+                }
+                // as are the prefixes
+                if (record.prefixId >= m_writtenPrefixes.size())
+                {
+                    m_writtenPrefixes.resize(record.prefixId + 1);
+                }
+                if (record.prefixId && !m_writtenPrefixes[record.prefixId])
+                {
+                    m_writtenPrefixes[record.prefixId] = true;
+                    Put(BinaryLog::RecordKind::PREFIX);
+                    Put(record.prefixId);
+                    PutString(record.prefix);
+                }
+                // the record is assembled to be written at once
+                const auto kind = BinaryLog::RecordKind::RECORD;
+                const auto timestamp = ToNanoseconds(record.timestamp);
+                const auto size = static_cast<uint16_t>(record.args.size());
+                std::array<char, sizeof(kind) + sizeof(site.id) + sizeof(record.prefixId) + sizeof(timestamp) + sizeof(size) + BinaryLog::ArgsBuffer::Capacity> buffer;
+                auto* out = buffer.data();
+                for (const auto& [data, bytes] : { std::pair<const void*, size_t>{ &kind, sizeof(kind) },
+                                                   { &site.id, sizeof(site.id) },
+                                                   { &record.prefixId, sizeof(record.prefixId) },
+                                                   { &timestamp, sizeof(timestamp) },
+                                                   { &size, sizeof(size) },
+                                                   { record.args.data(), size } })
+                {
+                    std::memcpy(out, data, bytes);
+                    out += bytes;
+                }
+                Write(buffer.data(), out - buffer.data());
+                Finish();
+            }
+            catch (...)
+            {
+                std::cerr << "BinaryLogChannel::LogBinary failed" << std::endl;
+            }
+        }
+
+        void Flush() noexcept override
+        {
+            try
+            {
+                if (m_file.is_open())
+                {
+                    m_file.flush();
+                }
+            }
+            catch (...)
+            {
+                std::cerr << "BinaryLogChannel::Flush failed" << std::endl;
+            }
+        }
+
+    private:
+        template <typename Clock>
+        static int64_t ToNanoseconds(std::chrono::time_point<Clock> timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        template <typename V>
+        void Put(const V& value)
+        {
+            Write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void PutString(const std::string_view str)
+        {
+            const auto size = static_cast<uint16_t>(std::min<size_t>(str.size(), UINT16_MAX));
+            Put(size);
+            Write(str.data(), size);
+        }
+
+        void Write(const char* data, size_t size)
+        {
+            // streambuf is used directly: the stream's sentry per write costs more than copying the record
+            m_file.rdbuf()->sputn(data, size);
+            m_fileBytes += size;
+        }
+
+        bool Initialize()
+        {
+            std::error_code ec;
+            fs::rename(m_filePath, m_bakFilePath, ec);
+            m_file.open(m_filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+            if (!m_file.is_open())
+            {
+                return false;
+            }
+            m_writtenSites.clear();
+            m_writtenPrefixes.clear();
+            m_fileBytes = 0;
+            Write(BinaryLog::Magic.data(), BinaryLog::Magic.size());
+            Put(BinaryLog::Version);
+            Put(BinaryLog::RecordKind::ANCHOR);
+            Put(ToNanoseconds(std::chrono::system_clock::now()));
+            Put(ToNanoseconds(std::chrono::steady_clock::now()));
+            return true;
+        }
+
+        bool Prepare()
+        {
+            if (!m_file.is_open() && !Initialize())
+            {
+                std::cerr << "BinaryLogChannel '" << m_filePath << "' open failed" << std::endl;
+                return false;
+            }
+            if (m_file.fail() || m_file.bad())
+            {
+                // restore stream when e.g. disk full on last write
+                m_file.clear();
+            }
+            return true;
+        }
+
+        void Finish()
+        {
+            // counted instead of tellp(): it seeks the file
+            if (m_fileBytes > m_maxLogFileBytes)
+            {
+                m_file.close();
+            }
+        }
+
+        const size_t m_maxLogFileBytes;
+        const fs::path m_filePath;
+        const fs::path m_bakFilePath;
+        std::ofstream m_file;
+        size_t m_fileBytes = 0;
+        std::vector<bool> m_writtenSites;
+        std::vector<bool> m_writtenPrefixes;
+    };
+
+    int OpenForAppend(const fs::path& path)
+    {
+#ifdef WIN32
+        return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+    }
+
+    // async-signal-safe
+    void WriteAll(int fd, const char* data, size_t size) noexcept
+    {
+        while (size > 0)
+        {
+#ifdef WIN32
+            const auto written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+            const auto written = ::write(fd, data, size);
+#endif
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    void CloseFile(int fd)
+    {
+#ifdef WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    // Formats into a fixed buffer written out with write(): nothing that may allocate, lock or touch the locale,
+    // so it may run in a signal handler
+    class SignalSafeWriter
+    {
+    public:
+        explicit SignalSafeWriter(int fd)
+            : m_fd(fd)
+        {
+        }
+
+        SignalSafeWriter(const SignalSafeWriter&) = delete;
+        SignalSafeWriter& operator=(const SignalSafeWriter&) = delete;
+
+        ~SignalSafeWriter()
+        {
+            Flush();
+        }
+
+        SignalSafeWriter& operator<<(std::string_view text)
+        {
+            while (!text.empty())
+            {
+                if (m_size == sizeof(m_buffer))
+                {
+                    Flush();
+                }
+                const auto chunk = std::min(text.size(), sizeof(m_buffer) - m_size);
+                std::memcpy(m_buffer + m_size, text.data(), chunk);
+                m_size += chunk;
+                text.remove_prefix(chunk);
+            }
+            return *this;
+        }
+
+        SignalSafeWriter& operator<<(uint64_t value)
+        {
+            char digits[20];
+            size_t count = 0;
+            do
+            {
+                digits[sizeof(digits) - ++count] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value);
+            return *this << std::string_view{ digits + sizeof(digits) - count, count };
+        }
+
+        void Flush()
+        {
+            WriteAll(m_fd, m_buffer, m_size);
+            m_size = 0;
+        }
 
-    class DummyLogger : public GameEngine::ILogger
-    {
-        void Log(GameEngine::LogLevel, const char*) noexcept override {}
-        void Log(GameEngine::LogLevel, const std::string&) noexcept override {}
-        void Log(GameEngine::LogLevel, const std::string_view) noexcept override {}
-        void Log(GameEngine::LogLevel, const std::stringstream&) noexcept override {}
+    private:
+        const int m_fd;
+        char m_buffer[512];
+        size_t m_size = 0;
     };
 
-    std::vector<std::unique_ptr<GameEngine::ILogChannel>> g_channels;
-    std::shared_ptr<GameEngine::ILogger> g_globalLogger = std::make_shared<DummyLogger>();
-    GameEngine::LogLevel g_logLevel = GameEngine::LogLevel::DEBUG;
-    std::recursive_mutex g_logLock;
-
-    void Log(GameEngine::LogLevel level, const std::string_view message) noexcept
+    // Keeps the last records of every thread in memory only, they are written out merged by time
+    // on Flush() or when a fatal signal arrives. Records are truncated to fit a fixed size entry.
+    // Every thread writes its own ring without locks: the only shared write is the ring list, once per thread.
+    // The file is opened up front: the signal handler only formats into a stack buffer and calls write()
+    class CrashRingLogChannel final : public ::IThreadLogChannel
     {
-        try
+    public:
+        explicit CrashRingLogChannel(const fs::path& filename, size_t recordsPerThread)
+            : m_filePath(filename)
+            , m_recordsPerThread(recordsPerThread)
         {
-            const auto timestamp = std::chrono::system_clock::now();
-
-            const std::scoped_lock lock(g_logLock);
-            if (g_logLevel < level)
+            if (m_recordsPerThread <= 0)
             {
-                return;
+                throw std::runtime_error("CrashRingLogChannel expects recordsPerThread > 0");
+            }
+            m_fd = OpenForAppend(m_filePath);
+            if (m_fd < 0)
+            {
+                throw std::runtime_error("CrashRingLogChannel open failed");
             }
+            // the channel created last dumps on a fatal signal
+            s_signalTarget.store(this, std::memory_order_release);
+            InstallSignalHandlers();
+        }
 
-            for (auto& channel : g_channels)
+        ~CrashRingLogChannel() override
+        {
+            auto* self = this;
+            s_signalTarget.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+            CloseFile(m_fd);
+            for (auto* ring = m_rings.load(std::memory_order_acquire); ring;)
             {
-                channel->Log(timestamp, level, message);
+                delete std::exchange(ring, ring->next);
             }
         }
-        catch (...)
+
+        // the records come through LogOnThread()
+        void Log(std::chrono::system_clock::time_point, LogLevel, const std::string_view, const std::string_view) noexcept override {}
+        void LogBinary(const LogRecord&) noexcept override {}
+
+        void LogOnThread(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept override
         {
-            std::cerr << "Log failed" << std::endl; 
+            try
+            {
+                Write([&](Entry& entry) {
+                    entry.timestamp = timestamp;
+                    entry.site = nullptr;
+                    entry.prefixId = 0;
+                    entry.level = level;
+                    entry.prefixSize = static_cast<uint16_t>(std::min(prefix.size(), Entry::TextCapacity));
+                    entry.size = static_cast<uint16_t>(std::min(prefix.size() + message.size(), Entry::TextCapacity));
+                    std::memcpy(entry.text, prefix.data(), entry.prefixSize);
+                    std::memcpy(entry.text + entry.prefixSize, message.data(), entry.size - entry.prefixSize);
+                });
+            }
+            catch (...)
+            {
+                std::cerr << "CrashRingLogChannel::Log failed" << std::endl;
+            }
         }
-    }
-} // namespace
 
-namespace GameEngine
-{
-    static void LogToStream(std::ostream& stream, std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view message)
-    {
-        std::time_t t = std::chrono::system_clock::to_time_t(timestamp);
-        std::tm tm;
-#ifdef WIN32
-        localtime_s(&tm, &t);
-#else
-        localtime_r(&t, &tm);
-#endif
-        
-        stream
-            << std::put_time<char>(&tm, "%m%d-%H:%M:%S") << '.' << std::setw(3) << std::setfill('0')
-            << (std::chrono::time_point_cast<std::chrono::milliseconds>(timestamp).time_since_epoch()).count() % 1000
-            << " [" << ::LogLevelTags[static_cast<int>(level)] << "] " << message;
+        void LogOnThread(const LogSite& site, uint32_t prefixId, std::chrono::steady_clock::time_point timestamp, std::span<const std::byte> args) noexcept override
+        {
+            static_assert(BinaryLog::ArgsBuffer::Capacity <= Entry::TextCapacity);
+            try
+            {
+                // formatting is left to the dump, as is resolving the prefix
+                Write([&](Entry& entry) {
+                    entry.timestamp = ::ToSystemTime(timestamp);
+                    entry.site = &site;
+                    entry.prefixId = prefixId;
+                    entry.level = site.level;
+                    entry.prefixSize = 0;
+                    entry.size = static_cast<uint16_t>(args.size());
+                    std::memcpy(entry.text, args.data(), args.size());
+                });
+            }
+            catch (...)
+            {
+                std::cerr << "CrashRingLogChannel::LogBinary failed" << std::endl;
+            }
+        }
 
-        if (message.back() == '\n' || message.back() == '\r')
+        void Flush() noexcept override
         {
-            stream << std::flush;
+            try
+            {
+                Dump();
+            }
+            catch (...)
+            {
+                std::cerr << "CrashRingLogChannel::Dump failed" << std::endl;
+            }
         }
-        else
+
+        // dumping after every batch would defeat the purpose
+        void OnBatchWritten() noexcept override {}
+
+    private:
+        struct Entry
+        {
+            static constexpr size_t TextCapacity = 224;
+
+            std::chrono::system_clock::time_point timestamp;
+            const LogSite* site; // LOG_FMT record with encoded arguments if set
+            uint32_t prefixId; // of the LOG_FMT record, the text keeps the prefix otherwise
+            LogLevel level;
+            uint16_t prefixSize;
+            uint16_t size;
+            char text[TextCapacity];
+        };
+
+        // seqlock: odd while the owning thread writes the entry, 2 * (index + 1) once the record at index is written
+        struct Record
+        {
+            std::atomic<uint64_t> sequence = 0;
+            Entry entry;
+        };
+
+        // written by its thread only, read by the dumps
+        struct Ring
+        {
+            Ring(uint32_t thread, size_t size)
+                : thread(thread)
+                , records(size)
+            {
+            }
+
+            const uint32_t thread;
+            std::vector<Record> records;
+            std::atomic<uint64_t> written = 0; // records ever written
+            Ring* next = nullptr; // in the list of the channel, set before the ring is published
+            // dump cursor: records before are dumped already, [cursor, end) are being dumped
+            uint64_t dumped = 0;
+            uint64_t cursor = 0;
+            uint64_t end = 0;
+
+            Record& Get(uint64_t index)
+            {
+                return records[index % records.size()];
+            }
+        };
+
+        // ring of the calling thread, created on its first record
+        Ring& GetThreadRing()
         {
-            stream << std::endl;
+            thread_local struct
+            {
+                uint64_t channel = 0;
+                Ring* ring = nullptr;
+            } t_ring;
+            if (t_ring.channel != m_id)
+            {
+                auto* ring = new Ring(t_logThreadId, m_recordsPerThread);
+                ring->next = m_rings.load(std::memory_order_relaxed);
+                while (!m_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+                t_ring = { m_id, ring };
+            }
+            return *t_ring.ring;
         }
-    }
 
-    class FileLogChannel final : public ILogChannel
-    {
-    public:
-        explicit FileLogChannel(const fs::path& filename, size_t maxLogFileBytes)
-            : m_maxLogFileBytes(maxLogFileBytes)
-            , m_filePath(filename)
-            , m_bakFilePath(fs::path(filename).concat(".bak"))
+        template <typename Fill>
+        void Write(Fill&& fill)
+        {
+            auto& ring = GetThreadRing();
+            const auto index = ring.written.load(std::memory_order_relaxed);
+            auto& record = ring.Get(index);
+            record.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            fill(record.entry);
+            record.sequence.store(2 * (index + 1), std::memory_order_release);
+            ring.written.store(index + 1, std::memory_order_release);
+        }
 
+        // copies the record at index, false if it is being written or has been overwritten meanwhile
+        static bool Read(Ring& ring, uint64_t index, Entry& entry)
         {
-            if (m_maxLogFileBytes <= 0)
+            auto& record = ring.Get(index);
+            const auto sequence = record.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * (index + 1))
             {
-                throw std::runtime_error("FileLogChannel expects m_maxLogFileBytes > 0");
+                return false;
             }
-            if (!Initialize())
+            std::memcpy(&entry, &record.entry, sizeof(entry));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return record.sequence.load(std::memory_order_relaxed) == sequence;
+        }
+
+        // Takes the records written since the previous dump, returns their number
+        size_t BeginDump()
+        {
+            size_t total = 0;
+            for (auto* ring = m_rings.load(std::memory_order_acquire); ring; ring = ring->next)
             {
-                throw std::runtime_error("FileLogChannel Initialize() failed");
+                ring->end = ring->written.load(std::memory_order_acquire);
+                const auto size = ring->records.size();
+                ring->cursor = std::max(ring->dumped, ring->end > size ? ring->end - size : 0);
+                total += ring->end - ring->cursor;
             }
+            return total;
         }
 
-        void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view message) noexcept override
+        // Calls write(thread, entry) for the records taken by BeginDump(), the oldest first.
+        // Rings are merged in place (every ring is already ordered), nothing is allocated.
+        // Records overwritten by their threads meanwhile are skipped
+        template <typename WriteRecord>
+        void ForEachRecord(WriteRecord&& write)
         {
-            try
+            Entry entry;
+            while (true)
             {
-                if (!m_file.is_open() && !Initialize())
+                Ring* oldest = nullptr;
+                for (auto* ring = m_rings.load(std::memory_order_acquire); ring; ring = ring->next)
                 {
-                    std::cerr << "FileLogChannel '" << m_filePath << "' open failed" << std::endl;
-                    return;
+                    // a torn timestamp only affects the order: the record is checked when read
+                    if (ring->cursor < ring->end
+                        && (!oldest || ring->Get(ring->cursor).entry.timestamp < oldest->Get(oldest->cursor).entry.timestamp))
+                    {
+                        oldest = ring;
+                    }
                 }
-
-                if (m_file.fail() || m_file.bad())
+                if (!oldest)
                 {
-                    // restore stream when e.g. disk full on last write
-                    m_file.clear();
+                    break;
                 }
-
-                LogToStream(m_file, timestamp, level, message);
-
-                if (m_file.tellp() > m_maxLogFileBytes)
+                if (Read(*oldest, oldest->cursor++, entry))
                 {
-                    m_file.close();
+                    write(oldest->thread, entry);
                 }
             }
-            catch (...)
-            {  
-                std::cerr << "FileLogChannel::Log failed" << std::endl;
+            for (auto* ring = m_rings.load(std::memory_order_acquire); ring; ring = ring->next)
+            {
+                ring->dumped = ring->end;
             }
         }
 
-    private:
-        bool Initialize()
+        // appends the records to the file with local timestamps and formatted LOG_FMT messages.
+        // Called under the log lock: it keeps the prefixes
+        void Dump()
         {
-            std::error_code ec;
-            fs::rename(m_filePath, m_bakFilePath, ec);
-            m_file.open(m_filePath, std::ios::out | std::ios::trunc);
-            return m_file.is_open();
+            const auto total = BeginDump();
+            if (total == 0)
+            {
+                return;
+            }
+            std::string text = "==== crash ring dump (flush): " + std::to_string(total) + " records ====\n";
+            TimestampCache timestampCache;
+            ForEachRecord([&](uint32_t thread, const Entry& entry) {
+                text.append(timestampCache.Format(entry.timestamp)).append(" [")
+                    .append(::LogLevelTags[static_cast<int>(entry.level)]).append("] [thread ")
+                    .append(std::to_string(thread)).append("] ");
+                const auto size = std::min<size_t>(entry.size, Entry::TextCapacity);
+                std::string_view message{ entry.text, size };
+                if (entry.site)
+                {
+                    if (const auto prefix = ::GetLogPrefix(entry.prefixId); !prefix.empty())
+                    {
+                        text.append(prefix).append(1, ' ');
+                    }
+                    text.append(BinaryLog::FormatMessage(entry.site->format, std::as_bytes(std::span{ entry.text, size })));
+                    message = {};
+                }
+                else if (entry.prefixSize)
+                {
+                    const auto prefixSize = std::min<size_t>(entry.prefixSize, size);
+                    text.append(entry.text, prefixSize).append(1, ' ');
+                    message.remove_prefix(prefixSize);
+                }
+                text.append(message);
+                if (text.back() != '\n')
+                {
+                    text.append(1, '\n');
+                }
+            });
+            WriteAll(m_fd, text.data(), text.size());
         }
 
-        const size_t m_maxLogFileBytes;
-        const fs::path m_filePath;
-        const fs::path m_bakFilePath;
-        std::ofstream m_file;
-    };
+        // Best effort, the process is going down: threads may keep logging meanwhile, their overwritten records
+        // are skipped. Timestamps are written as milliseconds since the epoch (localtime isn't async-signal-safe),
+        // LOG_FMT records as their format string followed by the raw argument bytes count
+        void DumpFromSignal(int signal) noexcept
+        {
+            SignalSafeWriter writer(m_fd);
+            writer << "==== crash ring dump (signal " << static_cast<uint64_t>(signal) << "): "
+                   << static_cast<uint64_t>(BeginDump()) << " records ====\n";
+            ForEachRecord([&writer](uint32_t thread, const Entry& entry) {
+                const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(entry.timestamp.time_since_epoch()).count();
+                writer << static_cast<uint64_t>(ms) << " [" << ::LogLevelTags[static_cast<int>(entry.level)]
+                       << "] [thread " << static_cast<uint64_t>(thread) << "] ";
+                const auto size = std::min<size_t>(entry.size, Entry::TextCapacity);
+                if (entry.site)
+                {
+                    // names of the categories never move, a category being added is the only risk
+                    if (const auto prefix = ::GetLogPrefix(entry.prefixId); !prefix.empty())
+                    {
+                        writer << prefix << " ";
+                    }
+                    writer << entry.site->format << " (" << static_cast<uint64_t>(size) << " bytes of arguments)\n";
+                    return;
+                }
+                const auto prefixSize = std::min<size_t>(entry.prefixSize, size);
+                if (prefixSize)
+                {
+                    writer << std::string_view{ entry.text, prefixSize } << " ";
+                }
+                const std::string_view message{ entry.text + prefixSize, size - prefixSize };
+                writer << message;
+                if (message.empty() || message.back() != '\n')
+                {
+                    writer << "\n";
+                }
+            });
+        }
 
-    class StdoutLogChannel final : public ILogChannel
-    {
-    public:
-        void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view message) noexcept override
+        static void OnFatalSignal(int signal)
         {
-            try
-            {
-                LogToStream(std::cout, timestamp, level, message);
-            }
-            catch (...)
+            if (auto* channel = s_signalTarget.exchange(nullptr, std::memory_order_acq_rel))
             {
-                std::cerr << "StdoutLogChannel::LogToStream failed" << std::endl;
+                // the other channels get the queued messages explaining the crash, if the writer still can
+                ::DrainAsyncWriterFromSignal(AsyncDrainTimeout);
+                channel->DumpFromSignal(signal);
             }
+            std::signal(signal, SIG_DFL);
+            std::raise(signal);
+        }
+
+        static void InstallSignalHandlers()
+        {
+            static const bool installed = [] {
+                for (const auto signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL })
+                {
+                    std::signal(signal, OnFatalSignal);
+                }
+                return true;
+            }();
+            (void)installed;
         }
+
+        static constexpr auto AsyncDrainTimeout = std::chrono::milliseconds(500);
+
+        static_assert(std::atomic<CrashRingLogChannel*>::is_always_lock_free, "used by the signal handler");
+        static inline std::atomic<CrashRingLogChannel*> s_signalTarget = nullptr;
+
+        static inline std::atomic<uint64_t> s_nextId = 1;
+
+        const uint64_t m_id = s_nextId.fetch_add(1, std::memory_order_relaxed); // unlike the address, never reused
+        const fs::path m_filePath;
+        const size_t m_recordsPerThread;
+        int m_fd = -1; // opened for appending by the constructor
+        std::atomic<Ring*> m_rings = nullptr; // the newest first, read by the signal handler without locks
     };
 
     class GlobalLogger final : public ILogger
@@ -175,18 +1559,18 @@ namespace GameEngine
         }
         void Log(LogLevel level, const std::string_view LogMessage) noexcept override
         {
-            ::Log(level, LogMessage);
+            if (IsLogLevelEnabled(level))
+            {
+                ::Log(level, {}, LogMessage);
+            }
         }
         void Log(LogLevel level, const std::stringstream& stream) noexcept override
         {
-            try
-            {
-                ::Log(level, stream.str());
-            }
-            catch (...)
-            {
-                std::cerr << "GlobalLogger::Log failed" << std::endl;
-            }
+            Log(level, stream.view());
+        }
+        void Log(LogLevel level, const std::string_view prefix, const std::string_view LogMessage) noexcept override
+        {
+            ::Log(level, prefix, LogMessage);
         }
     };
 
@@ -196,6 +1580,7 @@ namespace GameEngine
         PrefixLogger(std::string_view prefix, const std::shared_ptr<ILogger>& baseLogger)
             : m_prefix(prefix)
             , m_baseLogger(baseLogger)
+            , m_categoryLevel(GetLogCategoryLevel(prefix))
         {
             if (!m_baseLogger)
             {
@@ -213,13 +1598,27 @@ namespace GameEngine
         }
         void Log(LogLevel level, const std::string_view LogMessage) noexcept override
         {
-            m_baseLogger->Log(level, (m_prefix + ' ').append(LogMessage));
+            if (IsLogLevelEnabled(level, m_categoryLevel))
+            {
+                m_baseLogger->Log(level, m_prefix, LogMessage);
+            }
         }
         void Log(LogLevel level, const std::stringstream& stream) noexcept override
         {
+            Log(level, stream.view());
+        }
+        void Log(LogLevel level, const std::string_view prefix, const std::string_view LogMessage) noexcept override
+        {
+            if (prefix.empty())
+            {
+                Log(level, LogMessage);
+                return;
+            }
+            // the level has been checked against the category of the nested logger
             try
             {
-                Log(level, stream.str());
+                // nested prefix loggers: rare, so the prefixes are simply joined
+                m_baseLogger->Log(level, (m_prefix + ' ').append(prefix), LogMessage);
             }
             catch (...)
             {
@@ -229,6 +1628,7 @@ namespace GameEngine
     private:
         const std::string m_prefix;
         const std::shared_ptr<ILogger> m_baseLogger;
+        const std::atomic<LogLevel>& m_categoryLevel;
     };
 
     LoggerInitializer::LoggerInitializer(LogLevel level)
@@ -251,9 +1651,8 @@ namespace GameEngine
     }
 
     Logable::Logable(const std::string_view prefix)
-        : m_logger(CreatePrefixLogger(prefix, ::GetLogger()))
+        : Logable(prefix, ::GetLogger())
     {
-
     }
 
     Logable::Logable(const std::string_view prefix, const std::shared_ptr<ILogger>& logger)
@@ -263,6 +1662,10 @@ namespace GameEngine
         {
             throw std::runtime_error("Logable expects m_logger");
         }
+        const std::scoped_lock lock(g_logLock);
+        const auto& category = ::GetLogCategory(prefix);
+        m_logGate = &category.level;
+        m_logPrefixId = category.id;
     }
 
     const std::shared_ptr<ILogger>& Logable::GetLogger() const noexcept
@@ -270,25 +1673,129 @@ namespace GameEngine
         return m_logger;
     }
 
+    const std::atomic<LogLevel>& Logable::GetLogGate() const noexcept
+    {
+        return *m_logGate;
+    }
+
+    uint32_t Logable::GetLogPrefixId() const noexcept
+    {
+        return m_logPrefixId;
+    }
+
     void InitLogger(LogLevel level)
     {
+        DisableAsyncLogging();
+        StopThreadChannel();
         const std::scoped_lock lock(g_logLock);
         g_globalLogger = std::make_shared<GlobalLogger>();
         g_channels.clear();
-        g_logLevel = level;
+        for (auto& category : g_logCategories)
+        {
+            category.hasOwnLevel = false;
+        }
+        SetGlobalLogLevel(level);
     }
 
     void SetLogLevel(LogLevel level)
     {
         const std::scoped_lock lock(g_logLock);
-        g_logLevel = level;
+        SetGlobalLogLevel(level);
     }
 
-    void FinishLogger()
+    const std::atomic<LogLevel>& GetLogCategoryLevel(const std::string_view category)
+    {
+        const std::scoped_lock lock(g_logLock);
+        return ::GetLogCategory(category).level;
+    }
+
+    void SetLogCategoryLevel(const std::string_view category, LogLevel level)
     {
         const std::scoped_lock lock(g_logLock);
+        auto& entry = ::GetLogCategory(category);
+        entry.hasOwnLevel = true;
+        entry.level = level;
+    }
+
+    void ResetLogCategoryLevel(const std::string_view category)
+    {
+        const std::scoped_lock lock(g_logLock);
+        auto& entry = ::GetLogCategory(category);
+        entry.hasOwnLevel = false;
+        entry.level = g_logLevel.load();
+    }
+
+    void EnableAsyncLogging(const AsyncLogConfig& config)
+    {
+        const std::scoped_lock lock(g_logTargetsLock);
+        StopAsyncWriter();
+        g_asyncWriterOwner = std::make_unique<AsyncLogWriter>(config);
+        g_asyncWriter.store(g_asyncWriterOwner.get(), std::memory_order_release);
+        if (!g_prevTerminateHandler)
+        {
+            g_prevTerminateHandler = std::set_terminate(OnTerminate);
+        }
+    }
+
+    void DisableAsyncLogging()
+    {
+        const std::scoped_lock lock(g_logTargetsLock);
+        StopAsyncWriter();
+    }
+
+    void FlushLogger()
+    {
+        try
+        {
+            {
+                const LogTargetsRef targets;
+                if (auto* writer = targets.GetAsyncWriter())
+                {
+                    writer->Flush();
+                }
+            }
+
+            const std::scoped_lock lock(g_logLock);
+            for (auto& channel : g_channels)
+            {
+                channel->Flush();
+            }
+        }
+        catch (...)
+        {
+            std::cerr << "FlushLogger failed" << std::endl;
+        }
+    }
+
+    void PollLogger()
+    {
+        const LogTargetsRef targets;
+        if (!targets.GetAsyncWriter())
+        {
+            NotifyIdle();
+        }
+    }
+
+    size_t GetDroppedLogMessages()
+    {
+        const LogTargetsRef targets;
+        return targets.GetAsyncWriter() ? targets.GetAsyncWriter()->GetDropped() : 0;
+    }
+
+    void FinishLogger()
+    {
+        if (IsLogLevelEnabled(LogLevel::INFO))
+        {
+            Log(LogLevel::INFO, {}, "Log finished.");
+        }
+        DisableAsyncLogging();
+        StopThreadChannel();
 
-        Log(LogLevel::INFO, "Log finished.");
+        const std::scoped_lock lock(g_logLock);
+        for (auto& channel : g_channels)
+        {
+            channel->Flush();
+        }
         g_channels.clear();
         g_globalLogger = std::make_shared<DummyLogger>();
     }
@@ -300,14 +1807,44 @@ namespace GameEngine
             throw std::runtime_error("AddLogHandler expects writer");
         }
 
-        const std::scoped_lock lock(g_logLock);
-        g_channels.push_back(std::move(writer));
-        Log(LogLevel::INFO, "Log started.");
+        auto* threadChannel = dynamic_cast<IThreadLogChannel*>(writer.get());
+        {
+            const std::scoped_lock lock(g_logLock);
+            g_channels.push_back(std::move(writer));
+        }
+        if (threadChannel)
+        {
+            // the channel added last gets the records
+            const std::scoped_lock lock(g_logTargetsLock);
+            g_threadChannel.store(threadChannel);
+        }
+        if (IsLogLevelEnabled(LogLevel::INFO))
+        {
+            Log(LogLevel::INFO, {}, "Log started.");
+        }
     }
 
     std::unique_ptr<ILogChannel> CreateFileLogChannel(const fs::path& fileName, size_t maxLogFileBytes)
     {
-        return std::make_unique<FileLogChannel>(fileName, maxLogFileBytes);
+        FileLogConfig config;
+        config.maxLogFileBytes = maxLogFileBytes;
+        config.bufferBytes = 0;
+        return std::make_unique<FileLogChannel>(fileName, config);
+    }
+
+    std::unique_ptr<ILogChannel> CreateFileLogChannel(const fs::path& fileName, const FileLogConfig& config)
+    {
+        return std::make_unique<FileLogChannel>(fileName, config);
+    }
+
+    std::unique_ptr<ILogChannel> CreateBinaryLogChannel(const fs::path& fileName, size_t maxLogFileBytes)
+    {
+        return std::make_unique<BinaryLogChannel>(fileName, maxLogFileBytes);
+    }
+
+    std::unique_ptr<ILogChannel> CreateCrashRingLogChannel(const fs::path& fileName, size_t recordsPerThread)
+    {
+        return std::make_unique<CrashRingLogChannel>(fileName, recordsPerThread);
     }
 
     std::unique_ptr<ILogChannel> CreateStdoutLogChannel()
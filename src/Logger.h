@@ -1,14 +1,20 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <string_view>
 #include <string>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <span>
 #include <sstream>
+#include <streambuf>
 #include <filesystem>
 
+#include "AllocationTracker.h"
+#include "BinaryLogFormat.h"
+
 
 #define _LOG_LEVELS_    \
     LOG_X(ERROR)        \
@@ -18,6 +24,10 @@
     LOG_X(VERBOSE)      \
     LOG_X(TRACE)        \
 
+// Least important level compiled in: statements below it are compiled out (see MIN_LOG_LEVEL in CMakeLists.txt)
+#ifndef GAME_ENGINE_MIN_LOG_LEVEL
+#define GAME_ENGINE_MIN_LOG_LEVEL TRACE
+#endif
 
 namespace GameEngine
 {
@@ -30,6 +40,21 @@ namespace GameEngine
     };
 #undef LOG_X
 
+    // current runtime level, use SetLogLevel() to change
+    extern std::atomic<LogLevel> g_logLevel;
+
+    // lock-free check done before any message formatting
+    inline bool IsLogLevelEnabled(LogLevel level) noexcept
+    {
+        return level <= g_logLevel.load(std::memory_order_relaxed);
+    }
+
+    // same check against the level of a log category (see GetLogCategoryLevel())
+    inline bool IsLogLevelEnabled(LogLevel level, const std::atomic<LogLevel>& categoryLevel) noexcept
+    {
+        return level <= categoryLevel.load(std::memory_order_relaxed);
+    }
+
     struct ILogger
     {
         virtual ~ILogger() = default;
@@ -38,19 +63,104 @@ namespace GameEngine
         virtual void Log(LogLevel level, const std::string& message) noexcept = 0;
         virtual void Log(LogLevel level, const std::string_view message) noexcept = 0;
         virtual void Log(LogLevel level, const std::stringstream& stream) noexcept = 0;
+        // prefix is passed down to channels as is, instead of being concatenated with the message.
+        // The level isn't checked again: the caller has checked it against the category of the prefix
+        virtual void Log(LogLevel level, const std::string_view prefix, const std::string_view message) noexcept = 0;
+    };
+
+    // Static description of a LOG_FMT statement, registered once on its first execution
+    struct LogSite
+    {
+        LogSite(LogLevel level, const char* file, unsigned int line, const char* format);
+        LogSite(const LogSite&) = delete;
+        LogSite& operator=(const LogSite&) = delete;
+
+        const uint32_t id; // sequential, starting from 0
+        const LogLevel level;
+        const char* const file;
+        const unsigned int line;
+        const char* const format; // "{}" placeholders
+    };
+
+    // Not formatted LOG_FMT message
+    struct LogRecord
+    {
+        const LogSite& site;
+        std::chrono::steady_clock::time_point timestamp;
+        std::span<const std::byte> args; // see BinaryLogFormat.h
+        uint32_t prefixId; // of the Logable class, 0 - logged outside of Logable classes
+        std::string_view prefix; // its name, kept until the process ends
     };
 
     struct ILogChannel
     {
         virtual ~ILogChannel() = default;
-        virtual void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view message) noexcept = 0;
+        // prefix (e.g. name of the Logable class) may be empty
+        virtual void Log(std::chrono::system_clock::time_point timestamp, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept = 0;
+        // formats the record and passes it to Log() by default
+        virtual void LogBinary(const LogRecord& record) noexcept;
+        // writes buffered messages out
+        virtual void Flush() noexcept {}
+        // called by the async writer after every batch of messages
+        virtual void OnBatchWritten() noexcept { Flush(); }
+        // called regularly while no messages come: by the idle async writer, by PollLogger() otherwise
+        virtual void OnIdle() noexcept {}
+    };
+
+    struct FileLogConfig
+    {
+        size_t maxLogFileBytes = 10 * 1024 * 1024;
+        size_t generations = 1; // rotated files kept: name.bak, name.bak.1, ...
+        // buffer size: messages are written out when it is full, 0 - every message is flushed
+        size_t bufferBytes = 64 * 1024;
+        // since the last flush, 0 - disabled. Checked per message and on OnIdle(), so the tail is written out as well
+        std::chrono::milliseconds flushInterval{ 1000 };
+        bool flushOnError = true;
+        // the buffer is always flushed on FlushLogger()/FinishLogger()
+    };
+
+    // What a caller does when the async queue is full
+    enum class LogOverflowPolicy : unsigned int
+    {
+        BLOCK,              // wait for a free slot
+        DROP,               // drop the message
+        DROP_LOWEST_LEVEL,  // drop messages below INFO (queue 3/4 full and more), wait otherwise
+    };
+
+    struct AsyncLogConfig
+    {
+        size_t queueSize = 8192; // messages, rounded up to a power of two
+        LogOverflowPolicy overflowPolicy = LogOverflowPolicy::DROP_LOWEST_LEVEL;
     };
 
-    void InitLogger(LogLevel level);
-    void SetLogLevel(LogLevel level);
+    void InitLogger(LogLevel level); // also resets the category levels
+    void SetLogLevel(LogLevel level); // applies to the categories without own level as well
+    // Log categories are the prefixes of Logable classes (e.g. "GameLoop"), each has its own level
+    // which follows SetLogLevel() until it is set explicitly.
+    // Returns the level of the category, registering the category on the first call
+    const std::atomic<LogLevel>& GetLogCategoryLevel(const std::string_view category);
+    void SetLogCategoryLevel(const std::string_view category, LogLevel level);
+    void ResetLogCategoryLevel(const std::string_view category); // follow SetLogLevel() again
     void AddLogHandler(std::unique_ptr<ILogChannel> writer);
+    // every message is flushed, a single rotated file is kept
     std::unique_ptr<ILogChannel> CreateFileLogChannel(const fs::path& fileName, size_t maxLogFileBytes);
+    std::unique_ptr<ILogChannel> CreateFileLogChannel(const fs::path& fileName, const FileLogConfig& config);
     std::unique_ptr<ILogChannel> CreateStdoutLogChannel();
+    // Writes LOG_FMT records unformatted (see BinaryLogFormat.h), decode the file with logdecode tool
+    std::unique_ptr<ILogChannel> CreateBinaryLogChannel(const fs::path& fileName, size_t maxLogFileBytes);
+    // Keeps only the last recordsPerThread messages of every thread in memory. They are appended to the file,
+    // merged by time, on FlushLogger() (e.g. a failed expectation), FinishLogger() or a fatal signal
+    std::unique_ptr<ILogChannel> CreateCrashRingLogChannel(const fs::path& fileName, size_t recordsPerThread);
+    // Callers only enqueue messages, a dedicated thread formats and writes them in batches.
+    // Call after InitLogger() and before other threads start logging. Queued messages are written on
+    // std::terminate; on a fatal signal only with a crash ring channel, whose handler waits for the writer up to 500 ms
+    void EnableAsyncLogging(const AsyncLogConfig& config = {});
+    void DisableAsyncLogging(); // writes all queued messages and stops the thread
+    void FlushLogger(); // returns when all the messages logged so far are written
+    // lets the channels flush on their intervals while nothing is logged; the async writer does it itself.
+    // Called by GameLoop every frame
+    void PollLogger();
+    size_t GetDroppedLogMessages();
     void FinishLogger();
 
     std::shared_ptr<ILogger> CreatePrefixLogger(const std::string_view prefix, const std::shared_ptr<ILogger>& baseLogger);
@@ -77,18 +187,66 @@ namespace GameEngine
         ~Logable() = default;
 
         const std::shared_ptr<ILogger>& GetLogger() const noexcept;
+        // level of the category named by the prefix, checked by the LOG_ macros
+        const std::atomic<LogLevel>& GetLogGate() const noexcept;
+        // id of the category, passed by LOG_FMT instead of the prefix itself
+        uint32_t GetLogPrefixId() const noexcept;
 
     private:
         std::shared_ptr<ILogger> m_logger;
+        const std::atomic<LogLevel>* m_logGate = &g_logLevel;
+        uint32_t m_logPrefixId = 0;
     };
 
-    class LogStreamHelper final : public std::stringstream
+    void LogSiteRecord(const LogSite& site, uint32_t prefixId, std::span<const std::byte> args) noexcept;
+
+    template <typename... Args>
+    void LogFormatted(const LogSite& site, uint32_t prefixId, const Args&... args) noexcept
+    {
+        BinaryLog::ArgsBuffer buffer;
+        (buffer.Add(args), ...);
+        LogSiteRecord(site, prefixId, buffer.GetBytes());
+    }
+
+    // Stream buffer filling the inline array first, oversized messages spill to the heap
+    class LogStreamBuffer final : public std::streambuf
+    {
+    public:
+        static constexpr size_t InlineSize = 256;
+
+        LogStreamBuffer() noexcept
+        {
+            setp(m_inline, m_inline + InlineSize);
+        }
+
+        LogStreamBuffer(const LogStreamBuffer&) = delete;
+        LogStreamBuffer& operator=(const LogStreamBuffer&) = delete;
+
+        std::string_view GetView() const noexcept
+        {
+            return { pbase(), static_cast<size_t>(pptr() - pbase()) };
+        }
+
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+    private:
+        void grow(size_t required);
+
+        char m_inline[InlineSize];
+        std::string m_spill;
+    };
+
+    class LogStreamHelper final : public std::ostream
     {
     public:
         LogStreamHelper(LogLevel level, ILogger& Logger)
-            : m_level(level)
+            : std::ostream(nullptr)
+            , m_level(level)
             , m_Logger(Logger)
         {
+            rdbuf(&m_buffer);
         }
 
         LogStreamHelper(const LogStreamHelper&) = delete;
@@ -98,20 +256,60 @@ namespace GameEngine
 
         ~LogStreamHelper()
         {
-            m_Logger.Log(m_level, *this);
+            m_Logger.Log(m_level, m_buffer.GetView());
         }
 
     private:
+        const AllocationTagScope m_allocationTag{AllocationTag::LOGGER};
         const LogLevel m_level;
         ILogger& m_Logger;
+        LogStreamBuffer m_buffer;
     };
 } // namespace
 
 const std::shared_ptr<GameEngine::ILogger>& GetLogger() noexcept;
 
-#define LOG_TRACE(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::TRACE, *GetLogger()); t << '[' << __func__ << "():" << __LINE__ << "] " << message; } while (false);
-#define LOG_VERBOSE(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::VERBOSE, *GetLogger()); t << message; } while (false);
-#define LOG_DEBUG(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::DEBUG, *GetLogger()); t << message; } while (false);
-#define LOG_INFO(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::INFO, *GetLogger()); t << message; } while (false);
-#define LOG_WARNING(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::WARNING, *GetLogger()); t << message; } while (false);
-#define LOG_ERROR(message) do { GameEngine::LogStreamHelper t(GameEngine::LogLevel::ERROR, *GetLogger()); t << message; } while (false);
+// messages logged outside of Logable classes are checked against the global level
+inline const std::atomic<GameEngine::LogLevel>& GetLogGate() noexcept
+{
+    return GameEngine::g_logLevel;
+}
+
+// LOG_FMT outside of Logable classes has no prefix
+inline uint32_t GetLogPrefixId() noexcept
+{
+    return 0;
+}
+
+// message is neither formatted nor evaluated when the level is disabled,
+// GetLogGate() resolves to the category level inside Logable classes
+#define _LOG_IMPL_(level, message) \
+    do { \
+        if constexpr (GameEngine::LogLevel::level <= GameEngine::LogLevel::GAME_ENGINE_MIN_LOG_LEVEL) { \
+            if (GameEngine::IsLogLevelEnabled(GameEngine::LogLevel::level, GetLogGate())) { \
+                GameEngine::LogStreamHelper t(GameEngine::LogLevel::level, *GetLogger()); t << message; \
+            } \
+        } \
+    } while (false)
+
+#define LOG_TRACE(message) _LOG_IMPL_(TRACE, '[' << __func__ << "():" << __LINE__ << "] " << message);
+#define LOG_VERBOSE(message) _LOG_IMPL_(VERBOSE, message);
+#define LOG_DEBUG(message) _LOG_IMPL_(DEBUG, message);
+#define LOG_INFO(message) _LOG_IMPL_(INFO, message);
+#define LOG_WARNING(message) _LOG_IMPL_(WARNING, message);
+#define LOG_ERROR(message) _LOG_IMPL_(ERROR, message);
+
+// Deferred formatting: arguments are stored raw and "{}" placeholders of format are substituted
+// by the channel (or offline by logdecode for the binary channel), e.g.
+// LOG_FMT(DEBUG, "position {} of {}", i, name);
+// Supported arguments: integers, floating point, bool, char, enums and strings.
+// Inside Logable classes the record carries the id of the prefix, resolved to the name by the channels
+#define LOG_FMT(level, format, ...) \
+    do { \
+        if constexpr (GameEngine::LogLevel::level <= GameEngine::LogLevel::GAME_ENGINE_MIN_LOG_LEVEL) { \
+            if (GameEngine::IsLogLevelEnabled(GameEngine::LogLevel::level, GetLogGate())) { \
+                static const GameEngine::LogSite logSite(GameEngine::LogLevel::level, __FILE__, __LINE__, format); \
+                GameEngine::LogFormatted(logSite, GetLogPrefixId() __VA_OPT__(,) __VA_ARGS__); \
+            } \
+        } \
+    } while (false)
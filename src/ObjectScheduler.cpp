@@ -0,0 +1,370 @@
+#include "ObjectScheduler.h"
+
+#include <algorithm>
+
+namespace GameEngine
+{
+    void ObjectScheduler::Add(IGameObject *object, bool isActive)
+    {
+        if (Contains(object))
+        {
+            return;
+        }
+        uint32_t index = 0;
+        if (m_freeEntries.empty())
+        {
+            index = static_cast<uint32_t>(m_entries.size());
+            m_entries.emplace_back();
+        }
+        else
+        {
+            index = m_freeEntries.back();
+            m_freeEntries.pop_back();
+        }
+        m_entries[index] = { object, 0, m_time, 1, 0, State::SLEEPING, false, isActive };
+        m_indices.emplace(object, index);
+        wake(index);
+    }
+
+    void ObjectScheduler::Remove(IGameObject *object)
+    {
+        const auto it = m_indices.find(object);
+        if (it == m_indices.end())
+        {
+            return;
+        }
+        const auto index = it->second;
+        m_indices.erase(it);
+        auto &entry = m_entries[index];
+        if (entry.isActive)
+        {
+            if (entry.state == State::AWAKE)
+            {
+                --m_awakeNum;
+            }
+            if (entry.wakeFrame)
+            {
+                --m_timedNum;
+            }
+            release_bucket(entry);
+        }
+        entry = { nullptr, 0, 0, 1, 0, State::FREE, entry.isListed, true };
+        if (entry.isListed)
+        {
+            // reused once dropped from the awake list
+            m_needsCompaction = true;
+        }
+        else
+        {
+            m_freeEntries.push_back(index);
+        }
+    }
+
+    bool ObjectScheduler::Contains(const IGameObject *object) const
+    {
+        return find(object) != nullptr;
+    }
+
+    void ObjectScheduler::SetActive(IGameObject *object, bool isActive)
+    {
+        const auto it = m_indices.find(object);
+        if (it == m_indices.end() || m_entries[it->second].isActive == isActive)
+        {
+            return;
+        }
+        const auto index = it->second;
+        auto &entry = m_entries[index];
+        if (!isActive)
+        {
+            // the sleep state stays, the object just stops being counted
+            if (entry.state == State::AWAKE)
+            {
+                --m_awakeNum;
+                m_needsCompaction = true;
+            }
+            if (entry.wakeFrame)
+            {
+                --m_timedNum; // the timer is dropped when due, activation sets it again
+            }
+            // the interval stays, the bucket goes to the active objects of the tier
+            release_bucket(entry);
+            entry.isActive = false;
+            return;
+        }
+        entry.isActive = true;
+        assign_bucket(entry);
+        // the time spent inactive isn't elapsed time of the object
+        entry.lastUpdate = m_time;
+        if (entry.state == State::AWAKE)
+        {
+            ++m_awakeNum;
+            if (!entry.isListed)
+            {
+                entry.isListed = true;
+                m_awake.push_back(index);
+            }
+        }
+        else if (entry.wakeFrame)
+        {
+            ++m_timedNum;
+            if (entry.wakeFrame <= m_frame)
+            {
+                wake(index); // overslept while inactive
+            }
+            else
+            {
+                m_wheel[entry.wakeFrame % WheelSize].push_back({ index, entry.wakeFrame });
+            }
+        }
+    }
+
+    bool ObjectScheduler::IsActive(const IGameObject *object) const
+    {
+        const auto *entry = find(object);
+        return entry && entry->isActive;
+    }
+
+    void ObjectScheduler::Sleep(IGameObject *object)
+    {
+        sleep(object, 0);
+    }
+
+    void ObjectScheduler::SleepFor(IGameObject *object, uint32_t frames)
+    {
+        if (frames)
+        {
+            sleep(object, m_frame + frames);
+        }
+        else
+        {
+            Wake(object);
+        }
+    }
+
+    void ObjectScheduler::Wake(IGameObject *object)
+    {
+        const auto it = m_indices.find(object);
+        if (it != m_indices.end())
+        {
+            wake(it->second);
+        }
+    }
+
+    bool ObjectScheduler::IsAwake(const IGameObject *object) const
+    {
+        const auto *entry = find(object);
+        return entry && entry->state == State::AWAKE;
+    }
+
+    void ObjectScheduler::SetUpdateInterval(IGameObject *object, uint32_t frames)
+    {
+        auto *entry = find(object);
+        if (!entry)
+        {
+            return;
+        }
+        // an inactive object gets its bucket once activated
+        if (entry->isActive)
+        {
+            release_bucket(*entry);
+        }
+        entry->interval = std::max(1u, frames);
+        entry->bucket = 0;
+        if (entry->isActive)
+        {
+            assign_bucket(*entry);
+        }
+    }
+
+    void ObjectScheduler::Update(float elapsed)
+    {
+        ++m_frame;
+        m_time += elapsed;
+        wake_timers();
+        // objects woken meanwhile are appended and wait for the next frame
+        const auto count = m_awake.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto &entry = m_entries[m_awake[i]];
+            if (entry.state != State::AWAKE || !entry.isActive || (entry.interval > 1 && m_frame % entry.interval != entry.bucket))
+            {
+                continue;
+            }
+            const auto sinceLastUpdate = static_cast<float>(m_time - entry.lastUpdate);
+            entry.lastUpdate = m_time;
+            // by value: the entries may grow during the update
+            auto *object = entry.object;
+            object->Update(sinceLastUpdate);
+        }
+        compact();
+    }
+
+    size_t ObjectScheduler::GetCount() const
+    {
+        return m_indices.size();
+    }
+
+    size_t ObjectScheduler::GetAwakeCount() const
+    {
+        return m_awakeNum;
+    }
+
+    bool ObjectScheduler::IsIdle() const
+    {
+        return !m_awakeNum && !m_timedNum;
+    }
+
+    uint64_t ObjectScheduler::GetFrame() const
+    {
+        return m_frame;
+    }
+
+    ObjectScheduler::Entry *ObjectScheduler::find(const IGameObject *object)
+    {
+        const auto it = m_indices.find(object);
+        return it == m_indices.end() ? nullptr : &m_entries[it->second];
+    }
+
+    const ObjectScheduler::Entry *ObjectScheduler::find(const IGameObject *object) const
+    {
+        const auto it = m_indices.find(object);
+        return it == m_indices.end() ? nullptr : &m_entries[it->second];
+    }
+
+    void ObjectScheduler::sleep(IGameObject *object, uint64_t wakeFrame)
+    {
+        const auto it = m_indices.find(object);
+        if (it == m_indices.end())
+        {
+            return;
+        }
+        const auto index = it->second;
+        auto &entry = m_entries[index];
+        if (!entry.isActive)
+        {
+            // kept for the activation
+            entry.state = State::SLEEPING;
+            entry.wakeFrame = wakeFrame;
+            return;
+        }
+        if (entry.state == State::AWAKE)
+        {
+            --m_awakeNum;
+            m_needsCompaction = true;
+        }
+        entry.state = State::SLEEPING;
+        if (entry.wakeFrame)
+        {
+            --m_timedNum;
+        }
+        entry.wakeFrame = wakeFrame;
+        if (wakeFrame)
+        {
+            ++m_timedNum;
+            m_wheel[wakeFrame % WheelSize].push_back({ index, wakeFrame });
+        }
+    }
+
+    void ObjectScheduler::wake(uint32_t index)
+    {
+        auto &entry = m_entries[index];
+        if (entry.state != State::SLEEPING)
+        {
+            return;
+        }
+        entry.state = State::AWAKE;
+        if (entry.isActive && entry.wakeFrame)
+        {
+            --m_timedNum;
+        }
+        entry.wakeFrame = 0;
+        if (!entry.isActive)
+        {
+            return; // counted and listed once activated
+        }
+        ++m_awakeNum;
+        if (!entry.isListed)
+        {
+            entry.isListed = true;
+            m_awake.push_back(index);
+        }
+    }
+
+    void ObjectScheduler::wake_timers()
+    {
+        auto &slot = m_wheel[m_frame % WheelSize];
+        size_t kept = 0;
+        for (const auto &timer : slot)
+        {
+            if (timer.wakeFrame > m_frame)
+            {
+                slot[kept++] = timer; // a later turn of the wheel
+                continue;
+            }
+            const auto &entry = m_entries[timer.entry];
+            if (entry.isActive && entry.state == State::SLEEPING && entry.wakeFrame == timer.wakeFrame)
+            {
+                wake(timer.entry);
+            }
+        }
+        slot.resize(kept);
+    }
+
+    void ObjectScheduler::assign_bucket(Entry &entry)
+    {
+        if (entry.interval == 1)
+        {
+            return;
+        }
+        auto tier = std::find_if(m_tiers.begin(), m_tiers.end(), [&entry](const Tier &t) { return t.interval == entry.interval; });
+        if (tier == m_tiers.end())
+        {
+            tier = m_tiers.insert(tier, { entry.interval, std::vector<uint32_t>(entry.interval) });
+        }
+        // the least loaded bucket keeps the tier even after removals
+        const auto bucket = std::min_element(tier->bucketSizes.begin(), tier->bucketSizes.end());
+        entry.bucket = static_cast<uint32_t>(bucket - tier->bucketSizes.begin());
+        ++*bucket;
+    }
+
+    void ObjectScheduler::release_bucket(const Entry &entry)
+    {
+        if (entry.interval == 1)
+        {
+            return;
+        }
+        for (auto &tier : m_tiers)
+        {
+            if (tier.interval == entry.interval)
+            {
+                --tier.bucketSizes[entry.bucket];
+                return;
+            }
+        }
+    }
+
+    void ObjectScheduler::compact()
+    {
+        if (!m_needsCompaction)
+        {
+            return;
+        }
+        size_t kept = 0;
+        for (const auto index : m_awake)
+        {
+            auto &entry = m_entries[index];
+            if (entry.state == State::AWAKE && entry.isActive)
+            {
+                m_awake[kept++] = index;
+                continue;
+            }
+            entry.isListed = false;
+            if (entry.state == State::FREE)
+            {
+                m_freeEntries.push_back(index);
+            }
+        }
+        m_awake.resize(kept);
+        m_needsCompaction = false;
+    }
+} // namespace GameEngine
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "IGameObject.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace GameEngine
+{
+    // Update intervals in frames, named by their rate at 60 fps
+    namespace UpdateTier
+    {
+        constexpr uint32_t HZ_60 = 1;
+        constexpr uint32_t HZ_30 = 2;
+        constexpr uint32_t HZ_10 = 6;
+        constexpr uint32_t HZ_1 = 60;
+    }
+
+    // Active objects of a window, split into awake and sleeping ones.
+    // Update() visits only the compact list of awake objects, so its cost doesn't depend on the sleeping ones.
+    // An object sleeps until woken, e.g. by its input or EventBus handler, or for a number of frames:
+    // timed sleeps are kept in a timer wheel and all the objects due in a frame are woken in one pass.
+    // Objects may sleep and wake themselves and each other during Update(); woken ones are updated from the next frame.
+    // Objects with an update interval of N frames are spread over N buckets, one bucket is updated per frame,
+    // so a tier costs the same every frame instead of spiking every Nth one.
+    // Inactive objects aren't updated but keep their sleep state and update interval until activated again
+    class ObjectScheduler
+    {
+    public:
+        static constexpr size_t WheelSize = 256; // frames, longer sleeps take more turns of the wheel
+
+        void Add(IGameObject *object, bool isActive = true); // awake
+        void Remove(IGameObject *object); // forgets the object with its settings
+        bool Contains(const IGameObject *object) const; // added, active or not
+        void SetActive(IGameObject *object, bool isActive);
+        bool IsActive(const IGameObject *object) const;
+
+        // sleeps until Wake()
+        void Sleep(IGameObject *object);
+        // the object is updated again the given number of frames later, 0 - next frame
+        void SleepFor(IGameObject *object, uint32_t frames);
+        void Wake(IGameObject *object);
+        bool IsAwake(const IGameObject *object) const; // the sleep state, kept while inactive
+        // 1 - every frame (default). Kept while the object is inactive, it may be set meanwhile as well
+        void SetUpdateInterval(IGameObject *object, uint32_t frames);
+
+        // wakes the objects whose time has come, then updates the awake ones of this frame's buckets,
+        // each one gets the time since its previous update
+        void Update(float elapsed);
+
+        size_t GetCount() const; // active or not
+        size_t GetAwakeCount() const; // active awake objects
+        // no awake objects and no timed sleeps: updating would change nothing
+        bool IsIdle() const;
+        uint64_t GetFrame() const;
+
+    private:
+        enum class State : uint8_t
+        {
+            AWAKE,
+            SLEEPING,
+            FREE,
+        };
+
+        struct Entry
+        {
+            IGameObject *object = nullptr;
+            uint64_t wakeFrame = 0; // of the timed sleep, 0 - none
+            double lastUpdate = 0; // m_time
+            uint32_t interval = 1;
+            uint32_t bucket = 0; // updated when m_frame % interval == bucket
+            State state = State::FREE;
+            bool isListed = false; // in m_awake
+            bool isActive = true; // inactive ones aren't counted as awake or timed
+        };
+
+        struct Tier
+        {
+            uint32_t interval;
+            std::vector<uint32_t> bucketSizes;
+        };
+
+        struct Timer
+        {
+            uint32_t entry;
+            uint64_t wakeFrame; // stale if the entry doesn't sleep until it anymore
+        };
+
+        Entry *find(const IGameObject *object);
+        const Entry *find(const IGameObject *object) const;
+        void sleep(IGameObject *object, uint64_t wakeFrame);
+        void wake(uint32_t index);
+        void wake_timers();
+        void compact();
+        void assign_bucket(Entry &entry); // of the entry's interval tier
+        void release_bucket(const Entry &entry);
+
+        std::vector<Entry> m_entries;
+        std::vector<uint32_t> m_freeEntries;
+        std::unordered_map<const IGameObject *, uint32_t> m_indices;
+        std::vector<uint32_t> m_awake; // may hold sleeping and removed entries until compacted
+        size_t m_awakeNum = 0;
+        size_t m_timedNum = 0; // sleeping until a frame
+        bool m_needsCompaction = false;
+        std::array<std::vector<Timer>, WheelSize> m_wheel;
+        std::vector<Tier> m_tiers;
+        uint64_t m_frame = 0;
+        double m_time = 0; // seconds
+    };
+} // namespace GameEngine
@@ -10,10 +10,11 @@ namespace GameEngine {
         SDL_Renderer *m_renderer;
         explicit RenderContext(SDL_Renderer* rend) : m_renderer(rend){}
         friend class Window;
+        friend class HeadlessWindow;
         friend class RendererComponent;
         friend class TextureComponent;
     protected:
-        RenderContext() : m_renderer(nullptr) {} // for testing purposes
+        RenderContext() : m_renderer(nullptr) {} // for testing purposes and headless windows
     public:
         ~RenderContext() = default;
     };
@@ -5,8 +5,9 @@
 #include "Logger.h"
 #include "RendererComponent.h"
 
-#define EXPECT_SDL(condition, message) \
-    EXPECT_MSG(condition, message << ": " << SDL_GetError())
+// draw calls don't abort the frame on failure
+#define EXPECT_SDL_FRAME(condition, message) \
+    EXPECT_FRAME_MSG(condition, message << ": " << SDL_GetError())
 
 namespace GameEngine {
 
@@ -22,6 +23,37 @@ namespace GameEngine {
         m_textures_q.emplace(tex);
     }
 
+    void RendererComponent::TextureHandle::add_matrix(const std::shared_ptr<ComponentMatrix<TextureComponent, ValueCellStorage>> &matrix) {
+        m_matrices.emplace_back(matrix);
+    }
+
+    void RendererComponent::TextureHandle::queue_matrices() {
+        for (const auto &matrix : m_matrices) {
+            for (auto &cell : matrix->GetSerializedMatrix()) {
+                // aliasing pointer: shares the matrix ownership, no allocation per cell.
+                // Valid while drawn, the matrix doesn't change during OnUpdate()
+                m_textures_q.emplace(matrix, &cell);
+            }
+            set_texture_lines(static_cast<unsigned int>(matrix->GetRowsNum()));
+        }
+        m_matrices.clear();
+    }
+
+    size_t RendererComponent::TextureHandle::get_queued_num() const {
+        size_t num = m_textures_q.size();
+        for (const auto &matrix : m_matrices) {
+            num += matrix->GetSerializedMatrix().size();
+        }
+        return num;
+    }
+
+    void RendererComponent::TextureHandle::clear() {
+        while (!m_textures_q.empty()) {
+            m_textures_q.pop();
+        }
+        m_matrices.clear();
+    }
+
     void RendererComponent::TextureHandle::calculate_texture_traits(const SDL_Rect *main_rect) {
 
         /// if too many lines, adjust them
@@ -113,9 +145,20 @@ namespace GameEngine {
           m_transform(transform)
         {}
 
+    bool RendererComponent::is_headless() const {
+        return !m_sdlHdl.m_renderer;
+    }
+
     void RendererComponent::update_textures() {
 
+        if (is_headless()) {
+            // nothing to draw on: textures added during the frame are dropped
+            m_textureHdl.clear();
+            return;
+        }
+
         const auto main_rect = m_transform->get_rect();
+        m_textureHdl.queue_matrices();
         /// calculate coordinates from rect
         m_textureHdl.calculate_texture_traits(main_rect);
 
@@ -127,7 +170,7 @@ namespace GameEngine {
 
             if (m_transform->get_angle() != 0.0 || m_transform->get_flip() != SDL_FLIP_NONE) {
                 // special treatment for flip and rotation
-                EXPECT_SDL(SDL_RenderCopyEx(m_sdlHdl.m_renderer, // sdl m_renderer
+                EXPECT_SDL_FRAME(SDL_RenderCopyEx(m_sdlHdl.m_renderer, // sdl m_renderer
                                             texture, // sdl texture
                                             nullptr, // apply to whole texture
                                             dst_rect, // texture destination
@@ -137,7 +180,7 @@ namespace GameEngine {
                 ) == 0, "Unable to render-copy texture");
             }
             else {
-                EXPECT_SDL(SDL_RenderCopy(m_sdlHdl.m_renderer, // sdl m_renderer
+                EXPECT_SDL_FRAME(SDL_RenderCopy(m_sdlHdl.m_renderer, // sdl m_renderer
                                           texture, // sdl texture
                                           nullptr, // apply to whole texture
                                           dst_rect // texture destination
@@ -147,13 +190,15 @@ namespace GameEngine {
     }
 
     void RendererComponent::SetDrawColor(const RGBColor &rgba) {
-        EXPECT_SDL(SDL_SetRenderDrawColor(m_sdlHdl.m_renderer, rgba.r, rgba.g, rgba.b, rgba.a) == 0,
+        if (is_headless()) return;
+        EXPECT_SDL_FRAME(SDL_SetRenderDrawColor(m_sdlHdl.m_renderer, rgba.r, rgba.g, rgba.b, rgba.a) == 0,
                "Error setting renderer color");
     }
 
     void RendererComponent::DrawPoint(const Pos2D &point) const {
-        const auto main_pos = m_transform->GetPosition();
-        EXPECT_SDL(SDL_RenderDrawPoint(m_sdlHdl.m_renderer,
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
+        EXPECT_SDL_FRAME(SDL_RenderDrawPoint(m_sdlHdl.m_renderer,
                                    main_pos.x + point.x,
                                    main_pos.y + point.y
                                    ) == 0,
@@ -161,21 +206,23 @@ namespace GameEngine {
     }
 
     void RendererComponent::DrawPoints(const std::vector<Pos2D> &points) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         std::vector<SDL_Point> sdl_points{};
         sdl_points.reserve(points.size());
         for (const auto &p : points) {
             sdl_points.emplace_back(SDL_Point{main_pos.x + p.x, main_pos.y + p.y});
         }
-        EXPECT_SDL(SDL_RenderDrawPoints(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderDrawPoints(m_sdlHdl.m_renderer,
                                     sdl_points.data(),
                                     static_cast<int>(sdl_points.size())
                                     ) == 0, "Error drawing points");
     }
 
     void RendererComponent::DrawLine(const Pos2D &start, const Pos2D &end) const {
-        const auto main_pos = m_transform->GetPosition();
-        EXPECT_SDL(SDL_RenderDrawLine(m_sdlHdl.m_renderer,
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
+        EXPECT_SDL_FRAME(SDL_RenderDrawLine(m_sdlHdl.m_renderer,
                                   main_pos.x + start.x,
                                   main_pos.y + start.y,
                                   main_pos.x + end.x,
@@ -184,32 +231,35 @@ namespace GameEngine {
     }
 
     void RendererComponent::DrawLines(const std::vector<Pos2D> &points) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         std::vector<SDL_Point> sdl_points{};
         sdl_points.reserve(points.size());
         for (const auto &p : points) {
             sdl_points.emplace_back(SDL_Point{main_pos.x + p.x, main_pos.y + p.y});
         }
-        EXPECT_SDL(SDL_RenderDrawLines(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderDrawLines(m_sdlHdl.m_renderer,
                                    sdl_points.data(),
                                    static_cast<int>(points.size())
                                    ) == 0, "Error drawing lines");
     }
 
     void RendererComponent::DrawRect(const Rect &rect) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         const SDL_Rect sdl_rect {
             main_pos.x,
             main_pos.y,
             rect.w,
             rect.h
         };
-        EXPECT_SDL(SDL_RenderDrawRect(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderDrawRect(m_sdlHdl.m_renderer,
                                   &sdl_rect) == 0, "Error drawing rect");
     }
 
     void RendererComponent::DrawRects(const std::vector<Rect> &rects) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         std::vector<SDL_Rect> sdl_rects{};
         sdl_rects.reserve(rects.size());
         for(const auto &r : rects) {
@@ -219,27 +269,29 @@ namespace GameEngine {
                     r.w,
                     r.h});
         }
-        EXPECT_SDL(SDL_RenderDrawRects(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderDrawRects(m_sdlHdl.m_renderer,
                                    sdl_rects.data(),
                                    static_cast<int>(rects.size())
                                    ) == 0, "Error drawing rects");
     }
 
     void RendererComponent::FillRect(const Rect &rect) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         const SDL_Rect sdl_rect {
                 main_pos.x,
                 main_pos.y,
                 rect.w,
                 rect.h
         };
-        EXPECT_SDL(SDL_RenderFillRect(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderFillRect(m_sdlHdl.m_renderer,
                                   &sdl_rect
                                   ) == 0, "Error filling rect");
     }
 
     void RendererComponent::FillRects(const std::vector<Rect> &rects) const {
-        const auto main_pos = m_transform->GetPosition();
+        if (is_headless()) return;
+        const auto main_pos = m_transform->GetWorldPosition();
         std::vector<SDL_Rect> sdl_rects{};
         sdl_rects.reserve(rects.size());
         for(const auto &r : rects) {
@@ -249,7 +301,7 @@ namespace GameEngine {
                     r.w,
                     r.h});
         }
-        EXPECT_SDL(SDL_RenderFillRects(m_sdlHdl.m_renderer,
+        EXPECT_SDL_FRAME(SDL_RenderFillRects(m_sdlHdl.m_renderer,
                                    sdl_rects.data(),
                                    static_cast<int>(rects.size())
                                    ) == 0, "Error filling rects");
@@ -263,10 +315,18 @@ namespace GameEngine {
         m_textureHdl.add_texture(tex);
     }
 
+    void RendererComponent::AddTextures(const std::shared_ptr<ComponentMatrix<TextureComponent, ValueCellStorage>> &matrix) {
+        m_textureHdl.add_matrix(matrix);
+    }
+
     void RendererComponent::SetTextureRows(unsigned int rows) {
         m_textureHdl.set_texture_lines(rows);
     }
 
+    size_t RendererComponent::GetQueuedTexturesNum() const {
+        return m_textureHdl.get_queued_num();
+    }
+
     void RendererComponent::OnUpdate() {
 
         update_textures();
@@ -7,6 +7,7 @@
 #include "sdl.h"
 
 #include "IGameObjectComponent.h"
+#include "ComponentMatrix.h"
 #include "RenderContext.h"
 #include "TextureComponent.h"
 #include "TransformComponent.h"
@@ -33,6 +34,8 @@ namespace GameEngine {
             TextureHandle() = default;
             ~TextureHandle() = default;
             std::queue<std::shared_ptr<TextureComponent>> m_textures_q{};
+            // cells are taken when drawn: the matrix may change meanwhile
+            std::vector<std::shared_ptr<ComponentMatrix<TextureComponent, ValueCellStorage>>> m_matrices{};
             size_t m_texture_lines = 1;
 
             unsigned int m_tex_per_line_min = 0;
@@ -54,6 +57,10 @@ namespace GameEngine {
 
             void set_texture_lines(unsigned int lines);
             void add_texture(const std::shared_ptr<TextureComponent> &tex);
+            void add_matrix(const std::shared_ptr<ComponentMatrix<TextureComponent, ValueCellStorage>> &matrix);
+            void queue_matrices(); // call before calculate_texture_traits()
+            size_t get_queued_num() const;
+            void clear();
             void calculate_texture_traits(const SDL_Rect *main_rect); // call once
             TexRect get_texture_and_rect(); // call for each texture
             friend class RendererComponent;
@@ -61,6 +68,7 @@ namespace GameEngine {
         SDLHandle m_sdlHdl;
         TextureHandle m_textureHdl;
         const std::shared_ptr<const TransformComponent> m_transform;
+        bool is_headless() const; // no renderer: draw calls do nothing
         void update_textures();
         friend class GameObject;
     protected:
@@ -84,7 +92,11 @@ namespace GameEngine {
         void FillRects(const std::vector<Rect> &rects) const;
         RenderContext GetRenderContext() const;
         void AddTexture(const std::shared_ptr<TextureComponent> &tex);
+        // draws all the cells row by row and sets texture rows accordingly, as the matrix is at OnUpdate()
+        void AddTextures(const std::shared_ptr<ComponentMatrix<TextureComponent, ValueCellStorage>> &matrix);
         void SetTextureRows(unsigned int rows);
+        // textures to be drawn by the next OnUpdate()
+        size_t GetQueuedTexturesNum() const;
 
         void OnUpdate() override;
     };
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace GameEngine
+{
+    // Copy-on-write list of weak subscribers.
+    // ForEach() walks an immutable snapshot: it never locks nor allocates and the list may be changed
+    // meanwhile from any thread, including the subscribers being called (they see the change from the next ForEach()).
+    // Changes copy the snapshot under a writers' lock and publish the copy atomically; replaced snapshots
+    // are freed once no ForEach() is running (RCU-style). Expired subscribers are dropped on the next change
+    // or by Compact()
+    template <typename Subscriber>
+    class SubscriberList
+    {
+    private:
+        using Snapshot = std::vector<std::weak_ptr<Subscriber>>;
+
+        std::atomic<const Snapshot*> m_current;
+        std::atomic<size_t> m_activeReaders = 0;
+        std::atomic<bool> m_hasExpired = false;
+        std::atomic<bool> m_hasRetired = false;
+
+        std::mutex m_writeLock;
+        std::vector<std::unique_ptr<const Snapshot>> m_retired; // replaced, possibly still being read
+
+    public:
+        SubscriberList()
+            : m_current(new Snapshot())
+        {
+        }
+
+        SubscriberList(const SubscriberList&) = delete;
+        SubscriberList& operator=(const SubscriberList&) = delete;
+
+        ~SubscriberList()
+        {
+            delete m_current.load();
+        }
+
+        void Add(const std::shared_ptr<Subscriber>& sub)
+        {
+            modify([&sub](Snapshot& subscribers)
+            {
+                subscribers.push_back(sub);
+            });
+        }
+
+        void Remove(const std::shared_ptr<Subscriber>& sub)
+        {
+            modify([&sub](Snapshot& subscribers)
+            {
+                std::erase_if(subscribers, [&sub](const std::weak_ptr<Subscriber>& wp)
+                {
+                    return !sub.owner_before(wp) && !wp.owner_before(sub);
+                });
+            });
+        }
+
+        // drops expired subscribers noticed by ForEach(), if any
+        void Compact()
+        {
+            if (m_hasExpired.load())
+            {
+                modify([](Snapshot&) {});
+            }
+        }
+
+        // calls f(Subscriber&) for every alive subscriber
+        template <typename F>
+        void ForEach(F&& f)
+        {
+            const ReadGuard guard(*this);
+            for (const auto& wp : *m_current.load())
+            {
+                if (const auto sp = wp.lock())
+                {
+                    f(*sp);
+                }
+                else
+                {
+                    m_hasExpired.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_t GetSize()
+        {
+            const ReadGuard guard(*this);
+            return m_current.load()->size();
+        }
+
+    private:
+        struct ReadGuard
+        {
+            explicit ReadGuard(SubscriberList& list)
+                : m_list(list)
+            {
+                m_list.m_activeReaders.fetch_add(1);
+            }
+
+            ~ReadGuard()
+            {
+                if (m_list.m_activeReaders.fetch_sub(1) == 1 && m_list.m_hasRetired.load(std::memory_order_relaxed))
+                {
+                    m_list.try_reclaim();
+                }
+            }
+
+            SubscriberList& m_list;
+        };
+
+        template <typename F>
+        void modify(F&& change)
+        {
+            {
+                const std::scoped_lock lock(m_writeLock);
+                auto copy = std::make_unique<Snapshot>();
+                const auto* current = m_current.load();
+                copy->reserve(current->size() + 1);
+                std::copy_if(current->begin(), current->end(), std::back_inserter(*copy),
+                    [](const std::weak_ptr<Subscriber>& wp) { return !wp.expired(); });
+                // cleared before publishing: readers of the copy report the subscribers expiring later
+                m_hasExpired.store(false);
+                change(*copy);
+                m_retired.reserve(m_retired.size() + 1);
+                m_retired.emplace_back(m_current.exchange(copy.release()));
+                m_hasRetired.store(true);
+            }
+            try_reclaim();
+        }
+
+        // Frees replaced snapshots if nobody reads: a reader starting after the check loads the current
+        // snapshot, which is never retired. Gives up instead of waiting for the writers' lock
+        void try_reclaim()
+        {
+            const std::unique_lock lock(m_writeLock, std::try_to_lock);
+            if (lock.owns_lock() && m_activeReaders.load() == 0)
+            {
+                m_retired.clear();
+                m_hasRetired.store(false);
+            }
+        }
+    };
+} // namespace GameEngine
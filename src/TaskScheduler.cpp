@@ -0,0 +1,135 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace GameEngine
+{
+    TaskId TaskScheduler::Add(Step step, TaskPriority priority)
+    {
+        m_tasks.push_back({ ++m_lastId, priority, m_runsNum, m_stepsNum, std::move(step) });
+        return m_lastId;
+    }
+
+    void TaskScheduler::Cancel(TaskId id)
+    {
+        for (auto &task : m_tasks)
+        {
+            if (task.id == id)
+            {
+                // removed after the run, the steps may be iterating
+                task.id = 0;
+                m_hasRemoved = true;
+                return;
+            }
+        }
+    }
+
+    bool TaskScheduler::Contains(TaskId id) const
+    {
+        return id && std::any_of(m_tasks.begin(), m_tasks.end(), [id](const Task &task) { return task.id == id; });
+    }
+
+    size_t TaskScheduler::GetCount() const
+    {
+        return static_cast<size_t>(std::count_if(m_tasks.begin(), m_tasks.end(), [](const Task &task) { return task.id != 0; }));
+    }
+
+    void TaskScheduler::Run(std::chrono::nanoseconds budget)
+    {
+        ++m_runsNum;
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + budget;
+        m_lastStats = {};
+        m_lastStats.budgetNs = static_cast<uint64_t>(std::max<int64_t>(0, budget.count()));
+        for (auto index = pick(true); index < m_tasks.size(); index = pick(true))
+        {
+            step(index);
+        }
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            const auto index = pick(false);
+            if (index == m_tasks.size())
+            {
+                break;
+            }
+            step(index);
+        }
+        if (m_hasRemoved)
+        {
+            std::erase_if(m_tasks, [](const Task &task) { return !task.id; });
+            m_hasRemoved = false;
+        }
+        m_lastStats.usedNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        m_lastStats.pending = m_tasks.size();
+    }
+
+    const TaskStats &TaskScheduler::GetLastStats() const
+    {
+        return m_lastStats;
+    }
+
+    size_t TaskScheduler::pick(bool isStarvingOnly) const
+    {
+        auto best = m_tasks.size();
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+        {
+            const auto &task = m_tasks[i];
+            if (!task.id || (isStarvingOnly && !is_starving(task)))
+            {
+                continue;
+            }
+            if (best == m_tasks.size())
+            {
+                best = i;
+                continue;
+            }
+            const auto &other = m_tasks[best];
+            if (task.priority > other.priority || (task.priority == other.priority && task.lastStep < other.lastStep))
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    bool TaskScheduler::is_starving(const Task &task) const
+    {
+        return m_runsNum - task.lastRun > StarvationRuns;
+    }
+
+    void TaskScheduler::step(size_t index)
+    {
+        const auto id = m_tasks[index].id;
+        m_tasks[index].lastRun = m_runsNum;
+        m_tasks[index].lastStep = ++m_stepsNum;
+        // the step may add tasks, moving the vector
+        auto step = std::move(m_tasks[index].step);
+        bool isDone = false;
+        try
+        {
+            isDone = step();
+        }
+        catch (...)
+        {
+            // a failed task isn't stepped again
+            m_tasks[index].id = 0;
+            m_hasRemoved = true;
+            throw;
+        }
+        ++m_lastStats.steps;
+        auto &task = m_tasks[index];
+        if (task.id != id)
+        {
+            return; // cancelled by itself
+        }
+        if (isDone)
+        {
+            task.id = 0;
+            m_hasRemoved = true;
+            ++m_lastStats.completed;
+            return;
+        }
+        task.step = std::move(step);
+    }
+} // namespace GameEngine
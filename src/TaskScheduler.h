@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace GameEngine
+{
+    enum class TaskPriority : uint8_t
+    {
+        LOW,
+        NORMAL,
+        HIGH,
+    };
+
+    // 0 - none
+    using TaskId = uint32_t;
+
+    struct TaskStats
+    {
+        uint64_t budgetNs = 0;
+        uint64_t usedNs = 0;
+        size_t steps = 0;
+        size_t completed = 0;
+        size_t pending = 0; // tasks left after the run
+    };
+
+    // Resumable work of the game thread, e.g. pathfinding or cache rebuilds, run in the time left over by a frame.
+    // A task is a step function called until it returns true (done); every step is expected to be short,
+    // the budget is checked between steps. Ready steps are picked by priority, round-robin within a priority.
+    // A task passed over for StarvationRuns runs gets a step first, even when the run has no budget left
+    class TaskScheduler
+    {
+    public:
+        using Step = std::function<bool()>;
+
+        static constexpr uint64_t StarvationRuns = 30;
+
+        TaskId Add(Step step, TaskPriority priority = TaskPriority::NORMAL);
+        // may be called by a step, e.g. to cancel itself
+        void Cancel(TaskId id);
+        bool Contains(TaskId id) const;
+        size_t GetCount() const;
+
+        // runs steps until the budget is used or no task is left
+        void Run(std::chrono::nanoseconds budget);
+
+        const TaskStats &GetLastStats() const;
+
+    private:
+        struct Task
+        {
+            TaskId id;
+            TaskPriority priority;
+            uint64_t lastRun; // m_runsNum of the last step
+            uint64_t lastStep; // m_stepsNum of the last step, for round-robin
+            Step step;
+        };
+
+        // index of the task to step next, m_tasks.size() - none
+        size_t pick(bool isStarvingOnly) const;
+        bool is_starving(const Task &task) const;
+        void step(size_t index);
+
+        std::vector<Task> m_tasks;
+        TaskId m_lastId = 0;
+        uint64_t m_runsNum = 0;
+        uint64_t m_stepsNum = 0;
+        bool m_hasRemoved = false;
+        TaskStats m_lastStats;
+    };
+} // namespace GameEngine
@@ -9,25 +9,29 @@ namespace GameEngine {
 
     /// Nested class
     TextureComponent::SDLHandle::SDLHandle(SDL_Renderer *renderer, const std::string &image)
-        : m_texture(IMG_LoadTexture(renderer, image.c_str())){
-        EXPECT_SDL(m_texture, "Unable to create texture");
+        : m_texture(renderer ? IMG_LoadTexture(renderer, image.c_str()) : nullptr){
+        // no renderer: headless, nothing is loaded
+        EXPECT_SDL(m_texture || !renderer, "Unable to create texture");
     }
 
     TextureComponent::SDLHandle::SDLHandle(SDL_Renderer *renderer, const Size2D &size)
-            : m_texture(
+            : m_texture(!renderer ? nullptr :
             SDL_CreateTexture(
                     renderer,
                     SDL_PixelFormatEnum::SDL_PIXELFORMAT_RGBA32, // todo: parameterize?
                     SDL_TextureAccess::SDL_TEXTUREACCESS_STATIC, // todo: parameterize?
                     size.w,
                     size.h
-            ))
+            )),
+            m_size(size)
     {
-        EXPECT_SDL(m_texture, "Unable to create texture");
+        EXPECT_SDL(m_texture || !renderer, "Unable to create texture");
     }
 
     TextureComponent::SDLHandle::~SDLHandle() {
-        SDL_DestroyTexture(m_texture);
+        if (m_texture) {
+            SDL_DestroyTexture(m_texture);
+        }
     }
 
     /// Texture class
@@ -41,16 +45,19 @@ namespace GameEngine {
 
     void TextureComponent::SetColorMode(const RGBColor &rgb) const
     {
+        if (!m_sdlHandle.m_texture) return; // headless
         EXPECT_SDL(SDL_SetTextureColorMod(m_sdlHandle.m_texture, rgb.r, rgb.g, rgb.b) == 0,
                "Unable to set color mode");
     }
 
     void TextureComponent::SetAlphaMode(uint8_t alpha) const {
+        if (!m_sdlHandle.m_texture) return; // headless
         EXPECT_SDL(SDL_SetTextureAlphaMod(m_sdlHandle.m_texture, alpha) == 0,
                "Unable to set alpha mode");
     }
 
     void TextureComponent::SetPixelData(const std::vector<uint8_t> &pixelData) const {
+        if (!m_sdlHandle.m_texture) return; // headless
         // todo: parameterize pitch?
         EXPECT_SDL(SDL_UpdateTexture(m_sdlHandle.m_texture,
                                  nullptr, // update whole texture
@@ -62,6 +69,9 @@ namespace GameEngine {
 
 
     Size2D TextureComponent::GetSize() const {
+        if (!m_sdlHandle.m_texture) {
+            return m_sdlHandle.m_size; // headless: the requested size, unknown for images
+        }
         // get texture w/h
         int w, h;
         EXPECT_SDL(SDL_QueryTexture(m_sdlHandle.m_texture,
@@ -13,7 +13,8 @@ namespace GameEngine
     private:
         // intermediate class to isolate SDL properties from Window's direct access
         class SDLHandle {
-            SDL_Texture *m_texture = nullptr;
+            SDL_Texture *m_texture = nullptr; // null in headless mode
+            Size2D m_size;
             explicit SDLHandle(SDL_Renderer *renderer, const std::string &image);
             explicit SDLHandle(SDL_Renderer *renderer, const Size2D &size);
             ~SDLHandle();
@@ -2,8 +2,62 @@
 #include "TransformComponent.h"
 #include "ErrorHandling.h"
 
+#include <vector>
+
 namespace GameEngine {
 
+    // transforms changed this frame
+    static thread_local ChangedTransforms g_changedTransforms;
+
+    ChangedTransforms::~ChangedTransforms() {
+        Clear();
+    }
+
+    std::span<TransformComponent *const> ChangedTransforms::Get() const {
+        return m_transforms;
+    }
+
+    void ChangedTransforms::Clear() {
+        const std::scoped_lock lock(m_lock);
+        for (auto *transform : m_transforms) {
+            transform->m_changedIdx = TransformComponent::NotChanged;
+            transform->m_changedList = nullptr;
+        }
+        // capacity is kept: steady frames don't allocate
+        m_transforms.clear();
+    }
+
+    void ChangedTransforms::MoveTo(ChangedTransforms &other) {
+        if (&other == this) {
+            return;
+        }
+        const std::scoped_lock lock(m_lock, other.m_lock);
+        for (auto *transform : m_transforms) {
+            transform->m_changedIdx = other.m_transforms.size();
+            transform->m_changedList = &other;
+            other.m_transforms.push_back(transform);
+        }
+        m_transforms.clear();
+    }
+
+    void ChangedTransforms::add(TransformComponent &transform) {
+        const std::scoped_lock lock(m_lock);
+        transform.m_changedIdx = m_transforms.size();
+        transform.m_changedList = this;
+        m_transforms.push_back(&transform);
+    }
+
+    void ChangedTransforms::remove(TransformComponent &transform) {
+        const std::scoped_lock lock(m_lock);
+        // swap with the last one to keep the list compact
+        auto *last = m_transforms.back();
+        m_transforms[transform.m_changedIdx] = last;
+        last->m_changedIdx = transform.m_changedIdx;
+        m_transforms.pop_back();
+        transform.m_changedIdx = TransformComponent::NotChanged;
+        transform.m_changedList = nullptr;
+    }
+
     TransformComponent::SDLHandle::SDLHandle(const Size2D &size) {
         m_rect.w = size.w;
         m_rect.h = size.h;
@@ -22,37 +76,66 @@ namespace GameEngine {
             reset();
         }
 
+    TransformComponent::~TransformComponent() {
+        if (m_hierarchy) {
+            m_hierarchy->release(m_node);
+        }
+        if (m_changedList) {
+            m_changedList->remove(*this);
+        }
+    }
+
     void TransformComponent::SetPosition(const Pos2D &pos) {
+        if (m_hierarchy) {
+            m_hierarchy->set_local_pos(m_node, pos);
+            return;
+        }
         m_sdlHandle.m_rect.x = pos.x;
         m_sdlHandle.m_rect.y = pos.y;
+        touch();
     }
 
     void TransformComponent::Move(const Pos2D &pos) {
-        m_sdlHandle.m_rect.x += pos.x;
-        m_sdlHandle.m_rect.y += pos.y;
+        const auto current = GetPosition();
+        SetPosition(Pos2D{current.x + pos.x, current.y + pos.y});
     }
 
     Pos2D TransformComponent::GetPosition() const {
+        if (m_hierarchy) {
+            return m_hierarchy->get_local_pos(m_node);
+        }
         return {m_sdlHandle.m_rect.x, m_sdlHandle.m_rect.y};
     }
 
+    Pos2D TransformComponent::GetWorldPosition() const {
+        const auto rect = get_rect();
+        return {rect->x, rect->y};
+    }
+
     Size2D TransformComponent::GetSize() const {
         return {m_sdlHandle.m_rect.w, m_sdlHandle.m_rect.h};
     }
 
     Rect TransformComponent::GetRect() const {
-        return {m_sdlHandle.m_rect.x,
-                m_sdlHandle.m_rect.y,
+        const auto pos = GetPosition();
+        return {pos.x,
+                pos.y,
                 m_sdlHandle.m_rect.w,
                 m_sdlHandle.m_rect.h};
     }
 
+    Rect TransformComponent::GetWorldRect() const {
+        const auto rect = get_rect();
+        return {rect->x, rect->y, rect->w, rect->h};
+    }
+
     void TransformComponent::Resize(const Size2D &size) {
         EXPECT_MSG(size.w >= 0 && size.h >= 0,
                    "Resize impossible: invalid dimensions");
         m_sdlHandle.m_rect.w = size.w;
         m_sdlHandle.m_rect.h = size.h;
         m_sdlHandle.reset_center();
+        touch_center();
     }
 
     void TransformComponent::Downscale(int factor) {
@@ -60,6 +143,7 @@ namespace GameEngine {
         m_sdlHandle.m_rect.w /= factor;
         m_sdlHandle.m_rect.h /= factor;
         m_sdlHandle.reset_center();
+        touch_center();
     }
 
     void TransformComponent::Upscale(int factor) {
@@ -67,35 +151,51 @@ namespace GameEngine {
         m_sdlHandle.m_rect.w *= factor;
         m_sdlHandle.m_rect.h *= factor;
         m_sdlHandle.reset_center();
+        touch_center();
     }
 
     void TransformComponent::SetCenter(const Pos2D &center) {
         m_sdlHandle.m_center.x = center.x;
         m_sdlHandle.m_center.y = center.y;
+        touch_center();
     }
 
     void TransformComponent::SetAngle(double angle) {
+        if (m_hierarchy) {
+            m_hierarchy->set_local_angle(m_node, std::fmod(angle, 360.0));
+            return;
+        }
         m_sdlHandle.m_angle = std::fmod(angle, 360.0);
+        touch();
     }
 
     void TransformComponent::Rotate(double angle) {
-        m_sdlHandle.m_angle = std::fmod(m_sdlHandle.m_angle + angle, 360.0);
+        SetAngle(GetAngle() + angle);
     }
 
     double TransformComponent::GetAngle() const {
+        if (m_hierarchy) {
+            return m_hierarchy->get_local_angle(m_node);
+        }
         return m_sdlHandle.m_angle;
     }
 
+    double TransformComponent::GetWorldAngle() const {
+        return get_angle();
+    }
+
     Pos2D TransformComponent::GetCenter() const {
         return {m_sdlHandle.m_center.x, m_sdlHandle.m_center.y};
     }
 
     void TransformComponent::FlipVertically() {
         m_sdlHandle.m_flip = static_cast<SDL_RendererFlip>(m_sdlHandle.m_flip ^ SDL_FLIP_VERTICAL);
+        touch();
     }
 
     void TransformComponent::FlipHorizontally() {
         m_sdlHandle.m_flip = static_cast<SDL_RendererFlip>(m_sdlHandle.m_flip ^ SDL_FLIP_HORIZONTAL);
+        touch();
     }
 
     bool TransformComponent::IsFlippedVertically() const {
@@ -106,15 +206,55 @@ namespace GameEngine {
         return m_sdlHandle.m_flip & SDL_FLIP_HORIZONTAL;
     }
 
+    uint64_t TransformComponent::GetVersion() const {
+        // changes inherited from the parent are counted when resolved
+        if (m_hierarchy) {
+            m_hierarchy->resolve();
+        }
+        return m_version;
+    }
+
+    bool TransformComponent::IsChanged() const {
+        if (m_hierarchy) {
+            m_hierarchy->resolve();
+        }
+        return m_changedIdx != NotChanged;
+    }
+
+    std::span<TransformComponent *const> TransformComponent::GetChanged() {
+        // the descendants of the changed transforms get listed once resolved, the list grows meanwhile
+        auto &transforms = g_changedTransforms.m_transforms;
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            if (const auto &hierarchy = transforms[i]->m_hierarchy) {
+                hierarchy->resolve();
+            }
+        }
+        return g_changedTransforms.Get();
+    }
+
+    void TransformComponent::ClearChanged() {
+        g_changedTransforms.Clear();
+    }
+
+    ChangedTransforms &TransformComponent::GetChangedList() {
+        return g_changedTransforms;
+    }
+
     const SDL_Point *TransformComponent::get_center() const {
         return &m_sdlHandle.m_center;
     }
 
     const SDL_Rect *TransformComponent::get_rect() const {
+        if (m_hierarchy) {
+            m_hierarchy->resolve();
+        }
         return &m_sdlHandle.m_rect;
     }
 
     double TransformComponent::get_angle() const {
+        if (m_hierarchy) {
+            m_hierarchy->resolve();
+        }
         return m_sdlHandle.m_angle;
     }
 
@@ -122,6 +262,22 @@ namespace GameEngine {
         return m_sdlHandle.m_flip;
     }
 
+    void TransformComponent::touch() {
+        ++m_version;
+        if (!m_changedList) {
+            g_changedTransforms.add(*this);
+        }
+    }
+
+    void TransformComponent::touch_center() {
+        if (m_hierarchy) {
+            // children turn around the center: their world positions change
+            m_hierarchy->mark_dirty(m_node);
+            return;
+        }
+        touch();
+    }
+
     void TransformComponent::reset() {
         m_sdlHandle.reset_center();
         m_sdlHandle.m_angle = 0.0;
@@ -3,9 +3,42 @@
 
 #include "sdl.h"
 #include "IGameObjectComponent.h"
+#include "TransformHierarchy.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
 
 namespace GameEngine {
 
+    class TransformComponent;
+
+    /// Transforms changed since the last Clear(), each listed once.
+    /// Every thread has its own list taking the transforms it changes. A listed transform remembers its list,
+    /// so it leaves the right one when destroyed by another thread
+    class ChangedTransforms {
+    public:
+        ChangedTransforms() = default;
+        ChangedTransforms(const ChangedTransforms &) = delete;
+        ChangedTransforms &operator=(const ChangedTransforms &) = delete;
+        ~ChangedTransforms(); // unlists the transforms, e.g. when a thread ends
+
+        std::span<TransformComponent *const> Get() const; // by the owning thread
+        void Clear();
+        void MoveTo(ChangedTransforms &other); // appends the transforms to the other list, this one gets empty
+
+    private:
+        void add(TransformComponent &transform);
+        void remove(TransformComponent &transform);
+
+        mutable std::mutex m_lock; // taken by the first change of a transform in a frame, not by every change
+        std::vector<TransformComponent *> m_transforms;
+        friend class TransformComponent;
+    };
+
     class TransformComponent : public IGameObjectComponent {
     private:
         class SDLHandle {
@@ -18,17 +51,30 @@ namespace GameEngine {
             ~SDLHandle() = default;
             void reset_center();
             friend class TransformComponent;
+            friend class TransformHierarchy;
         };
 
-        SDLHandle m_sdlHandle;
+        SDLHandle m_sdlHandle; // world position and angle
+        // set when the transform is a part of parent/child tree
+        std::shared_ptr<TransformHierarchy> m_hierarchy;
+        size_t m_node = 0;
+        // change tracking
+        static constexpr size_t NotChanged = std::numeric_limits<size_t>::max();
+        uint64_t m_version = 0;
+        size_t m_changedIdx = NotChanged; // position in the changed list
+        ChangedTransforms *m_changedList = nullptr; // the list the transform is in
 
         const SDL_Point *get_center() const;
         const SDL_Rect *get_rect() const;
         double get_angle() const;
         SDL_RendererFlip get_flip() const;
         void reset();
+        void touch(); // bumps the version and lists the transform as changed
+        void touch_center(); // the size or the center has changed
         friend class RendererComponent;
         friend class GameObject;
+        friend class TransformHierarchy;
+        friend class ChangedTransforms;
     protected:
         explicit TransformComponent(const Size2D &size = {});
     public:
@@ -36,13 +82,16 @@ namespace GameEngine {
         TransformComponent &operator=(const TransformComponent &) = delete;
         TransformComponent(TransformComponent &&) = delete;
         TransformComponent &operator=(TransformComponent &&) = delete;
-        ~TransformComponent() = default;
+        ~TransformComponent();
 
+        /// Position and angle are local (relative to the parent) for children
         void SetPosition(const Pos2D &pos);
         void Move(const Pos2D &pos); // similar to SetPosition() but with relative coordinates
         Pos2D GetPosition() const;
+        Pos2D GetWorldPosition() const;
         Size2D GetSize() const;
         Rect GetRect() const;
+        Rect GetWorldRect() const;
         void Resize(const Size2D &size);
         void Downscale(int factor);
         void Upscale(int factor);
@@ -50,12 +99,24 @@ namespace GameEngine {
         void SetAngle(double angle); // set angle (absolute)
         void Rotate(double angle); // similar to SetAngle() but angle is relative to the current one
         double GetAngle() const;
+        double GetWorldAngle() const;
         Pos2D GetCenter() const;
         void FlipVertically();
         void FlipHorizontally();
         bool IsFlippedVertically() const;
         bool IsFlippedHorizontally() const;
 
+        /// Incremented by every mutation, including world changes inherited from the parent
+        uint64_t GetVersion() const;
+        bool IsChanged() const; // changed since the last ClearChanged()
+
+        /// Transforms of the calling thread changed since the last ClearChanged(), each listed once.
+        /// Lets systems process O(changed) objects instead of O(all). Children of the changed transforms
+        /// are listed when their world transforms are resolved, at the latest by this call
+        static std::span<TransformComponent *const> GetChanged();
+        static void ClearChanged(); // called by GameLoop at the end of every frame
+        static ChangedTransforms &GetChangedList(); // of the calling thread
+
         void OnUpdate() override {};
 
     };
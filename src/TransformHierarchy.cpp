@@ -0,0 +1,238 @@
+
+#include "TransformHierarchy.h"
+#include "TransformComponent.h"
+#include "ErrorHandling.h"
+
+#include <cmath>
+#include <numbers>
+
+namespace GameEngine {
+
+    void TransformHierarchy::append_root(TransformComponent &transform) {
+        const auto &handle = transform.m_sdlHandle;
+        m_transforms.push_back(&transform);
+        m_parents.push_back(NoParent);
+        m_subtreeSizes.push_back(1);
+        m_localPos.push_back({handle.m_rect.x, handle.m_rect.y});
+        m_localAngle.push_back(handle.m_angle);
+        m_worldPos.push_back({handle.m_rect.x, handle.m_rect.y});
+        m_worldAngle.push_back(handle.m_angle);
+        m_dirty.push_back(0);
+    }
+
+    void TransformHierarchy::Attach(TransformComponent &parent, TransformComponent &child) {
+        EXPECT_MSG(!child.m_hierarchy || child.m_node == 0, "Transform already has a parent");
+        EXPECT_MSG(!child.m_hierarchy || child.m_hierarchy != parent.m_hierarchy, "Cyclic transform hierarchy");
+
+        if (!parent.m_hierarchy) {
+            parent.m_hierarchy = std::make_shared<TransformHierarchy>();
+            parent.m_hierarchy->append_root(parent);
+            parent.m_node = 0;
+        }
+        auto &hierarchy = *parent.m_hierarchy;
+
+        // child's tree flattened the same way
+        TransformHierarchy single;
+        const auto child_hierarchy = child.m_hierarchy; // alive until its transforms are repointed
+        if (!child_hierarchy) {
+            single.append_root(child);
+        }
+        const auto &subtree = child_hierarchy ? *child_hierarchy : single;
+        const auto count = subtree.m_transforms.size();
+        const auto parent_node = parent.m_node;
+        // the subtree is inserted right after the parent's last descendant
+        const auto pos = parent_node + hierarchy.m_subtreeSizes[parent_node];
+
+        for (auto &p : hierarchy.m_parents) {
+            if (p != NoParent && p >= pos) {
+                p += count;
+            }
+        }
+        hierarchy.m_transforms.insert(hierarchy.m_transforms.begin() + pos, subtree.m_transforms.begin(), subtree.m_transforms.end());
+        hierarchy.m_parents.insert(hierarchy.m_parents.begin() + pos, count, parent_node);
+        for (size_t i = 1; i < count; ++i) {
+            hierarchy.m_parents[pos + i] = subtree.m_parents[i] + pos;
+        }
+        hierarchy.m_subtreeSizes.insert(hierarchy.m_subtreeSizes.begin() + pos, subtree.m_subtreeSizes.begin(), subtree.m_subtreeSizes.end());
+        hierarchy.m_localPos.insert(hierarchy.m_localPos.begin() + pos, subtree.m_localPos.begin(), subtree.m_localPos.end());
+        hierarchy.m_localAngle.insert(hierarchy.m_localAngle.begin() + pos, subtree.m_localAngle.begin(), subtree.m_localAngle.end());
+        hierarchy.m_worldPos.insert(hierarchy.m_worldPos.begin() + pos, subtree.m_worldPos.begin(), subtree.m_worldPos.end());
+        hierarchy.m_worldAngle.insert(hierarchy.m_worldAngle.begin() + pos, subtree.m_worldAngle.begin(), subtree.m_worldAngle.end());
+        hierarchy.m_dirty.insert(hierarchy.m_dirty.begin() + pos, count, 0);
+
+        for (auto node = parent_node; node != NoParent; node = hierarchy.m_parents[node]) {
+            hierarchy.m_subtreeSizes[node] += count;
+        }
+        for (auto i = pos; i < hierarchy.m_transforms.size(); ++i) {
+            if (auto *transform = hierarchy.m_transforms[i]) {
+                transform->m_hierarchy = parent.m_hierarchy;
+                transform->m_node = i;
+            }
+        }
+        // the whole subtree is recomputed relative to the new parent
+        hierarchy.mark_dirty(pos);
+    }
+
+    void TransformHierarchy::Detach(TransformComponent &child) {
+        EXPECT_MSG(child.m_hierarchy && child.m_node != 0, "Transform has no parent");
+
+        const auto hierarchy_ptr = child.m_hierarchy; // alive until its transforms are repointed
+        auto &hierarchy = *hierarchy_ptr;
+        hierarchy.resolve();
+        const auto node = child.m_node;
+        const auto count = hierarchy.m_subtreeSizes[node];
+        const auto end = node + count;
+
+        // the subtree becomes a hierarchy of its own, the world transform of its root becomes local
+        std::shared_ptr<TransformHierarchy> subtree;
+        if (count > 1) {
+            subtree = std::make_shared<TransformHierarchy>();
+            const auto first = static_cast<std::ptrdiff_t>(node);
+            const auto last = static_cast<std::ptrdiff_t>(end);
+            subtree->m_transforms.assign(hierarchy.m_transforms.begin() + first, hierarchy.m_transforms.begin() + last);
+            subtree->m_parents.assign(hierarchy.m_parents.begin() + first, hierarchy.m_parents.begin() + last);
+            for (auto &p : subtree->m_parents) {
+                p -= node;
+            }
+            subtree->m_parents[0] = NoParent;
+            subtree->m_subtreeSizes.assign(hierarchy.m_subtreeSizes.begin() + first, hierarchy.m_subtreeSizes.begin() + last);
+            subtree->m_localPos.assign(hierarchy.m_localPos.begin() + first, hierarchy.m_localPos.begin() + last);
+            subtree->m_localPos[0] = hierarchy.m_worldPos[node];
+            subtree->m_localAngle.assign(hierarchy.m_localAngle.begin() + first, hierarchy.m_localAngle.begin() + last);
+            subtree->m_localAngle[0] = hierarchy.m_worldAngle[node];
+            subtree->m_worldPos.assign(hierarchy.m_worldPos.begin() + first, hierarchy.m_worldPos.begin() + last);
+            subtree->m_worldAngle.assign(hierarchy.m_worldAngle.begin() + first, hierarchy.m_worldAngle.begin() + last);
+            subtree->m_dirty.assign(count, 0);
+        }
+        for (auto i = node; i < end; ++i) {
+            if (auto *transform = hierarchy.m_transforms[i]) {
+                // a single transform keeps its world transform in the SDL handle
+                transform->m_hierarchy = subtree;
+                transform->m_node = i - node;
+            }
+        }
+
+        for (auto p = hierarchy.m_parents[node]; p != NoParent; p = hierarchy.m_parents[p]) {
+            hierarchy.m_subtreeSizes[p] -= count;
+        }
+        const auto erase = [node, end](auto &values) {
+            values.erase(values.begin() + static_cast<std::ptrdiff_t>(node), values.begin() + static_cast<std::ptrdiff_t>(end));
+        };
+        erase(hierarchy.m_transforms);
+        erase(hierarchy.m_parents);
+        erase(hierarchy.m_subtreeSizes);
+        erase(hierarchy.m_localPos);
+        erase(hierarchy.m_localAngle);
+        erase(hierarchy.m_worldPos);
+        erase(hierarchy.m_worldAngle);
+        erase(hierarchy.m_dirty);
+        for (auto &p : hierarchy.m_parents) {
+            if (p != NoParent && p >= end) {
+                p -= count;
+            }
+        }
+        for (auto i = node; i < hierarchy.m_transforms.size(); ++i) {
+            if (auto *transform = hierarchy.m_transforms[i]) {
+                transform->m_node = i;
+            }
+        }
+    }
+
+    size_t TransformHierarchy::GetSize() const {
+        return m_transforms.size();
+    }
+
+    void TransformHierarchy::mark_dirty(size_t node) {
+        m_dirty[node] = 1;
+        m_hasDirty = true;
+        // the descendants are touched once resolved: repeated changes of a parent don't walk its subtree
+        if (auto *transform = m_transforms[node]) {
+            transform->touch();
+        }
+    }
+
+    const Pos2D &TransformHierarchy::get_local_pos(size_t node) const {
+        return m_localPos[node];
+    }
+
+    void TransformHierarchy::set_local_pos(size_t node, const Pos2D &pos) {
+        m_localPos[node] = pos;
+        mark_dirty(node);
+    }
+
+    double TransformHierarchy::get_local_angle(size_t node) const {
+        return m_localAngle[node];
+    }
+
+    void TransformHierarchy::set_local_angle(size_t node, double angle) {
+        m_localAngle[node] = angle;
+        mark_dirty(node);
+    }
+
+    void TransformHierarchy::resolve() {
+        if (!m_hasDirty) {
+            return;
+        }
+        const auto size = m_transforms.size();
+        for (size_t node = 0; node < size;) {
+            if (!m_dirty[node]) {
+                ++node;
+                continue;
+            }
+            // parents precede children: the whole subtree is one contiguous range
+            const auto end = node + m_subtreeSizes[node];
+            for (auto i = node; i < end; ++i) {
+                const auto parent = m_parents[i];
+                if (parent == NoParent) {
+                    m_worldPos[i] = m_localPos[i];
+                    m_worldAngle[i] = m_localAngle[i];
+                } else {
+                    m_worldPos[i] = get_world_pos(parent, i);
+                    m_worldAngle[i] = std::fmod(m_worldAngle[parent] + m_localAngle[i], 360.0);
+                }
+                m_dirty[i] = 0;
+                if (auto *transform = m_transforms[i]) {
+                    transform->m_sdlHandle.m_rect.x = m_worldPos[i].x;
+                    transform->m_sdlHandle.m_rect.y = m_worldPos[i].y;
+                    transform->m_sdlHandle.m_angle = m_worldAngle[i];
+                    if (i != node) {
+                        // inherited change, the changed node itself is touched by its mutation
+                        transform->touch();
+                    }
+                }
+            }
+            node = end;
+        }
+        m_hasDirty = false;
+    }
+
+    Pos2D TransformHierarchy::get_center(size_t node) const {
+        const auto *transform = m_transforms[node];
+        return transform ? Pos2D{transform->m_sdlHandle.m_center.x, transform->m_sdlHandle.m_center.y} : Pos2D{};
+    }
+
+    Pos2D TransformHierarchy::get_world_pos(size_t parent, size_t node) const {
+        const auto &parentPos = m_worldPos[parent];
+        const auto &localPos = m_localPos[node];
+        const auto angle = m_worldAngle[parent];
+        if (angle == 0.0) {
+            return {parentPos.x + localPos.x, parentPos.y + localPos.y};
+        }
+        // SDL turns every texture around its own center, so the child's center circles the parent's one
+        // (clockwise for positive angles, as y goes down)
+        const auto parentCenter = get_center(parent);
+        const auto center = get_center(node);
+        const auto radians = angle * std::numbers::pi / 180.0;
+        const auto cos = std::cos(radians);
+        const auto sin = std::sin(radians);
+        const double dx = localPos.x + center.x - parentCenter.x;
+        const double dy = localPos.y + center.y - parentCenter.y;
+        return {parentPos.x + parentCenter.x - center.x + static_cast<int>(std::lround(dx * cos - dy * sin)),
+                parentPos.y + parentCenter.y - center.y + static_cast<int>(std::lround(dx * sin + dy * cos))};
+    }
+
+    void TransformHierarchy::release(size_t node) {
+        m_transforms[node] = nullptr;
+    }
+
+} // GameEngine
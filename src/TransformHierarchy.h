@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+
+    class TransformComponent;
+
+    // Transforms of a parent/child tree flattened in depth-first order.
+    // Every node precedes its subtree, so world transforms are resolved by a linear sweep
+    // which recomputes dirty subtrees only. A change lists only the changed node, its descendants are touched
+    // (version bumped, listed as changed) when the subtree is resolved.
+    // A child turns with its parent: its local position is rotated by the parent's world angle around the parent's center
+    class TransformHierarchy {
+    private:
+        static constexpr size_t NoParent = std::numeric_limits<size_t>::max();
+
+        std::vector<TransformComponent *> m_transforms; // nullptr if the transform is destroyed
+        std::vector<size_t> m_parents;
+        std::vector<size_t> m_subtreeSizes; // including the node itself
+        std::vector<Pos2D> m_localPos;
+        std::vector<double> m_localAngle;
+        std::vector<Pos2D> m_worldPos;
+        std::vector<double> m_worldAngle;
+        std::vector<uint8_t> m_dirty;
+        bool m_hasDirty = false;
+
+        void append_root(TransformComponent &transform);
+        void mark_dirty(size_t node);
+        Pos2D get_center(size_t node) const; // relative to the node's position
+        Pos2D get_world_pos(size_t parent, size_t node) const;
+
+        // accessed by TransformComponent
+        const Pos2D &get_local_pos(size_t node) const;
+        void set_local_pos(size_t node, const Pos2D &pos);
+        double get_local_angle(size_t node) const;
+        void set_local_angle(size_t node, double angle);
+        void resolve();
+        void release(size_t node);
+        friend class TransformComponent;
+    public:
+        TransformHierarchy() = default;
+        TransformHierarchy(const TransformHierarchy &) = delete;
+        TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+        // attaches child (with its own subtree, if any) to parent,
+        // child's current position and angle become local to the parent
+        static void Attach(TransformComponent &parent, TransformComponent &child);
+        // detaches child (with its subtree) from its parent, child keeps its world position and angle
+        static void Detach(TransformComponent &child);
+
+        size_t GetSize() const;
+    };
+
+} // GameEngine
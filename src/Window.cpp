@@ -5,6 +5,8 @@
 
 #define EXPECT_SDL(condition, message) \
     EXPECT_MSG(condition, message << ": " << SDL_GetError())
+#define EXPECT_SDL_FRAME(condition, message) \
+    EXPECT_FRAME_MSG(condition, message << ": " << SDL_GetError())
 
 namespace GameEngine 
 {
@@ -44,6 +46,14 @@ namespace GameEngine
         SDL_DestroyWindow(m_window);
     }
 
+    uint32_t Window::GetId() const {
+        return SDL_GetWindowID(m_window);
+    }
+
+    bool Window::HasRenderer() const {
+        return true;
+    }
+
     Size2D Window::get_size_generic(void (*sdl_func)(SDL_Window *, int *, int *)) const {
         int w, h;
         sdl_func(m_window, &w, &h);
@@ -117,13 +127,7 @@ namespace GameEngine
     }
 
     void Window::Clear() const {
-        EXPECT_SDL(SDL_RenderClear(m_renderer) == 0, "Unable to clear window");
-    }
-
-    void Window::Update() const {
-        for (const auto o : m_activeObjects) {
-            o->Update();
-        }
+        EXPECT_SDL_FRAME(SDL_RenderClear(m_renderer) == 0, "Unable to clear window");
     }
 
     void Window::Present() const {
@@ -134,51 +138,4 @@ namespace GameEngine
         return RenderContext(m_renderer);
     }
 
-    GameObjectId Window::AppendObject(const std::shared_ptr<IGameObject>& obj) {
-        return AppendObject(obj, false);
-    }
-
-    GameObjectId Window::AppendObject(const std::shared_ptr<IGameObject>& obj, bool active) {
-        auto it = m_gameObjects.emplace(m_objectsNum, obj);
-        if (it.second) {
-            auto obj_ptr = it.first->second.get();
-            obj_ptr->Awake(); // 'initialize' object
-
-            if (active) {
-                if (m_activeObjects.insert(obj_ptr).second) {
-                    obj_ptr->OnEnable(); // enable object
-                }
-            }
-            return m_objectsNum++;
-        }
-        return it.first->first;
-    }
-
-    void Window::RemoveObject(GameObjectId id) {
-        const auto &obj = m_gameObjects.find(id);
-        if (obj != m_gameObjects.end()) {
-           m_activeObjects.erase(obj->second.get());
-           m_gameObjects.erase(obj);
-           --m_objectsNum;
-        }
-    }
-
-    IGameObject *Window::GetObject(GameObjectId id) const {
-        return m_gameObjects.at(id).get();
-    }
-
-    void Window::SetObjectActive(GameObjectId id, bool active) {
-        auto it = m_gameObjects.find(id);
-        EXPECT_SDL(it != m_gameObjects.end(), "Game Object " + std::to_string(id) + " not found");
-        if (active) {
-            if (m_activeObjects.insert(it->second.get()).second) {
-                it->second->OnEnable(); // enable object
-            }
-        }else {
-            if (m_activeObjects.erase(it->second.get())) {
-                it->second->OnDisable(); // disable object
-            }
-        }
-    }
-
 } // namespace GameEngine
\ No newline at end of file
@@ -1,10 +1,8 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
 
-#include "IWindow.h"
+#include "WindowBase.h"
 #include "TextureComponent.h"
 #include "RenderContext.h"
 #include "GameObject.h"
@@ -13,12 +11,9 @@
 namespace GameEngine 
 {
     // Implementation Window
-    class Window : public IWindow {
+    class Window : public WindowBase {
         SDL_Window *m_window;
         SDL_Renderer *m_renderer;
-        std::unordered_map<GameObjectId, std::shared_ptr<IGameObject>> m_gameObjects; // all objects
-        std::unordered_set<IGameObject*> m_activeObjects; // objects to update
-        GameObjectId m_objectsNum = 0;
         // Private methods
         Size2D get_size_generic(void (*sdl_func)(SDL_Window *, int *, int *)) const;
         Pos2D get_pos_generic(void (*sdl_func)(SDL_Window *, int *, int *)) const;
@@ -33,6 +28,8 @@ namespace GameEngine
         Window &operator=(Window &&) = delete;
         ~Window();
 
+        uint32_t GetId() const override;
+        bool HasRenderer() const override;
         // Size
         void Resize(const Size2D &size) const override;
         // Position
@@ -51,16 +48,7 @@ namespace GameEngine
         void SetResizable(bool resizable) override;
         void SetAlwaysOnTop(bool on_top) override;
         void Clear() const override;
-        void Update() const override;
         void Present() const override;
         RenderContext GetRenderContext() const;
-        // Objects
-        GameObjectId AppendObject(const std::shared_ptr<IGameObject>& obj) override;
-
-        GameObjectId AppendObject(const std::shared_ptr<IGameObject>& obj, bool active) override;
-
-        void RemoveObject(GameObjectId id) override;
-        IGameObject *GetObject(GameObjectId id) const override;
-        void SetObjectActive(GameObjectId id, bool active) override;
     };
 };
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "ErrorHandling.h"
+#include "WindowBase.h"
+
+namespace GameEngine
+{
+    void WindowBase::Update(float elapsed) const {
+        m_activeObjects.Update(elapsed);
+    }
+
+    GameObjectId WindowBase::AppendObject(const std::shared_ptr<IGameObject>& obj) {
+        return AppendObject(obj, false);
+    }
+
+    GameObjectId WindowBase::AppendObject(const std::shared_ptr<IGameObject>& obj, bool active) {
+        auto it = m_gameObjects.emplace(m_objectsNum, obj);
+        if (it.second) {
+            auto obj_ptr = it.first->second.get();
+            obj_ptr->Awake(); // 'initialize' object
+
+            // inactive objects are scheduled as well: their settings are kept until activation
+            m_activeObjects.Add(obj_ptr, active);
+            if (active) {
+                obj_ptr->OnEnable(); // enable object
+            }
+            return m_objectsNum++;
+        }
+        return it.first->first;
+    }
+
+    void WindowBase::RemoveObject(GameObjectId id) {
+        const auto &obj = m_gameObjects.find(id);
+        if (obj != m_gameObjects.end()) {
+           m_activeObjects.Remove(obj->second.get());
+           m_gameObjects.erase(obj);
+           --m_objectsNum;
+        }
+    }
+
+    IGameObject *WindowBase::GetObject(GameObjectId id) const {
+        return m_gameObjects.at(id).get();
+    }
+
+    void WindowBase::SetObjectActive(GameObjectId id, bool active) {
+        auto *obj = get_object(id);
+        if (active) {
+            if (!m_activeObjects.IsActive(obj)) {
+                m_activeObjects.SetActive(obj, true);
+                obj->OnEnable(); // enable object
+            }
+        }else {
+            if (m_activeObjects.IsActive(obj)) {
+                // keeps the sleep state and the update interval
+                m_activeObjects.SetActive(obj, false);
+                obj->OnDisable(); // disable object
+            }
+        }
+    }
+
+    void WindowBase::SleepObject(GameObjectId id) {
+        m_activeObjects.Sleep(get_object(id));
+    }
+
+    void WindowBase::SleepObjectFor(GameObjectId id, uint32_t frames) {
+        m_activeObjects.SleepFor(get_object(id), frames);
+    }
+
+    void WindowBase::WakeObject(GameObjectId id) {
+        m_activeObjects.Wake(get_object(id));
+    }
+
+    void WindowBase::SetObjectUpdateInterval(GameObjectId id, uint32_t frames) {
+        m_activeObjects.SetUpdateInterval(get_object(id), frames);
+    }
+
+    bool WindowBase::IsIdle() const {
+        return m_activeObjects.IsIdle();
+    }
+
+    ObjectScheduler &WindowBase::GetScheduler() {
+        return m_activeObjects;
+    }
+
+    IGameObject *WindowBase::get_object(GameObjectId id) const {
+        auto it = m_gameObjects.find(id);
+        EXPECT_MSG(it != m_gameObjects.end(), "Game Object " + std::to_string(id) + " not found");
+        return it->second.get();
+    }
+
+    HeadlessWindow::HeadlessWindow(const Size2D &size)
+        : m_size(size)
+    {}
+
+    Size2D HeadlessWindow::GetSize() const {
+        return m_size;
+    }
+
+    Pos2D HeadlessWindow::GetPosition() const {
+        return m_pos;
+    }
+
+    void HeadlessWindow::Resize(const Size2D &size) const {
+        m_size = size;
+    }
+
+    void HeadlessWindow::SetPosition(const Pos2D &pos) const {
+        m_pos = pos;
+    }
+
+    RenderContext HeadlessWindow::GetRenderContext() const {
+        return {};
+    }
+
+} // namespace GameEngine
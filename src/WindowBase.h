@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "IWindow.h"
+#include "ObjectScheduler.h"
+#include "RenderContext.h"
+
+namespace GameEngine
+{
+    // Objects of a window: ownership, activation and the update of the awake active ones.
+    // Derived windows do the rest of IWindow (SDL window or none)
+    class WindowBase : public IWindow {
+        std::unordered_map<GameObjectId, std::shared_ptr<IGameObject>> m_gameObjects; // all objects
+        mutable ObjectScheduler m_activeObjects; // all objects, the active ones are updated
+        GameObjectId m_objectsNum = 0;
+        IGameObject *get_object(GameObjectId id) const;
+    public:
+        void Update(float elapsed) const override;
+        // Objects
+        GameObjectId AppendObject(const std::shared_ptr<IGameObject>& obj) override;
+        GameObjectId AppendObject(const std::shared_ptr<IGameObject>& obj, bool active) override;
+        void RemoveObject(GameObjectId id) override;
+        IGameObject *GetObject(GameObjectId id) const override;
+        void SetObjectActive(GameObjectId id, bool active) override;
+        void SleepObject(GameObjectId id) override;
+        void SleepObjectFor(GameObjectId id, uint32_t frames) override;
+        void WakeObject(GameObjectId id) override;
+        void SetObjectUpdateInterval(GameObjectId id, uint32_t frames) override;
+        bool IsIdle() const override;
+        // for objects sleeping and waking by themselves, e.g. scheduler.SleepFor(this, 30)
+        ObjectScheduler &GetScheduler();
+    };
+
+    // Window of the headless game loop: objects are updated, nothing is shown.
+    // Its render context is empty, so renderer components draw nothing and textures aren't loaded
+    class HeadlessWindow : public WindowBase {
+        mutable Size2D m_size;
+        mutable Pos2D m_pos;
+    public:
+        explicit HeadlessWindow(const Size2D &size = {});
+
+        Size2D GetSize() const;
+        Pos2D GetPosition() const;
+        uint32_t GetId() const override { return 0; }
+        bool HasRenderer() const override { return false; }
+        // Size
+        void Resize(const Size2D &size) const override;
+        // Position
+        void SetPosition(const Pos2D &pos) const override;
+        // Window actions
+        void Show() const override {}
+        void Hide() const override {}
+        void Raise() const override {}
+        void Maximize() const override {}
+        void Minimize() const override {}
+        void Restore() const override {}
+        // Modifiers
+        void SetMinSize(const Size2D &) override {}
+        void SetMaxSize(const Size2D &) override {}
+        void SetBordered(bool) override {}
+        void SetResizable(bool) override {}
+        void SetAlwaysOnTop(bool) override {}
+        void Clear() const override {}
+        void Present() const override {}
+        RenderContext GetRenderContext() const;
+    };
+}
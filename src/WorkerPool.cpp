@@ -0,0 +1,97 @@
+#include "WorkerPool.h"
+
+#include <utility>
+
+namespace GameEngine
+{
+    WorkerPool::WorkerPool(size_t threadsNum)
+    {
+        m_threads.reserve(threadsNum);
+        for (size_t i = 0; i < threadsNum; ++i)
+        {
+            m_threads.emplace_back([this] { work(); });
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            const std::scoped_lock lock(m_lock);
+            m_isStopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    size_t WorkerPool::GetThreadsNum() const
+    {
+        return m_threads.size();
+    }
+
+    void WorkerPool::Run(size_t count, Job job)
+    {
+        std::unique_lock lock(m_lock);
+        m_job = job;
+        m_count = count;
+        m_next = 0;
+        m_pending = count;
+        m_exception = nullptr;
+        if (count > 1)
+        {
+            m_wake.notify_all();
+        }
+        while (m_next < m_count)
+        {
+            run_next(lock);
+        }
+        m_done.wait(lock, [this] { return !m_pending; });
+        m_count = 0;
+        m_next = 0;
+        if (const auto exception = std::exchange(m_exception, nullptr))
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void WorkerPool::work()
+    {
+        std::unique_lock lock(m_lock);
+        for (;;)
+        {
+            m_wake.wait(lock, [this] { return m_isStopping || m_next < m_count; });
+            if (m_isStopping)
+            {
+                return;
+            }
+            run_next(lock);
+        }
+    }
+
+    void WorkerPool::run_next(std::unique_lock<std::mutex>& lock)
+    {
+        const auto index = m_next++;
+        const auto job = m_job;
+        lock.unlock();
+        std::exception_ptr exception;
+        try
+        {
+            job(index);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        lock.lock();
+        if (exception && !m_exception)
+        {
+            m_exception = exception;
+        }
+        if (!--m_pending)
+        {
+            m_done.notify_all();
+        }
+    }
+} // namespace GameEngine
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Delegate.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GameEngine
+{
+    // Persistent threads running batches of indexed jobs, e.g. updates of independent windows.
+    // The calling thread takes part in the batch, so a pool without threads runs it as a plain loop.
+    // Jobs are taken one at a time under a lock: meant for a few coarse jobs per frame, not for fine-grained ones
+    class WorkerPool
+    {
+    public:
+        using Job = Delegate<void(size_t)>;
+
+        explicit WorkerPool(size_t threadsNum);
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        ~WorkerPool();
+
+        size_t GetThreadsNum() const;
+
+        // calls job(i) for every i < count and returns once all of them are done.
+        // The first exception thrown by a job is rethrown after the batch
+        void Run(size_t count, Job job);
+
+    private:
+        void work();
+        // runs the next job of the batch, the lock is released meanwhile
+        void run_next(std::unique_lock<std::mutex>& lock);
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_lock;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        Job m_job;
+        size_t m_count = 0;
+        size_t m_next = 0;
+        size_t m_pending = 0; // jobs of the batch not finished yet
+        std::exception_ptr m_exception;
+        bool m_isStopping = false;
+    };
+} // namespace GameEngine
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
@@ -124,6 +126,19 @@ public:
     }
 };
 
+// value of "--name value" argument, nullptr if absent
+static const char *GetArgValue(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], name))
+        {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
 int main(int argc, char *argv[])
 {
     const LoggerInitializer loggerInitialer(LogLevel::DEBUG);
@@ -133,6 +148,8 @@ int main(int argc, char *argv[])
     {
         AddLogHandler(CreateStdoutLogChannel());
         SetLogLevel(LogLevel::TRACE);
+        // keep the game thread off the console writes
+        EnableAsyncLogging();
 
         LOG_TRACE("Starting " << argv[0]);
 
@@ -153,6 +170,16 @@ int main(int argc, char *argv[])
         mainWindow->AppendObject(player, true);
 
         gameLoop->SubscribeToInputEvents(player);
+        // --record-input <file>, --replay-input <file> [--max-speed]
+        if (const auto *path = GetArgValue(argc, argv, "--record-input"))
+        {
+            gameLoop->RecordInput(std::make_unique<InputRecorder>(path));
+        }
+        if (const auto *path = GetArgValue(argc, argv, "--replay-input"))
+        {
+            const bool isMaxSpeed = std::any_of(argv, argv + argc, [](const char *arg) { return !std::strcmp(arg, "--max-speed"); });
+            gameLoop->ReplayInput(std::make_unique<InputReplayer>(path), isMaxSpeed);
+        }
         gameLoop->SetWindow(mainWindow);
         gameLoop->Run();
     }
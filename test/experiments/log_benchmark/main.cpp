@@ -0,0 +1,97 @@
+#include <Logger.h>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace GameEngine;
+
+namespace
+{
+    constexpr long Iterations = 10'000'000;
+
+    // keeps the loops from being optimized away
+    volatile long g_sink = 0;
+
+    template <typename F>
+    void Measure(const char* name, F&& body)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < Iterations; ++i)
+        {
+            body(i);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        std::printf("%-40s %8.2f ns/op\n", name, elapsed.count() / Iterations);
+    }
+
+    void EmptyLoop(long i)
+    {
+        g_sink = i;
+    }
+
+    // previous behavior: the message is formatted and then filtered out by Log()
+    void FormatThenFilter(long i)
+    {
+        g_sink = i;
+        LogStreamHelper t(LogLevel::TRACE, *GetLogger());
+        t << "position " << i << " of " << Iterations;
+    }
+
+    void BinaryRecord(long i)
+    {
+        LOG_FMT(INFO, "position {} of {}", i, Iterations);
+    }
+
+    void RuntimeFiltered(long i)
+    {
+        g_sink = i;
+        LOG_TRACE("position " << i << " of " << Iterations);
+    }
+
+    struct CategoryUser : private Logable
+    {
+        CategoryUser()
+            : Logable("Benchmark")
+        {
+        }
+
+        void Filtered(long i)
+        {
+            g_sink = i;
+            LOG_TRACE("position " << i << " of " << Iterations);
+        }
+    };
+} // namespace
+
+// statements below INFO are compiled out in the rest of this file
+#undef GAME_ENGINE_MIN_LOG_LEVEL
+#define GAME_ENGINE_MIN_LOG_LEVEL INFO
+
+namespace
+{
+    void CompileTimeStripped(long i)
+    {
+        g_sink = i;
+        LOG_TRACE("position " << i << " of " << Iterations);
+    }
+} // namespace
+
+int main()
+{
+    const LoggerInitializer loggerInitialer(LogLevel::INFO);
+    AddLogHandler(CreateBinaryLogChannel("log_benchmark.binlog", 64 * 1024 * 1024));
+
+    Measure("empty loop", EmptyLoop);
+    Measure("format then filter (old LOG_TRACE)", FormatThenFilter);
+    Measure("runtime filtered LOG_TRACE", RuntimeFiltered);
+    CategoryUser categoryUser;
+    SetLogCategoryLevel("Benchmark", LogLevel::ERROR);
+    Measure("category filtered LOG_TRACE", [&categoryUser](long i) { categoryUser.Filtered(i); });
+    Measure("compile-time stripped LOG_TRACE", CompileTimeStripped);
+    Measure("LOG_FMT to binary channel", BinaryRecord);
+    // caller's cost only: the writer thread can't keep up with this rate, so messages are dropped
+    EnableAsyncLogging({ 8192, LogOverflowPolicy::DROP });
+    Measure("LOG_FMT to async queue", BinaryRecord);
+    std::printf("dropped %zu messages\n", GetDroppedLogMessages());
+    return 0;
+}
@@ -11,4 +11,9 @@ namespace GameEngine::Testing
         MOCK_METHOD(void, OnKeyUp, (GameEngine::KeyCodes), (override));
         MOCK_METHOD(void, OnKeyDown, (GameEngine::KeyCodes), (override));
     };
+
+    struct InputBatchSubscriberMock : GameEngine::IInputBatchSubscriber
+    {
+        MOCK_METHOD(void, OnInputEvents, (std::span<const GameEngine::InputEvent>, const GameEngine::InputState&), (override));
+    };
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <AllocationTracker.h>
+#include <GameObject.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace GameEngine;
+
+// test fixture
+class AllocationTrackerTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (!IsAllocationTrackingEnabled())
+        {
+            GTEST_SKIP() << "Build with -DENABLE_ALLOC_TRACKING=ON to run allocation tests";
+        }
+    }
+};
+
+// keeps the compiler from eliding the allocation
+static void* volatile g_sink = nullptr;
+
+TEST_F(AllocationTrackerTest, ShouldCountAllocations)
+{
+    const AllocationCounter counter;
+    {
+        const auto buf = std::make_unique<char[]>(100);
+        g_sink = buf.get();
+    }
+    const auto stats = counter.GetStats();
+    ASSERT_EQ(stats.allocations, 1);
+    ASSERT_EQ(stats.deallocations, 1);
+    ASSERT_GE(stats.bytes, 100);
+}
+
+TEST_F(AllocationTrackerTest, ShouldAttributeAllocationsToTag)
+{
+    const AllocationCounter counter;
+    {
+        const AllocationTagScope tag(AllocationTag::RENDER);
+        const auto buf = std::make_unique<char[]>(10);
+        g_sink = buf.get();
+    }
+    ASSERT_EQ(counter.GetStats(AllocationTag::RENDER).allocations, 1);
+    ASSERT_EQ(counter.GetStats(AllocationTag::GENERAL).allocations, 0);
+}
+
+TEST_F(AllocationTrackerTest, ShouldRestoreTagOutOfScope)
+{
+    const AllocationCounter counter;
+    {
+        const AllocationTagScope outer(AllocationTag::INPUT);
+        {
+            const AllocationTagScope inner(AllocationTag::LOGGER);
+        }
+        const auto buf = std::make_unique<char[]>(10);
+        g_sink = buf.get();
+    }
+    ASSERT_EQ(counter.GetStats(AllocationTag::INPUT).allocations, 1);
+    ASSERT_EQ(counter.GetStats(AllocationTag::LOGGER).allocations, 0);
+}
+
+TEST_F(AllocationTrackerTest, TransformSceneFramesShouldNotAllocate)
+{
+    const int framesNum = 100;
+    const auto obj = std::make_shared<GameObject>("static");
+    obj->AddComponent(GameObjectComponentType::TRANSFORM, Size2D{10, 10});
+    IGameObject& scene = *obj;
+
+    const AllocationCounter counter;
+    for (int i = 0; i < framesNum; ++i)
+    {
+        scene.Update(1.0f / 60);
+    }
+    ASSERT_EQ(counter.GetStats().allocations, 0) << framesNum << " frames should perform zero allocations";
+}
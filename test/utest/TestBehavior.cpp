@@ -0,0 +1,188 @@
+#include <Behavior.h>
+#include <EventBus.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+    constexpr float FrameTime = 0.1f;
+
+    struct HitEvent
+    {
+        int damage;
+    };
+
+    Behavior CountFrames(int &frames)
+    {
+        for (;;)
+        {
+            ++frames;
+            co_await NextFrame();
+        }
+    }
+
+    Behavior Wait(float seconds, bool &isDone)
+    {
+        co_await Seconds(seconds);
+        isDone = true;
+    }
+
+    Behavior WaitHits(std::vector<int> &damages)
+    {
+        for (;;)
+        {
+            const auto hit = co_await Event<HitEvent>();
+            damages.push_back(hit.damage);
+        }
+    }
+
+    Behavior WaitCompletion(Completion &completion, bool &isDone)
+    {
+        co_await completion;
+        isDone = true;
+    }
+
+    Behavior Throw()
+    {
+        co_await NextFrame();
+        throw std::runtime_error("behavior failed");
+    }
+}
+
+class BehaviorTest : public testing::Test
+{
+protected:
+    void RunFrames(size_t framesNum)
+    {
+        for (size_t i = 0; i < framesNum; ++i)
+        {
+            m_scheduler.Resume(FrameTime);
+            m_bus.Dispatch();
+        }
+    }
+
+    EventBus m_bus;
+    BehaviorScheduler m_scheduler{ m_bus };
+};
+
+TEST_F(BehaviorTest, NextFrameShouldResumeOncePerFrame)
+{
+    int frames = 0;
+    const auto id = m_scheduler.Start(CountFrames(frames));
+    // runs until the first suspension right away
+    ASSERT_EQ(frames, 1);
+    RunFrames(3);
+    ASSERT_EQ(frames, 4);
+
+    m_scheduler.Stop(id);
+    ASSERT_FALSE(m_scheduler.IsRunning(id));
+    ASSERT_EQ(m_scheduler.GetCount(), 0);
+    RunFrames(3);
+    ASSERT_EQ(frames, 4);
+}
+
+TEST_F(BehaviorTest, SecondsShouldResumeOnceTheTimeHasCome)
+{
+    bool isDone = false;
+    const auto id = m_scheduler.Start(Wait(0.45f, isDone));
+    RunFrames(4);
+    ASSERT_FALSE(isDone);
+    RunFrames(1);
+    ASSERT_TRUE(isDone);
+    // finished behaviors are destroyed
+    ASSERT_FALSE(m_scheduler.IsRunning(id));
+    ASSERT_EQ(m_scheduler.GetCount(), 0);
+}
+
+TEST_F(BehaviorTest, EventShouldResumeWithTheEvent)
+{
+    std::vector<int> damages;
+    m_scheduler.Start(WaitHits(damages));
+    RunFrames(2);
+    ASSERT_TRUE(damages.empty());
+
+    m_bus.Enqueue(HitEvent{ 5 });
+    RunFrames(2);
+    ASSERT_EQ(damages, std::vector<int>({ 5 }));
+
+    m_bus.Publish(HitEvent{ 7 });
+    RunFrames(1);
+    ASSERT_EQ(damages, std::vector<int>({ 5, 7 }));
+}
+
+TEST_F(BehaviorTest, StoppedBehaviorShouldNotGetEvents)
+{
+    std::vector<int> damages;
+    const auto id = m_scheduler.Start(WaitHits(damages));
+    m_scheduler.Stop(id);
+    // the freed slot is reused with another id
+    std::vector<int> otherDamages;
+    const auto otherId = m_scheduler.Start(WaitHits(otherDamages));
+    ASSERT_NE(id, otherId);
+
+    m_bus.Publish(HitEvent{ 3 });
+    RunFrames(1);
+    ASSERT_TRUE(damages.empty());
+    ASSERT_EQ(otherDamages, std::vector<int>({ 3 }));
+}
+
+TEST_F(BehaviorTest, CompletionShouldResumeWaitersCompletedByAnotherThread)
+{
+    Completion loaded;
+    bool isDone = false;
+    m_scheduler.Start(WaitCompletion(loaded, isDone));
+    RunFrames(2);
+    ASSERT_FALSE(isDone);
+
+    std::thread([&loaded] { loaded.Complete(); }).join();
+    RunFrames(1);
+    ASSERT_TRUE(isDone);
+
+    // a completed one doesn't suspend
+    bool isLateDone = false;
+    m_scheduler.Start(WaitCompletion(loaded, isLateDone));
+    ASSERT_TRUE(isLateDone);
+}
+
+TEST_F(BehaviorTest, ExceptionShouldBeRethrownByResume)
+{
+    int frames = 0;
+    m_scheduler.Start(Throw());
+    m_scheduler.Start(CountFrames(frames));
+    ASSERT_THROW(RunFrames(1), std::runtime_error);
+    ASSERT_EQ(m_scheduler.GetCount(), 1);
+    // the rest of the ready ones aren't lost
+    RunFrames(1);
+    ASSERT_EQ(frames, 2);
+}
+
+TEST_F(BehaviorTest, FramesShouldComeFromThePool)
+{
+    std::vector<int> frames(100);
+    const auto usedBlocks = CoroutineFramePool::GetUsedBlocks();
+    std::vector<BehaviorId> ids;
+    for (auto &count : frames)
+    {
+        ids.push_back(m_scheduler.Start(CountFrames(count)));
+    }
+    ASSERT_EQ(CoroutineFramePool::GetUsedBlocks(), usedBlocks + frames.size());
+    const auto capacity = CoroutineFramePool::GetCapacity();
+
+    for (const auto id : ids)
+    {
+        m_scheduler.Stop(id);
+    }
+    ASSERT_EQ(CoroutineFramePool::GetUsedBlocks(), usedBlocks);
+    // freed frames are reused
+    for (auto &count : frames)
+    {
+        m_scheduler.Start(CountFrames(count));
+    }
+    ASSERT_EQ(CoroutineFramePool::GetCapacity(), capacity);
+}
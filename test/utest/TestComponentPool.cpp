@@ -0,0 +1,118 @@
+#include <ComponentPool.h>
+#include <AllocationTracker.h>
+#include <IGameObjectComponent.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#define POOL_TEST(name) TEST(ComponentPoolTest, name)
+
+using namespace GameEngine;
+
+namespace {
+    struct PooledDummy : public IGameObjectComponent {
+        int m_int;
+    protected:
+        explicit PooledDummy(int i)
+            : m_int(i) {}
+        friend struct DummyFactory;
+    public:
+        PooledDummy(const PooledDummy &) = delete;
+        PooledDummy(PooledDummy &&) = delete;
+        ~PooledDummy() override = default;
+        void OnUpdate() override {}
+    };
+
+    // plays the role of GameObject: the only one allowed to construct components
+    struct DummyFactory {
+        static std::shared_ptr<PooledDummy> Make(int i) {
+            return MakePooled<PooledDummy>([i] { return PooledDummy(i); });
+        }
+    };
+
+    struct Cell {
+        long long value[3];
+    };
+}
+
+POOL_TEST(BlocksAreContiguous) {
+    // a fresh pool: blocks freed by other tests don't reorder its free list
+    ObjectPool<Cell> pool;
+    auto *first = static_cast<std::byte *>(pool.Allocate());
+    auto *second = static_cast<std::byte *>(pool.Allocate());
+    ASSERT_EQ(second - first, static_cast<std::ptrdiff_t>(sizeof(Cell)));
+    pool.Deallocate(second);
+    pool.Deallocate(first);
+}
+
+POOL_TEST(FreedBlockIsReused) {
+    ObjectPool<Cell> pool;
+    auto *block = pool.Allocate();
+    auto *other = pool.Allocate();
+    const auto capacity = pool.GetCapacity();
+    pool.Deallocate(block);
+    ASSERT_EQ(pool.GetUsedBlocks(), 1);
+    ASSERT_EQ(pool.Allocate(), block);
+    ASSERT_EQ(pool.GetUsedBlocks(), 2);
+    ASSERT_EQ(pool.GetCapacity(), capacity);
+    pool.Deallocate(other);
+    pool.Deallocate(block);
+    ASSERT_EQ(pool.GetUsedBlocks(), 0);
+}
+
+POOL_TEST(CapacityGrowsBySlabs) {
+    auto &pool = ObjectPool<Cell>::Instance();
+    const auto capacity = pool.GetCapacity();
+    std::vector<void *> blocks;
+    for (size_t i = 0; i <= capacity; ++i) {
+        blocks.push_back(pool.Allocate());
+    }
+    ASSERT_GT(pool.GetCapacity(), capacity);
+    for (auto *b : blocks) {
+        pool.Deallocate(b);
+    }
+}
+
+POOL_TEST(MakePooledConstructsValue) {
+    const auto d = DummyFactory::Make(42);
+    ASSERT_EQ(d->m_int, 42);
+}
+
+POOL_TEST(MakePooledReusesFreedSlot) {
+    DummyFactory::Make(1);
+    // the freed block serves the next object, whatever the pool held before
+    const AllocationCounter counter;
+    const auto d = DummyFactory::Make(2);
+    ASSERT_EQ(counter.GetStats().allocations, 0);
+    ASSERT_EQ(d->m_int, 2);
+}
+
+POOL_TEST(MakePooledKeepsSharedOwnership) {
+    std::weak_ptr<PooledDummy> weak;
+    {
+        const auto d = DummyFactory::Make(3);
+        const std::shared_ptr<IGameObjectComponent> base = d;
+        weak = d;
+        ASSERT_EQ(weak.use_count(), 2);
+    }
+    ASSERT_TRUE(weak.expired());
+}
+
+POOL_TEST(SpawnWaveAfterWarmupDoesNotAllocate) {
+    const size_t waveSize = 500;
+    std::vector<std::shared_ptr<PooledDummy>> wave;
+    wave.reserve(waveSize);
+    // warm-up: grow the slabs
+    for (size_t i = 0; i < waveSize; ++i) {
+        wave.push_back(DummyFactory::Make(static_cast<int>(i)));
+    }
+    wave.clear();
+
+    const AllocationCounter counter;
+    for (size_t i = 0; i < waveSize; ++i) {
+        wave.push_back(DummyFactory::Make(static_cast<int>(i)));
+    }
+    wave.clear();
+    ASSERT_EQ(counter.GetStats().allocations, 0);
+}
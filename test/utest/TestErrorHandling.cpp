@@ -2,8 +2,33 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
 using namespace GameEngine;
 
+namespace
+{
+    class ErrorCountingLogChannel final : public ILogChannel
+    {
+    public:
+        explicit ErrorCountingLogChannel(const std::shared_ptr<size_t>& errors)
+            : m_errors(errors)
+        {
+        }
+
+        void Log(std::chrono::system_clock::time_point, LogLevel level, const std::string_view, const std::string_view) noexcept override
+        {
+            if (level == LogLevel::ERROR)
+            {
+                ++*m_errors;
+            }
+        }
+
+    private:
+        std::shared_ptr<size_t> m_errors;
+    };
+}
+
 TEST(ErrorHandling, ShouldThrowAtFailedExpectation)
 {
     ASSERT_THROW(EXPECT(1 == 2), CheckFailedException);
@@ -51,4 +76,35 @@ TEST(ErrorHandling, ShouldCatchFailedCheckWithCustomMessage)
     {
         HandleException(*GetLogger());
     }
-}
\ No newline at end of file
+}
+
+TEST(ErrorHandling, FailedFrameExpectationShouldBeCountedNotThrown)
+{
+    TakeFrameErrors();
+    ASSERT_NO_THROW(EXPECT_FRAME_MSG(1 == 2, "Frame " << "message"));
+    ASSERT_NO_THROW(EXPECT_FRAME_MSG(4 == 4, "Should not be counted"));
+    ASSERT_EQ(TakeFrameErrors(), GAME_ENGINE_FRAME_CHECK_LEVEL > 0 ? 1u : 0u);
+    ASSERT_EQ(TakeFrameErrors(), 0u);
+}
+
+TEST(ErrorHandling, FailedFrameExpectationShouldBeReportedOncePerInterval)
+{
+#if GAME_ENGINE_FRAME_CHECK_LEVEL < 2
+    GTEST_SKIP() << "Build with FRAME_CHECK_LEVEL=2 to report per-frame checks";
+#endif
+    const auto errors = std::make_shared<size_t>(0);
+    InitLogger(LogLevel::TRACE);
+    AddLogHandler(std::make_unique<ErrorCountingLogChannel>(errors));
+    TakeFrameErrors();
+
+    int formatted = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_FRAME_MSG(i < 0, "Frame " << ++formatted);
+    }
+    InitLogger(LogLevel::TRACE);
+
+    ASSERT_EQ(*errors, 1u);
+    ASSERT_EQ(formatted, 1);
+    ASSERT_EQ(TakeFrameErrors(), 100u);
+}
@@ -0,0 +1,161 @@
+#include <EventBus.h>
+#include <AllocationTracker.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+    struct DamageEvent
+    {
+        int target = 0;
+        int amount = 0;
+    };
+
+    struct ScoreEvent
+    {
+        int points = 0;
+    };
+
+    struct Health
+    {
+        int value = 100;
+        int hits = 0;
+
+        void OnDamage(const DamageEvent& event)
+        {
+            value -= event.amount;
+            ++hits;
+        }
+    };
+
+    int g_freeHandlerCalls = 0;
+
+    void FreeHandler(const ScoreEvent&)
+    {
+        ++g_freeHandlerCalls;
+    }
+}
+
+class EventBusTest : public testing::Test
+{
+protected:
+    EventBus m_bus;
+    Health m_health;
+};
+
+TEST_F(EventBusTest, PublishShouldCallHandlersImmediately)
+{
+    m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind<&Health::OnDamage>(&m_health));
+    m_bus.Publish(DamageEvent{ 1, 10 });
+    ASSERT_EQ(m_health.value, 90);
+}
+
+TEST_F(EventBusTest, EnqueuedEventsShouldWaitForDispatch)
+{
+    m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind<&Health::OnDamage>(&m_health));
+    m_bus.Enqueue(DamageEvent{ 1, 10 });
+    m_bus.Enqueue(DamageEvent{ 1, 20 });
+    ASSERT_EQ(m_health.value, 100);
+    ASSERT_EQ(m_bus.GetQueuedCount<DamageEvent>(), 2);
+
+    ASSERT_EQ(m_bus.Dispatch(), 2);
+    ASSERT_EQ(m_health.value, 70);
+    ASSERT_EQ(m_bus.GetQueuedCount<DamageEvent>(), 0);
+    ASSERT_EQ(m_bus.Dispatch(), 0);
+}
+
+TEST_F(EventBusTest, BatchHandlerShouldGetAllEventsOfTypeInOrder)
+{
+    std::vector<int> amounts;
+    size_t batches = 0;
+    auto onBatch = [&](std::span<const DamageEvent> events)
+    {
+        ++batches;
+        for (const auto& event : events)
+        {
+            amounts.push_back(event.amount);
+        }
+    };
+    m_bus.SubscribeBatch<DamageEvent>(EventBus::BatchHandler<DamageEvent>::Bind(onBatch));
+    for (int i = 1; i <= 5; ++i)
+    {
+        m_bus.Enqueue(DamageEvent{ 0, i });
+    }
+    m_bus.Enqueue(ScoreEvent{ 1 });
+    m_bus.Dispatch();
+
+    ASSERT_EQ(batches, 1);
+    ASSERT_EQ(amounts, (std::vector<int>{ 1, 2, 3, 4, 5 }));
+}
+
+TEST_F(EventBusTest, EventsEnqueuedByHandlersShouldBeDispatchedInSamePass)
+{
+    g_freeHandlerCalls = 0;
+    m_bus.Subscribe<ScoreEvent>(EventBus::Handler<ScoreEvent>::Bind<&FreeHandler>());
+    auto onDamage = [this](const DamageEvent& event) { m_bus.Enqueue(ScoreEvent{ event.amount }); };
+    m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind(onDamage));
+
+    m_bus.Enqueue(DamageEvent{ 0, 5 });
+    ASSERT_EQ(m_bus.Dispatch(), 2);
+    ASSERT_EQ(g_freeHandlerCalls, 1);
+}
+
+TEST_F(EventBusTest, EndlessChainShouldBeCutAfterMaxRounds)
+{
+    auto onScore = [this](const ScoreEvent& event) { m_bus.Enqueue(ScoreEvent{ event.points + 1 }); };
+    m_bus.Subscribe<ScoreEvent>(EventBus::Handler<ScoreEvent>::Bind(onScore));
+    m_bus.Enqueue(ScoreEvent{ 0 });
+    ASSERT_EQ(m_bus.Dispatch(), EventBus::MaxDispatchRounds);
+    ASSERT_EQ(m_bus.GetQueuedCount<ScoreEvent>(), 1);
+}
+
+TEST_F(EventBusTest, HandlerShouldUnsubscribeDuringDelivery)
+{
+    EventSubscription subscription;
+    int calls = 0;
+    auto once = [&](const DamageEvent&)
+    {
+        ++calls;
+        m_bus.Unsubscribe(subscription);
+    };
+    subscription = m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind(once));
+    m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind<&Health::OnDamage>(&m_health));
+
+    m_bus.Enqueue(DamageEvent{ 0, 1 });
+    m_bus.Enqueue(DamageEvent{ 0, 1 });
+    m_bus.Dispatch();
+    m_bus.Publish(DamageEvent{ 0, 1 });
+
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(m_health.hits, 3);
+}
+
+TEST_F(EventBusTest, WarmedUpBusShouldNotAllocate)
+{
+    if (!IsAllocationTrackingEnabled())
+    {
+        GTEST_SKIP() << "Build with -DENABLE_ALLOC_TRACKING=ON to run allocation tests";
+    }
+    m_bus.Subscribe<DamageEvent>(EventBus::Handler<DamageEvent>::Bind<&Health::OnDamage>(&m_health));
+    const auto frame = [this]
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            m_bus.Enqueue(DamageEvent{ i, 0 });
+        }
+        m_bus.Publish(DamageEvent{ 0, 0 });
+        m_bus.Dispatch();
+    };
+    // both queue buffers grow
+    frame();
+    frame();
+
+    const AllocationCounter counter;
+    frame();
+    ASSERT_EQ(counter.GetStats().allocations, 0);
+    ASSERT_EQ(m_health.hits, 303);
+}
@@ -0,0 +1,191 @@
+#include <EventRouter.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+    SDL_Event MakeMotion(int x, int y, int xrel, int yrel)
+    {
+        SDL_Event event{};
+        event.type = SDL_MOUSEMOTION;
+        event.motion.x = x;
+        event.motion.y = y;
+        event.motion.xrel = xrel;
+        event.motion.yrel = yrel;
+        return event;
+    }
+
+    SDL_Event MakeButton(int x, int y)
+    {
+        SDL_Event event{};
+        event.type = SDL_MOUSEBUTTONDOWN;
+        event.button.button = 1;
+        event.button.x = x;
+        event.button.y = y;
+        return event;
+    }
+}
+
+class EventRouterTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_router.BeginFrame();
+    }
+
+    // routes the events like GameLoop does, returns the events to handle
+    std::vector<SDL_Event> Poll(const std::vector<SDL_Event>& events)
+    {
+        std::vector<SDL_Event> routed;
+        for (const auto& event : events)
+        {
+            for (const auto& e : m_router.Route(event))
+            {
+                routed.push_back(e);
+            }
+        }
+        for (const auto& e : m_router.Flush())
+        {
+            routed.push_back(e);
+        }
+        m_router.EndFrame();
+        return routed;
+    }
+
+    EventBus m_bus;
+    EventRouter m_router{ m_bus };
+};
+
+TEST_F(EventRouterTest, MouseMotionsShouldBeCoalescedIntoOne)
+{
+    const auto routed = Poll({ MakeMotion(1, 1, 1, 1), MakeMotion(3, 2, 2, 1), MakeMotion(6, 2, 3, 0) });
+
+    ASSERT_EQ(routed.size(), 1);
+    ASSERT_EQ(routed[0].motion.x, 6);
+    ASSERT_EQ(routed[0].motion.y, 2);
+    ASSERT_EQ(routed[0].motion.xrel, 6);
+    ASSERT_EQ(routed[0].motion.yrel, 2);
+    ASSERT_EQ(m_router.GetLastFrameStats().polled, 3);
+    ASSERT_EQ(m_router.GetLastFrameStats().coalesced, 2);
+}
+
+TEST_F(EventRouterTest, PendingMotionShouldPrecedeOtherEvents)
+{
+    const auto routed = Poll({ MakeMotion(1, 0, 1, 0), MakeMotion(2, 0, 1, 0), MakeButton(2, 0), MakeMotion(5, 0, 3, 0) });
+
+    ASSERT_EQ(routed.size(), 3);
+    ASSERT_EQ(routed[0].type, SDL_MOUSEMOTION);
+    ASSERT_EQ(routed[0].motion.xrel, 2);
+    ASSERT_EQ(routed[1].type, SDL_MOUSEBUTTONDOWN);
+    ASSERT_EQ(routed[2].type, SDL_MOUSEMOTION);
+    ASSERT_EQ(routed[2].motion.xrel, 3);
+}
+
+TEST_F(EventRouterTest, CoalescingShouldBeOptional)
+{
+    m_router.SetMouseMotionCoalescing(false);
+    const auto routed = Poll({ MakeMotion(1, 1, 1, 1), MakeMotion(3, 2, 2, 1) });
+    ASSERT_EQ(routed.size(), 2);
+    ASSERT_EQ(m_router.GetLastFrameStats().coalesced, 0);
+}
+
+TEST_F(EventRouterTest, RoutedEventsShouldBePublishedAsTypedEvents)
+{
+    std::vector<MouseMotionEvent> motions;
+    std::vector<MouseButtonEvent> buttons;
+    std::vector<ControllerDeviceEvent> devices;
+    auto onMotion = [&](const MouseMotionEvent& e) { motions.push_back(e); };
+    auto onButton = [&](const MouseButtonEvent& e) { buttons.push_back(e); };
+    auto onDevice = [&](const ControllerDeviceEvent& e) { devices.push_back(e); };
+    m_bus.Subscribe<MouseMotionEvent>(EventBus::Handler<MouseMotionEvent>::Bind(onMotion));
+    m_bus.Subscribe<MouseButtonEvent>(EventBus::Handler<MouseButtonEvent>::Bind(onButton));
+    m_bus.Subscribe<ControllerDeviceEvent>(EventBus::Handler<ControllerDeviceEvent>::Bind(onDevice));
+
+    SDL_Event added{};
+    added.type = SDL_CONTROLLERDEVICEADDED;
+    added.cdevice.which = 2;
+    Poll({ MakeMotion(1, 1, 1, 1), MakeMotion(4, 5, 3, 4), MakeButton(4, 5), added });
+
+    ASSERT_EQ(motions.size(), 1);
+    ASSERT_EQ(motions[0].position.x, 4);
+    ASSERT_EQ(motions[0].delta.y, 5);
+    ASSERT_EQ(buttons.size(), 1);
+    ASSERT_TRUE(buttons[0].isDown);
+    ASSERT_EQ(devices.size(), 1);
+    ASSERT_EQ(devices[0].controller, 2);
+    ASSERT_EQ(devices[0].change, ControllerDeviceChange::ADDED);
+}
+
+TEST_F(EventRouterTest, ControllersShouldBeOpenUntilRemoved)
+{
+    std::vector<ControllerAxisEvent> axes;
+    auto onAxis = [&](const ControllerAxisEvent& e) { axes.push_back(e); };
+    m_bus.Subscribe<ControllerAxisEvent>(EventBus::Handler<ControllerAxisEvent>::Bind(onAxis));
+
+    SDL_Event added{};
+    added.type = SDL_CONTROLLERDEVICEADDED;
+    added.cdevice.which = 1;
+    SDL_Event axis{};
+    axis.type = SDL_CONTROLLERAXISMOTION;
+    axis.caxis.which = 1;
+    axis.caxis.value = 100;
+    Poll({ added, added, axis });
+    ASSERT_EQ(m_router.GetControllersNum(), 1);
+    ASSERT_EQ(axes.size(), 1);
+    ASSERT_EQ(axes[0].value, 100);
+
+    SDL_Event removed{};
+    removed.type = SDL_CONTROLLERDEVICEREMOVED;
+    removed.cdevice.which = 1;
+    Poll({ removed });
+    ASSERT_EQ(m_router.GetControllersNum(), 0);
+}
+
+TEST_F(EventRouterTest, FilterShouldDropDisabledWindowEvents)
+{
+    SDL_Event moved{};
+    moved.type = SDL_WINDOWEVENT;
+    moved.window.event = SDL_WINDOWEVENT_MOVED;
+    SDL_Event resized = moved;
+    resized.window.event = SDL_WINDOWEVENT_RESIZED;
+
+    m_router.SetWindowEventEnabled(SDL_WINDOWEVENT_MOVED, false);
+    ASSERT_FALSE(m_router.Accept(moved));
+    ASSERT_TRUE(m_router.Accept(resized));
+    ASSERT_TRUE(m_router.Accept(MakeButton(0, 0)));
+
+    m_router.SetWindowEventEnabled(SDL_WINDOWEVENT_MOVED, true);
+    ASSERT_TRUE(m_router.Accept(moved));
+}
+
+TEST_F(EventRouterTest, UnusedEventTypesShouldBeDisabledByDefault)
+{
+    ASSERT_FALSE(m_router.IsEventEnabled(SDL_SYSWMEVENT));
+    ASSERT_FALSE(m_router.IsEventEnabled(SDL_TEXTEDITING));
+    ASSERT_TRUE(m_router.IsEventEnabled(SDL_MOUSEMOTION));
+    // the controller events are made of them
+    ASSERT_TRUE(m_router.IsEventEnabled(SDL_JOYAXISMOTION));
+
+    m_router.SetEventEnabled(SDL_MOUSEMOTION, false);
+    ASSERT_FALSE(m_router.IsEventEnabled(SDL_MOUSEMOTION));
+    m_router.SetEventEnabled(SDL_TEXTEDITING, true);
+    ASSERT_TRUE(m_router.IsEventEnabled(SDL_TEXTEDITING));
+}
+
+TEST_F(EventRouterTest, MotionsOfDifferentWindowsShouldNotBeCoalesced)
+{
+    auto first = MakeMotion(1, 1, 1, 1);
+    first.motion.windowID = 1;
+    auto second = MakeMotion(2, 2, 1, 1);
+    second.motion.windowID = 2;
+    const auto routed = Poll({ first, second });
+    ASSERT_EQ(routed.size(), 2);
+    ASSERT_EQ(routed[0].motion.windowID, 1);
+    ASSERT_EQ(routed[1].motion.windowID, 2);
+    ASSERT_EQ(m_router.GetLastFrameStats().coalesced, 0);
+}
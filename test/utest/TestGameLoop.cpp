@@ -0,0 +1,310 @@
+#include <GameLoop.h>
+#include <GameObject.h>
+#include <RendererComponent.h>
+#include <WindowBase.h>
+#include <Window.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+    // moves and draws itself every frame
+    class Walker : public GameObject
+    {
+    public:
+        explicit Walker(const HeadlessWindow &window)
+            : GameObject("walker")
+        {
+            AddComponent(GameObjectComponentType::TRANSFORM, Size2D{ 10, 10 });
+            AddComponent(GameObjectComponentType::RENDERER, window.GetRenderContext());
+            AddComponent(GameObjectComponentType::TEXTURE, Size2D{ 4, 4 });
+        }
+
+        size_t updates = 0;
+
+    protected:
+        void OnUpdate() override
+        {
+            ++updates;
+            const auto transform = GetComponent<TransformComponent>();
+            transform->SetPosition(Pos2D{ static_cast<int>(updates), 0 });
+            const auto renderer = GetComponent<RendererComponent>();
+            renderer->AddTexture(GetComponent<TextureComponent>());
+            renderer->DrawLine({ 0, 0 }, { 5, 5 });
+        }
+    };
+
+    struct World
+    {
+        World()
+            : loop(GameLoopMode::HEADLESS)
+            , window(std::make_shared<HeadlessWindow>(Size2D{ 100, 100 }))
+            , walker(std::make_shared<Walker>(*window))
+        {
+            window->AppendObject(walker, true);
+            loop.SetWindow(window);
+        }
+
+        GameLoop loop;
+        std::shared_ptr<HeadlessWindow> window;
+        std::shared_ptr<Walker> walker;
+    };
+}
+
+TEST(HeadlessGameLoop, ShouldUpdateObjectsWithoutRendering)
+{
+    World world;
+    ASSERT_TRUE(world.loop.IsHeadless());
+    world.loop.RunFrames(50);
+
+    ASSERT_EQ(world.loop.GetFramesNum(), 50);
+    ASSERT_EQ(world.walker->updates, 50);
+    ASSERT_EQ(world.loop.GetLastFrameErrors(), 0) << "Draw calls are no-ops without a renderer";
+    ASSERT_EQ(world.walker->GetComponent<TextureComponent>()->GetSize().w, 4);
+}
+
+TEST(HeadlessGameLoop, ShouldKeepFixedFrameRate)
+{
+    World world;
+    world.loop.SetFrameRate(200);
+    const auto start = std::chrono::steady_clock::now();
+    world.loop.RunFrames(11);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+}
+
+TEST(HeadlessGameLoop, StopShouldEndRunFromOtherThread)
+{
+    World world;
+    world.loop.SetFrameRate(1000);
+    std::thread runner([&world] { world.loop.Run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    world.loop.Stop();
+    runner.join();
+    ASSERT_GT(world.walker->updates, 0);
+    ASSERT_EQ(world.walker->updates, world.loop.GetFramesNum());
+}
+
+TEST(HeadlessGameLoop, IndependentWorldsShouldRunInParallel)
+{
+    constexpr size_t WorldsNum = 4;
+    constexpr size_t FramesNum = 500;
+    std::vector<std::unique_ptr<World>> worlds;
+    for (size_t i = 0; i < WorldsNum; ++i)
+    {
+        worlds.push_back(std::make_unique<World>());
+    }
+
+    std::vector<std::thread> threads;
+    for (auto &world : worlds)
+    {
+        threads.emplace_back([&world] { world->loop.RunFrames(FramesNum); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &world : worlds)
+    {
+        ASSERT_EQ(world->walker->updates, FramesNum);
+        ASSERT_EQ(world->walker->GetComponent<TransformComponent>()->GetWorldPosition().x, static_cast<int>(FramesNum));
+    }
+}
+
+namespace
+{
+    // sleeps after its first update
+    class Napper : public GameObject
+    {
+    public:
+        Napper(WindowBase &window)
+            : GameObject("napper")
+            , m_window(window)
+        {
+        }
+
+        size_t updates = 0;
+
+    protected:
+        void OnUpdate() override
+        {
+            ++updates;
+            m_window.GetScheduler().Sleep(this);
+        }
+
+    private:
+        WindowBase &m_window;
+    };
+
+    Behavior StopAfter(GameLoop &loop, float seconds)
+    {
+        co_await Seconds(seconds);
+        loop.Stop();
+    }
+
+    struct IdleWorld
+    {
+        IdleWorld()
+            : window(std::make_shared<HeadlessWindow>(Size2D{ 100, 100 }))
+            , napper(std::make_shared<Napper>(*window))
+        {
+            window->AppendObject(napper, true);
+            loop.SetWindow(window);
+            loop.SetIdleMode(true);
+        }
+
+        GameLoop loop;
+        std::shared_ptr<HeadlessWindow> window;
+        std::shared_ptr<Napper> napper;
+    };
+}
+
+TEST(IdleGameLoop, ShouldSkipFramesUntilBehaviorIsDue)
+{
+    IdleWorld world;
+    world.loop.GetBehaviors().Start(StopAfter(world.loop, 0.2f));
+    const auto start = std::chrono::steady_clock::now();
+    world.loop.RunFrames(1000);
+
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    // the first frame and the one resuming the behavior
+    ASSERT_EQ(world.loop.GetFramesNum(), 2);
+    ASSERT_EQ(world.napper->updates, 1);
+}
+
+TEST(IdleGameLoop, RequestRedrawShouldRunFrame)
+{
+    IdleWorld world;
+    std::thread requester([&world]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        world.loop.RequestRedraw();
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        world.loop.Stop();
+    });
+    world.loop.RunFrames(1000);
+    requester.join();
+    ASSERT_EQ(world.loop.GetFramesNum(), 2);
+    // behaviors are resumed by full frames only
+    ASSERT_GE(world.loop.GetBehaviors().GetTime(), 0.04);
+}
+
+namespace
+{
+    class Counter : public GameObject
+    {
+    public:
+        Counter()
+            : GameObject("counter")
+        {
+        }
+
+        size_t updates = 0;
+        float elapsed = 0;
+
+    protected:
+        void OnUpdate() override
+        {
+            ++updates;
+            elapsed += GetElapsedTime();
+        }
+    };
+
+    std::shared_ptr<Counter> AddCounter(IWindow &window)
+    {
+        auto counter = std::make_shared<Counter>();
+        window.AppendObject(counter, true);
+        return counter;
+    }
+}
+
+TEST(MultiWindowGameLoop, WindowsShouldKeepTheirRefreshRates)
+{
+    GameLoop loop(GameLoopMode::HEADLESS);
+    loop.SetFixedTimeStep(1.0f / 60);
+    const auto main = std::make_shared<HeadlessWindow>();
+    const auto stats = std::make_shared<HeadlessWindow>();
+    const auto mainCounter = AddCounter(*main);
+    const auto statsCounter = AddCounter(*stats);
+    loop.SetWindow(main);
+    loop.AddWindow(stats);
+    loop.SetWindowRefreshRate(*stats, 10);
+
+    loop.RunFrames(60);
+    ASSERT_EQ(mainCounter->updates, 60);
+    ASSERT_EQ(statsCounter->updates, 10);
+    ASSERT_NEAR(statsCounter->elapsed, 1.0f, 0.01f);
+
+    loop.RemoveWindow(*stats);
+    loop.RunFrames(60);
+    ASSERT_EQ(statsCounter->updates, 10);
+}
+
+TEST(MultiWindowGameLoop, WindowEventsShouldBeRoutedByWindowId)
+{
+    GameLoop loop;
+    loop.SetFrameRate(0);
+    loop.SetFixedTimeStep(1.0f / 60);
+    const auto first = std::make_shared<Window>("first", Size2D{ 100, 100 });
+    const auto second = std::make_shared<Window>("second", Size2D{ 100, 100 });
+    const auto firstCounter = AddCounter(*first);
+    const auto secondCounter = AddCounter(*second);
+    loop.AddWindow(first);
+    loop.AddWindow(second);
+    ASSERT_EQ(loop.FindWindow(second->GetId()), second.get());
+
+    loop.GetEventBus().Publish(WindowEvent{ second->GetId(), SDL_WINDOWEVENT_FOCUS_GAINED });
+    ASSERT_EQ(loop.GetFocusedWindow(), second.get());
+    // minimized windows are throttled
+    loop.GetEventBus().Publish(WindowEvent{ second->GetId(), SDL_WINDOWEVENT_MINIMIZED });
+    loop.RunFrames(60);
+    ASSERT_EQ(firstCounter->updates, 60);
+    ASSERT_EQ(secondCounter->updates, GameLoop::HiddenFrameRate);
+
+    loop.GetEventBus().Publish(WindowEvent{ second->GetId(), SDL_WINDOWEVENT_RESTORED });
+    loop.RunFrames(1);
+    ASSERT_EQ(secondCounter->updates, GameLoop::HiddenFrameRate + 1);
+}
+
+TEST(MultiWindowGameLoop, WindowsWithoutRendererShouldBeUpdatedInParallel)
+{
+    constexpr size_t WindowsNum = 4;
+    constexpr size_t FramesNum = 200;
+    GameLoop loop(GameLoopMode::HEADLESS);
+    loop.SetWindowUpdateThreads(WindowsNum - 1);
+    std::vector<std::shared_ptr<Walker>> walkers;
+    for (size_t i = 0; i < WindowsNum; ++i)
+    {
+        const auto window = std::make_shared<HeadlessWindow>(Size2D{ 100, 100 });
+        walkers.push_back(std::make_shared<Walker>(*window));
+        window->AppendObject(walkers.back(), true);
+        loop.AddWindow(window);
+    }
+    // behaviors run on the loop thread after the windows: they see the transforms moved by the workers
+    size_t minChanged = WindowsNum;
+    auto watch = [&]() -> Behavior
+    {
+        co_await NextFrame();
+        for (;;)
+        {
+            minChanged = std::min(minChanged, TransformComponent::GetChanged().size());
+            co_await NextFrame();
+        }
+    };
+    loop.GetBehaviors().Start(watch());
+
+    loop.RunFrames(FramesNum);
+    for (const auto &walker : walkers)
+    {
+        ASSERT_EQ(walker->updates, FramesNum);
+        ASSERT_EQ(walker->GetComponent<TransformComponent>()->GetWorldPosition().x, static_cast<int>(FramesNum));
+    }
+    ASSERT_EQ(minChanged, WindowsNum);
+    ASSERT_EQ(loop.GetLastFrameErrors(), 0);
+}
@@ -54,4 +54,233 @@ GAME_OBJ_TEST(NoExceptRendererWithTransform) {
     ASSERT_NO_THROW(m_gameObject.AddComponent(GameObjectComponentType::RENDERER, *context_cast));
 }
 
+GAME_OBJ_TEST(TextureMatrixIsQueuedUntilRendered) {
+    const RenderContextTest context; // headless: files are not loaded
+    m_gameObject.AddComponent(GameObjectComponentType::TRANSFORM);
+    m_gameObject.AddComponent(GameObjectComponentType::RENDERER, static_cast<const RenderContext &>(context));
+    using tex_files_list_type = std::initializer_list<std::initializer_list<std::string>>;
+    m_gameObject.AddComponent(GameObjectComponentType::TEXTURE_MATRIX, tex_files_list_type{{"a.png", "b.png"}, {"c.png"}});
+    const auto renderer = m_gameObject.GetComponent<RendererComponent>();
+    const auto matrix = m_gameObject.GetComponent<TextureMatrixComponent>();
+
+    // cells are taken when drawn, not when queued
+    renderer->AddTextures(matrix);
+    renderer->AddTextures(matrix);
+    ASSERT_EQ(renderer->GetQueuedTexturesNum(), 6);
+    renderer->OnUpdate();
+    ASSERT_EQ(renderer->GetQueuedTexturesNum(), 0);
+}
+
+static std::shared_ptr<GameObject> MakeTransformObject(const std::string &name, const Pos2D &pos) {
+    auto obj = std::make_shared<GameObject>(name);
+    obj->AddComponent(GameObjectComponentType::TRANSFORM, Size2D{10, 10});
+    obj->GetComponent<TransformComponent>()->SetPosition(pos);
+    return obj;
+}
+
+GAME_OBJ_TEST(ChildFollowsParent) {
+    const auto parent = MakeTransformObject("parent", {100, 100});
+    const auto child = MakeTransformObject("child", {10, 20});
+    parent->AddChild(child);
+    const auto parent_transform = parent->GetComponent<TransformComponent>();
+    const auto child_transform = child->GetComponent<TransformComponent>();
+    ASSERT_EQ(child_transform->GetPosition().x, 10);
+    ASSERT_EQ(child_transform->GetWorldPosition().x, 110);
+    ASSERT_EQ(child_transform->GetWorldPosition().y, 120);
+
+    parent_transform->Move({5, 5});
+    ASSERT_EQ(child_transform->GetWorldPosition().x, 115);
+    ASSERT_EQ(child_transform->GetWorldPosition().y, 125);
+    parent_transform->Rotate(30);
+    ASSERT_DOUBLE_EQ(child_transform->GetWorldAngle(), 30.0);
+}
+
+GAME_OBJ_TEST(ChildTurnsWithParent) {
+    const auto parent = MakeTransformObject("parent", {100, 100});
+    const auto child = MakeTransformObject("child", {10, 0});
+    const auto grandchild = MakeTransformObject("grandchild", {10, 0});
+    parent->AddChild(child);
+    child->AddChild(grandchild);
+    const auto child_transform = child->GetComponent<TransformComponent>();
+    const auto grandchild_transform = grandchild->GetComponent<TransformComponent>();
+
+    // clockwise quarter turn around the parent's center: right of the parent becomes below it
+    parent->GetComponent<TransformComponent>()->SetAngle(90);
+    ASSERT_EQ(child_transform->GetWorldPosition().x, 100);
+    ASSERT_EQ(child_transform->GetWorldPosition().y, 110);
+    ASSERT_EQ(grandchild_transform->GetWorldPosition().x, 100);
+    ASSERT_EQ(grandchild_transform->GetWorldPosition().y, 120);
+    ASSERT_EQ(child_transform->GetPosition().x, 10);
+
+    // the child's own turn adds up for the grandchild
+    child_transform->SetAngle(90);
+    ASSERT_DOUBLE_EQ(grandchild_transform->GetWorldAngle(), 180.0);
+    ASSERT_EQ(grandchild_transform->GetWorldPosition().x, 90);
+    ASSERT_EQ(grandchild_transform->GetWorldPosition().y, 110);
+}
+
+GAME_OBJ_TEST(GrandchildFollowsRoot) {
+    const auto root = MakeTransformObject("root", {1, 1});
+    const auto child = MakeTransformObject("child", {10, 10});
+    const auto grandchild = MakeTransformObject("grandchild", {100, 100});
+    root->AddChild(child);
+    child->AddChild(grandchild);
+    const auto transform = grandchild->GetComponent<TransformComponent>();
+    ASSERT_EQ(transform->GetWorldPosition().x, 111);
+
+    root->GetComponent<TransformComponent>()->SetPosition({2, 2});
+    ASSERT_EQ(transform->GetWorldPosition().x, 112);
+    ASSERT_EQ(transform->GetPosition().x, 100);
+}
+
+GAME_OBJ_TEST(ChildMoveDoesNotAffectParent) {
+    const auto parent = MakeTransformObject("parent", {100, 100});
+    const auto child = MakeTransformObject("child", {0, 0});
+    parent->AddChild(child);
+    child->GetComponent<TransformComponent>()->Move({50, 50});
+    ASSERT_EQ(parent->GetComponent<TransformComponent>()->GetWorldPosition().x, 100);
+    ASSERT_EQ(child->GetComponent<TransformComponent>()->GetWorldPosition().x, 150);
+}
+
+GAME_OBJ_TEST(AttachSubtree) {
+    const auto root = MakeTransformObject("root", {1000, 0});
+    const auto sibling = MakeTransformObject("sibling", {1, 0});
+    const auto child = MakeTransformObject("child", {10, 0});
+    const auto grandchild = MakeTransformObject("grandchild", {100, 0});
+    // subtree is built before it is attached to the root
+    child->AddChild(grandchild);
+    root->AddChild(sibling);
+    root->AddChild(child);
+    ASSERT_EQ(sibling->GetComponent<TransformComponent>()->GetWorldPosition().x, 1001);
+    ASSERT_EQ(child->GetComponent<TransformComponent>()->GetWorldPosition().x, 1010);
+    ASSERT_EQ(grandchild->GetComponent<TransformComponent>()->GetWorldPosition().x, 1110);
+}
 
+GAME_OBJ_TEST(RemovedChildKeepsWorldPosition) {
+    const auto parent = MakeTransformObject("parent", {100, 100});
+    const auto child = MakeTransformObject("child", {10, 0});
+    const auto grandchild = MakeTransformObject("grandchild", {10, 0});
+    const auto sibling = MakeTransformObject("sibling", {1, 0});
+    parent->AddChild(child);
+    child->AddChild(grandchild);
+    parent->AddChild(sibling);
+    parent->GetComponent<TransformComponent>()->SetAngle(90);
+
+    parent->RemoveChild(child);
+    const auto child_transform = child->GetComponent<TransformComponent>();
+    ASSERT_EQ(child_transform->GetPosition().x, 100);
+    ASSERT_EQ(child_transform->GetPosition().y, 110);
+    ASSERT_DOUBLE_EQ(child_transform->GetAngle(), 90.0);
+    // the subtree goes on without the parent
+    parent->GetComponent<TransformComponent>()->Move({1000, 0});
+    ASSERT_EQ(grandchild->GetComponent<TransformComponent>()->GetWorldPosition().x, 100);
+    ASSERT_EQ(grandchild->GetComponent<TransformComponent>()->GetWorldPosition().y, 120);
+    child_transform->Move({0, 5});
+    ASSERT_EQ(grandchild->GetComponent<TransformComponent>()->GetWorldPosition().y, 125);
+    ASSERT_EQ(sibling->GetComponent<TransformComponent>()->GetWorldPosition().x, 1100);
+
+    ASSERT_THROW(parent->RemoveChild(child), ExceptionType);
+    // may be attached again
+    const auto other = MakeTransformObject("other", {1000, 0});
+    other->AddChild(child);
+    ASSERT_EQ(child_transform->GetWorldPosition().x, 1100);
+    ASSERT_EQ(grandchild->GetComponent<TransformComponent>()->GetWorldPosition().y, 125);
+}
+
+GAME_OBJ_TEST(ChildOutlivesParent) {
+    const auto child = MakeTransformObject("child", {10, 10});
+    {
+        const auto parent = MakeTransformObject("parent", {100, 100});
+        parent->AddChild(child);
+    }
+    const auto child_transform = child->GetComponent<TransformComponent>();
+    ASSERT_EQ(child_transform->GetPosition().x, 110);
+    child_transform->Move({1, 1});
+    ASSERT_EQ(child_transform->GetWorldPosition().x, 111);
+    // free to get a new parent
+    const auto other = MakeTransformObject("other", {0, 0});
+    ASSERT_NO_THROW(other->AddChild(child));
+    ASSERT_NO_THROW(child->AddChild(MakeTransformObject("grandchild", {0, 0})));
+}
+
+GAME_OBJ_TEST(ChildIsAwokenOnce) {
+    class AwakeCounter : public GameObject {
+    public:
+        int m_awakes = 0;
+        AwakeCounter() : GameObject("counter") {
+            AddComponent(GameObjectComponentType::TRANSFORM, Size2D{10, 10});
+        }
+    protected:
+        void Awake() override { ++m_awakes; }
+    };
+    const auto parent = MakeTransformObject("parent", {0, 0});
+    const auto other = MakeTransformObject("other", {0, 0});
+    const auto child = std::make_shared<AwakeCounter>();
+    parent->AddChild(child);
+    ASSERT_EQ(child->m_awakes, 1);
+    parent->RemoveChild(child);
+    other->AddChild(child);
+    ASSERT_EQ(child->m_awakes, 1);
+}
+
+GAME_OBJ_TEST(NoChildWithoutTransform) {
+    const auto parent = MakeTransformObject("parent", {0, 0});
+    ASSERT_THROW(parent->AddChild(std::make_shared<GameObject>("child")), ExceptionType)
+    << "It shouldn't be possible to add child without transform component";
+}
+
+GAME_OBJ_TEST(NoCyclesOrSecondParent) {
+    const auto parent = MakeTransformObject("parent", {0, 0});
+    const auto child = MakeTransformObject("child", {0, 0});
+    const auto other = MakeTransformObject("other", {0, 0});
+    parent->AddChild(child);
+    ASSERT_THROW(child->AddChild(parent), ExceptionType);
+    ASSERT_THROW(other->AddChild(child), ExceptionType);
+}
+
+GAME_OBJ_TEST(ParentChangeMarksChildren) {
+    const auto parent = MakeTransformObject("parent", {0, 0});
+    const auto child = MakeTransformObject("child", {0, 0});
+    const auto other = MakeTransformObject("other", {0, 0});
+    parent->AddChild(child);
+    TransformComponent::ClearChanged();
+
+    parent->GetComponent<TransformComponent>()->Move({1, 1});
+    ASSERT_TRUE(child->GetComponent<TransformComponent>()->IsChanged());
+    ASSERT_FALSE(other->GetComponent<TransformComponent>()->IsChanged());
+    ASSERT_EQ(TransformComponent::GetChanged().size(), 2);
+}
+
+GAME_OBJ_TEST(ParentChangesResolveChildrenOnce) {
+    const auto parent = MakeTransformObject("parent", {0, 0});
+    const auto child = MakeTransformObject("child", {0, 0});
+    const auto grandchild = MakeTransformObject("grandchild", {0, 0});
+    parent->AddChild(child);
+    child->AddChild(grandchild);
+    const auto childTransform = child->GetComponent<TransformComponent>();
+    const auto version = childTransform->GetVersion();
+    TransformComponent::ClearChanged();
+
+    const auto parentTransform = parent->GetComponent<TransformComponent>();
+    const auto parentVersion = parentTransform->GetVersion();
+    for (int i = 0; i < 10; ++i) {
+        parentTransform->Move({1, 0});
+        parentTransform->Rotate(1.0);
+    }
+    ASSERT_EQ(parentTransform->GetVersion(), parentVersion + 20);
+    // the subtree is touched by a single resolve
+    ASSERT_EQ(childTransform->GetVersion(), version + 1);
+    ASSERT_EQ(TransformComponent::GetChanged().size(), 3);
+    ASSERT_TRUE(grandchild->GetComponent<TransformComponent>()->IsChanged());
+}
+
+GAME_OBJ_TEST(DestroyedTransformLeavesChangedList) {
+    TransformComponent::ClearChanged();
+    const auto kept = MakeTransformObject("kept", {1, 1});
+    {
+        const auto destroyed = MakeTransformObject("destroyed", {1, 1});
+    }
+    const auto changed = TransformComponent::GetChanged();
+    ASSERT_EQ(changed.size(), 1);
+    ASSERT_EQ(changed[0], kept->GetComponent<TransformComponent>().get());
+}
@@ -1,9 +1,18 @@
 #include "Mock.h"
 
 #include <InputEventPublisher.h>
+#include <InputState.h>
+#include <InputRecording.h>
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
 using namespace ::testing;
 using namespace GameEngine;
 using namespace GameEngine::Testing;
@@ -232,4 +241,360 @@ TEST(InputEventPublisher, ShouldPublishEventsInEventsOrder)
 
     sut->OnKeyDown(KeyCodes::ARROW_DOWN);
     sut->OnKeyUp(KeyCodes::ARROW_DOWN);
-}
\ No newline at end of file
+}
+namespace
+{
+    SDL_Event MakeKeyEvent(Uint32 type, SDL_Scancode scancode, bool repeat = false)
+    {
+        SDL_Event event{};
+        event.key.type = type;
+        event.key.repeat = repeat ? 1 : 0;
+        event.key.keysym.scancode = scancode;
+        return event;
+    }
+
+    SDL_Event MakeMotionEvent(int x, int y, int xrel, int yrel)
+    {
+        SDL_Event event{};
+        event.motion.type = SDL_MOUSEMOTION;
+        event.motion.x = x;
+        event.motion.y = y;
+        event.motion.xrel = xrel;
+        event.motion.yrel = yrel;
+        return event;
+    }
+}
+
+TEST(InputState, ShouldTrackKeyEdgesAcrossFrames)
+{
+    InputState state;
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_SPACE));
+    ASSERT_TRUE(state.WasPressed(SDL_SCANCODE_SPACE));
+    ASSERT_TRUE(state.IsHeld(SDL_SCANCODE_SPACE));
+
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_SPACE, true));
+    ASSERT_FALSE(state.WasPressed(SDL_SCANCODE_SPACE)) << "Auto-repeat isn't a new press";
+    ASSERT_TRUE(state.IsHeld(SDL_SCANCODE_SPACE));
+
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYUP, SDL_SCANCODE_SPACE));
+    ASSERT_TRUE(state.WasReleased(SDL_SCANCODE_SPACE));
+    ASSERT_FALSE(state.IsHeld(SDL_SCANCODE_SPACE));
+}
+
+TEST(InputState, ShouldKeepBothEdgesOfTapWithinFrame)
+{
+    InputState state;
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_W));
+    state.HandleEvent(MakeKeyEvent(SDL_KEYUP, SDL_SCANCODE_W));
+    ASSERT_TRUE(state.WasPressed(KeyCodes::W));
+    ASSERT_TRUE(state.WasReleased(KeyCodes::W));
+    ASSERT_FALSE(state.IsHeld(KeyCodes::W));
+    ASSERT_EQ(state.GetEvents().size(), 2);
+    ASSERT_EQ(state.GetEvents()[0].keyCode, KeyCodes::W);
+}
+
+TEST(InputState, ShouldTrackKeysWithoutKeyCode)
+{
+    InputState state;
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_ESCAPE));
+    ASSERT_TRUE(state.IsHeld(SDL_SCANCODE_ESCAPE));
+    ASSERT_EQ(state.GetEvents()[0].keyCode, KeyCodes::UNSUPPORTED);
+    ASSERT_EQ(state.GetEvents()[0].scancode, SDL_SCANCODE_ESCAPE);
+}
+
+TEST(InputState, ShouldAccumulateMouseAndText)
+{
+    InputState state;
+    state.BeginFrame();
+    state.HandleEvent(MakeMotionEvent(10, 10, 2, 3));
+    state.HandleEvent(MakeMotionEvent(15, 12, 5, 2));
+    SDL_Event button{};
+    button.button.type = SDL_MOUSEBUTTONDOWN;
+    button.button.button = SDL_BUTTON_LEFT;
+    state.HandleEvent(button);
+    SDL_Event text{};
+    text.text.type = SDL_TEXTINPUT;
+    std::strcpy(text.text.text, "hi");
+    state.HandleEvent(text);
+    state.HandleEvent(text);
+
+    ASSERT_EQ(state.GetMouseDelta().x, 7);
+    ASSERT_EQ(state.GetMouseDelta().y, 5);
+    ASSERT_TRUE(state.WasMouseButtonPressed(SDL_BUTTON_LEFT));
+    ASSERT_TRUE(state.IsMouseButtonHeld(SDL_BUTTON_LEFT));
+    ASSERT_EQ(state.GetText(), "hihi");
+    ASSERT_EQ(state.GetEvents().back().GetText(), "hi");
+
+    state.BeginFrame();
+    ASSERT_EQ(state.GetMouseDelta().x, 0);
+    ASSERT_TRUE(state.GetText().empty());
+    ASSERT_FALSE(state.WasMouseButtonPressed(SDL_BUTTON_LEFT));
+    ASSERT_TRUE(state.IsMouseButtonHeld(SDL_BUTTON_LEFT));
+}
+
+TEST(InputState, ShouldTellInputFromWindowEvents)
+{
+    // replayed input replaces only these, window events and quit are still handled
+    InputState state;
+    state.BeginFrame();
+    for (const auto &event : { MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_A), MakeMotionEvent(1, 1, 1, 1) })
+    {
+        ASSERT_TRUE(InputState::IsInputEvent(event));
+        ASSERT_TRUE(state.HandleEvent(event));
+    }
+    SDL_Event window{};
+    window.window.type = SDL_WINDOWEVENT;
+    window.window.event = SDL_WINDOWEVENT_FOCUS_GAINED;
+    SDL_Event quit{};
+    quit.type = SDL_QUIT;
+    for (const auto &event : { window, quit })
+    {
+        ASSERT_FALSE(InputState::IsInputEvent(event));
+        ASSERT_FALSE(state.HandleEvent(event));
+    }
+}
+
+TEST(InputEventPublisher, ShouldPublishFrameToBatchSubscriberOnce)
+{
+    const auto sut = std::make_unique<InputEventPublisher>();
+    const auto subscriber = std::make_shared<InputBatchSubscriberMock>();
+    sut->SubscribeToInputBatches(subscriber);
+
+    InputState state;
+    state.BeginFrame();
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_A));
+    state.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_D));
+    state.HandleEvent(MakeMotionEvent(1, 1, 1, 1));
+
+    EXPECT_CALL(*subscriber, OnInputEvents(SizeIs(3), Ref(state))).Times(1);
+    sut->PublishInputEvents(state.GetEvents(), state);
+
+    sut->UnsubscribeFromInputBatches(subscriber);
+    EXPECT_CALL(*subscriber, OnInputEvents).Times(0);
+    sut->PublishInputEvents(state.GetEvents(), state);
+}
+
+namespace
+{
+    struct CountingSubscriber : IInputEventSubscriber
+    {
+        std::atomic<int> keyDowns = 0;
+
+        void OnKeyUp(KeyCodes) override {}
+        void OnKeyDown(KeyCodes) override { ++keyDowns; }
+    };
+}
+
+TEST(InputEventPublisher, ShouldAllowSubscribingFromCallback)
+{
+    const auto sut = std::make_unique<InputEventPublisher>();
+    const auto subscriber = std::make_shared<InputEventSubscriberMock>();
+    const auto late = std::make_shared<InputEventSubscriberMock>();
+
+    EXPECT_CALL(*subscriber, OnKeyDown).Times(2).WillOnce([&](auto) { sut->SubscribeToInputEvents(late); }).WillOnce(Return());
+    // the change is seen from the next dispatch
+    EXPECT_CALL(*late, OnKeyDown).Times(1);
+    sut->SubscribeToInputEvents(subscriber);
+
+    sut->OnKeyDown(KeyCodes::A);
+    sut->OnKeyDown(KeyCodes::A);
+}
+
+TEST(InputEventPublisher, ShouldAllowUnsubscribingSelfFromCallback)
+{
+    const auto sut = std::make_unique<InputEventPublisher>();
+    const auto subscriber = std::make_shared<InputEventSubscriberMock>();
+
+    EXPECT_CALL(*subscriber, OnKeyDown).Times(1).WillOnce([&](auto) { sut->UnsubscribeFromInputEvents(subscriber); });
+    sut->SubscribeToInputEvents(subscriber);
+
+    sut->OnKeyDown(KeyCodes::S);
+    sut->OnKeyDown(KeyCodes::S);
+}
+
+TEST(InputEventPublisher, ShouldPublishWhileOtherThreadsSubscribe)
+{
+    const auto sut = std::make_unique<InputEventPublisher>();
+    const auto permanent = std::make_shared<CountingSubscriber>();
+    sut->SubscribeToInputEvents(permanent);
+
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&]
+        {
+            while (!stop)
+            {
+                const auto temporary = std::make_shared<CountingSubscriber>();
+                sut->SubscribeToInputEvents(temporary);
+                sut->UnsubscribeFromInputEvents(temporary);
+            }
+        });
+    }
+
+    const int events = 10'000;
+    for (int i = 0; i < events; ++i)
+    {
+        sut->OnKeyDown(KeyCodes::D);
+    }
+    stop = true;
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    ASSERT_EQ(permanent->keyDowns, events);
+}
+
+TEST(SubscriberList, ShouldCompactExpiredSubscribers)
+{
+    SubscriberList<IInputEventSubscriber> sut;
+    const auto kept = std::make_shared<CountingSubscriber>();
+    sut.Add(kept);
+    sut.Add(std::make_shared<CountingSubscriber>());
+    ASSERT_EQ(sut.GetSize(), 2);
+
+    sut.Compact();
+    ASSERT_EQ(sut.GetSize(), 2) << "Nothing is compacted before dispatch notices expired subscribers";
+
+    int calls = 0;
+    sut.ForEach([&calls](IInputEventSubscriber&) { ++calls; });
+    sut.Compact();
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(sut.GetSize(), 1);
+}
+
+TEST(SubscriberList, DispatchShouldNotAllocate)
+{
+    if (!IsAllocationTrackingEnabled())
+    {
+        GTEST_SKIP() << "Build with -DENABLE_ALLOC_TRACKING=ON to run allocation tests";
+    }
+    const auto sut = std::make_unique<InputEventPublisher>();
+    std::vector<std::shared_ptr<CountingSubscriber>> subscribers;
+    for (int i = 0; i < 100; ++i)
+    {
+        subscribers.push_back(std::make_shared<CountingSubscriber>());
+        sut->SubscribeToInputEvents(subscribers.back());
+    }
+
+    const AllocationCounter counter;
+    sut->OnKeyDown(KeyCodes::W);
+    ASSERT_EQ(counter.GetStats().allocations, 0);
+    ASSERT_EQ(subscribers.back()->keyDowns, 1);
+}
+
+TEST(InputRecording, ReplayShouldRestoreFramesAndState)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "game_engine_test.input").string();
+    InputState recorded;
+    {
+        InputRecorder recorder(path);
+        recorded.BeginFrame();
+        recorded.HandleEvent(MakeKeyEvent(SDL_KEYDOWN, SDL_SCANCODE_W));
+        recorded.HandleEvent(MakeMotionEvent(10, 20, 1, 2));
+        recorder.RecordFrame(0, 100, recorded.GetEvents());
+        recorded.BeginFrame();
+        recorder.RecordFrame(1, 116, recorded.GetEvents()); // nothing to write
+        recorded.BeginFrame();
+        recorded.HandleEvent(MakeKeyEvent(SDL_KEYUP, SDL_SCANCODE_W));
+        recorder.RecordFrame(2, 133, recorded.GetEvents());
+        recorder.Finish(5);
+    }
+
+    const InputReplayer replayer(path);
+    ASSERT_EQ(replayer.GetFramesNum(), 5);
+    ASSERT_EQ(replayer.GetFrameEvents(0).size(), 2);
+    ASSERT_TRUE(replayer.GetFrameEvents(1).empty());
+    ASSERT_FALSE(replayer.IsFinished(4));
+    ASSERT_TRUE(replayer.IsFinished(5));
+
+    InputState replayed;
+    replayed.BeginFrame();
+    for (const auto& event : replayer.GetFrameEvents(0))
+    {
+        replayed.Apply(event);
+    }
+    ASSERT_TRUE(replayed.WasPressed(KeyCodes::W));
+    ASSERT_EQ(replayed.GetMousePosition().y, 20);
+    ASSERT_EQ(replayed.GetMouseDelta().x, 1);
+
+    replayed.BeginFrame();
+    for (const auto& event : replayer.GetFrameEvents(2))
+    {
+        replayed.Apply(event);
+    }
+    ASSERT_TRUE(replayed.WasReleased(KeyCodes::W));
+    ASSERT_EQ(replayed.GetEvents()[0].scancode, recorded.GetEvents()[0].scancode);
+    std::filesystem::remove(path);
+}
+
+TEST(InputRecording, CutOffRecordingShouldReplayWrittenFrames)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "game_engine_test_cut.input").string();
+    {
+        InputRecorder recorder(path);
+        const InputEvent event;
+        recorder.RecordFrame(7, 0, { &event, 1 });
+        // no Finish(): e.g. the session crashed
+    }
+    const InputReplayer replayer(path);
+    ASSERT_EQ(replayer.GetFramesNum(), 8);
+    ASSERT_EQ(replayer.GetFrameEvents(7).size(), 1);
+    std::filesystem::remove(path);
+}
+
+TEST(InputRecording, CutOffFrameShouldNotBeLoaded)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "game_engine_test_cut_frame.input").string();
+    {
+        InputRecorder recorder(path);
+        const InputEvent event;
+        recorder.RecordFrame(7, 0, { &event, 1 });
+    }
+    // the header of the next frame got written, its events didn't
+    auto* file = std::fopen(path.c_str(), "ab");
+    const uint64_t frame = 9;
+    const uint32_t header[] = { 0, 100 };
+    std::fwrite(&frame, sizeof(frame), 1, file);
+    std::fwrite(header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    const InputReplayer replayer(path);
+    ASSERT_EQ(replayer.GetFramesNum(), 8);
+    ASSERT_TRUE(replayer.GetFrameEvents(9).empty());
+    std::filesystem::remove(path);
+}
+
+TEST(InputRecording, ShouldRejectCorruptEventsCount)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "game_engine_test_corrupt.input").string();
+    {
+        InputRecorder recorder(path);
+    }
+    auto* file = std::fopen(path.c_str(), "ab");
+    const uint64_t frame = 0;
+    const uint32_t header[] = { 0, InputRecording::EndMarker - 1 };
+    std::fwrite(&frame, sizeof(frame), 1, file);
+    std::fwrite(header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    ASSERT_ANY_THROW(InputReplayer{ path });
+    std::filesystem::remove(path);
+}
+
+TEST(InputRecording, ShouldRejectOtherFiles)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "game_engine_test_bad.input").string();
+    auto* file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a recording", file);
+    std::fclose(file);
+    ASSERT_ANY_THROW(InputReplayer{ path });
+    std::filesystem::remove(path);
+}
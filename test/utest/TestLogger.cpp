@@ -1,7 +1,19 @@
+#include <ErrorHandling.h>
 #include <Logger.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <regex>
+#include <thread>
+#include <vector>
+
 using namespace GameEngine;
 
 TEST(ArchitectureTest, ShouldBe64bit) 
@@ -27,3 +39,768 @@ TEST(Logger, ShouldLogClassMethod)
     MyClassWithLog cls;
     cls.Method();
 }
+
+namespace
+{
+    // collects messages, may stall the writer to fill the queue up
+    struct CaptureState
+    {
+        std::mutex lock;
+        std::vector<std::pair<LogLevel, std::string>> messages;
+        std::vector<std::string> prefixes;
+        std::atomic<bool> stalled = false;
+        std::atomic<size_t> flushes = 0;
+    };
+
+    class CaptureLogChannel final : public ILogChannel
+    {
+    public:
+        explicit CaptureLogChannel(const std::shared_ptr<CaptureState>& state)
+            : m_state(state)
+        {
+        }
+
+        void Log(std::chrono::system_clock::time_point, LogLevel level, const std::string_view prefix, const std::string_view message) noexcept override
+        {
+            while (m_state->stalled)
+            {
+                std::this_thread::yield();
+            }
+            const std::scoped_lock lock(m_state->lock);
+            m_state->messages.emplace_back(level, message);
+            m_state->prefixes.emplace_back(prefix);
+        }
+
+        void Flush() noexcept override
+        {
+            ++m_state->flushes;
+        }
+
+    private:
+        std::shared_ptr<CaptureState> m_state;
+    };
+
+    class NullLogChannel final : public ILogChannel
+    {
+    public:
+        void Log(std::chrono::system_clock::time_point, LogLevel, const std::string_view, const std::string_view) noexcept override
+        {
+        }
+    };
+
+    struct LogableUser : private Logable
+    {
+        LogableUser()
+            : Logable("LogableUser")
+        {
+        }
+
+        void Method(int i)
+        {
+            LOG_INFO("iteration " << i << " of " << 100 << ", state: " << "running");
+        }
+
+        void LongMethod()
+        {
+            LOG_INFO(std::string(1000, 'x'));
+        }
+
+        void DebugMethod(int& evaluated)
+        {
+            LOG_DEBUG("debug " << ++evaluated);
+        }
+
+        void FmtMethod(int i)
+        {
+            LOG_FMT(INFO, "formatted {}", i);
+        }
+    };
+}
+
+// test fixture
+class CaptureLoggerTest : public testing::Test
+{
+protected:
+    std::shared_ptr<CaptureState> m_state = std::make_shared<CaptureState>();
+
+    void SetUp() override
+    {
+        InitLogger(LogLevel::TRACE);
+        AddLogHandler(std::make_unique<CaptureLogChannel>(m_state));
+    }
+
+    void TearDown() override
+    {
+        m_state->stalled = false;
+        InitLogger(LogLevel::TRACE);
+    }
+
+    size_t CountMessages(LogLevel level)
+    {
+        const std::scoped_lock lock(m_state->lock);
+        return std::count_if(m_state->messages.begin(), m_state->messages.end(), [level](const auto& m) { return m.first == level; });
+    }
+};
+
+TEST_F(CaptureLoggerTest, ShouldWriteAllMessagesFromManyThreads)
+{
+    const size_t threadsNum = 4;
+    const size_t messagesNum = 1000;
+    EnableAsyncLogging({ 64, LogOverflowPolicy::BLOCK });
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsNum; ++t)
+    {
+        threads.emplace_back([id = t] {
+            for (size_t i = 0; i < messagesNum; ++i)
+            {
+                LOG_DEBUG("thread " << id << " message " << i);
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    FlushLogger();
+
+    ASSERT_EQ(CountMessages(LogLevel::DEBUG), threadsNum * messagesNum);
+    ASSERT_EQ(GetDroppedLogMessages(), 0);
+    ASSERT_GT(m_state->flushes, 0);
+}
+
+TEST_F(CaptureLoggerTest, ShouldKeepLongMessages)
+{
+    EnableAsyncLogging();
+    const std::string longMessage(1000, 'x');
+    LOG_INFO(longMessage);
+    LOG_INFO("short");
+    FlushLogger();
+
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages.back().second, "short");
+    ASSERT_EQ(m_state->messages[m_state->messages.size() - 2].second, longMessage);
+}
+
+TEST_F(CaptureLoggerTest, DropPolicyShouldNotBlock)
+{
+    EnableAsyncLogging({ 8, LogOverflowPolicy::DROP });
+    m_state->stalled = true;
+    for (int i = 0; i < 100; ++i)
+    {
+        LOG_ERROR("error " << i);
+    }
+    ASSERT_GT(GetDroppedLogMessages(), 0);
+    m_state->stalled = false;
+}
+
+TEST_F(CaptureLoggerTest, DropLowestLevelShouldKeepErrors)
+{
+    const int errorsNum = 20;
+    EnableAsyncLogging({ 8, LogOverflowPolicy::DROP_LOWEST_LEVEL });
+    m_state->stalled = true;
+    std::thread producer([] {
+        for (int i = 0; i < errorsNum; ++i)
+        {
+            LOG_TRACE("trace " << i);
+            LOG_ERROR("error " << i);
+        }
+    });
+    // errors wait for free slots: let the writer go
+    while (GetDroppedLogMessages() == 0)
+    {
+        std::this_thread::yield();
+    }
+    m_state->stalled = false;
+    producer.join();
+    FlushLogger();
+
+    ASSERT_EQ(CountMessages(LogLevel::ERROR), errorsNum);
+    ASSERT_LT(CountMessages(LogLevel::TRACE), errorsNum);
+}
+
+TEST_F(CaptureLoggerTest, DisableShouldWaitForLoggingThreads)
+{
+    const size_t threadsNum = 4;
+    std::atomic<bool> stop = false;
+    std::atomic<size_t> logged = 0;
+    EnableAsyncLogging({ 16, LogOverflowPolicy::BLOCK });
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsNum; ++t)
+    {
+        threads.emplace_back([&stop, &logged, id = t] {
+            while (!stop)
+            {
+                LOG_DEBUG("thread " << id);
+                ++logged;
+            }
+        });
+    }
+    // the writer is replaced and removed under the producers
+    for (int i = 0; i < 20; ++i)
+    {
+        while (logged < 100)
+        {
+            std::this_thread::yield();
+        }
+        logged = 0;
+        if (i % 2)
+        {
+            EnableAsyncLogging({ 16, LogOverflowPolicy::BLOCK });
+        }
+        else
+        {
+            DisableAsyncLogging();
+        }
+    }
+    DisableAsyncLogging();
+    stop = true;
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    ASSERT_GT(CountMessages(LogLevel::DEBUG), 0);
+    ASSERT_EQ(GetDroppedLogMessages(), 0);
+}
+
+TEST_F(CaptureLoggerTest, FinishShouldWriteQueuedMessages)
+{
+    EnableAsyncLogging();
+    LOG_WARNING("last words");
+    FinishLogger();
+
+    ASSERT_EQ(CountMessages(LogLevel::WARNING), 1);
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages.back().second, "Log finished.");
+}
+
+TEST(Logger, DisabledLevelShouldNotFormatMessage)
+{
+    int evaluated = 0;
+    const auto format = [&evaluated] { return ++evaluated; };
+
+    SetLogLevel(LogLevel::INFO);
+    LOG_TRACE("value " << format());
+    LOG_DEBUG("value " << format());
+    ASSERT_FALSE(IsLogLevelEnabled(LogLevel::DEBUG));
+    ASSERT_EQ(evaluated, 0);
+
+    SetLogLevel(LogLevel::TRACE);
+    LOG_DEBUG("value " << format());
+    ASSERT_EQ(evaluated, 1);
+}
+
+TEST(Logger, DisabledLevelShouldNotAllocate)
+{
+    if (!IsAllocationTrackingEnabled())
+    {
+        GTEST_SKIP() << "Build with -DENABLE_ALLOC_TRACKING=ON to run allocation tests";
+    }
+    SetLogLevel(LogLevel::INFO);
+    const AllocationCounter counter;
+    for (int i = 0; i < 100; ++i)
+    {
+        LOG_TRACE("iteration " << i);
+    }
+    const auto allocations = counter.GetStats().allocations;
+    SetLogLevel(LogLevel::TRACE);
+    ASSERT_EQ(allocations, 0);
+}
+
+TEST(BinaryLog, ShouldFormatEncodedArguments)
+{
+    BinaryLog::ArgsBuffer args;
+    const std::string name = "player";
+    args.Add(-5);
+    args.Add(7u);
+    args.Add(1.5);
+    args.Add(true);
+    args.Add('c');
+    args.Add("text");
+    args.Add(name);
+    args.Add(LogLevel::INFO);
+    ASSERT_EQ(BinaryLog::FormatMessage("{} {} {} {} {} {} {} {}", args.GetBytes()), "-5 7 1.5 true c text player 2");
+}
+
+TEST(BinaryLog, MissingArgumentShouldKeepPlaceholder)
+{
+    BinaryLog::ArgsBuffer args;
+    args.Add(1);
+    ASSERT_EQ(BinaryLog::FormatMessage("{} of {}", args.GetBytes()), "1 of {}");
+}
+
+TEST(BinaryLog, LongStringShouldBeCutOff)
+{
+    BinaryLog::ArgsBuffer args;
+    args.Add(std::string(1000, 'x'));
+    args.Add(1);
+    ASSERT_TRUE(args.IsTruncated());
+    ASSERT_LE(args.GetBytes().size(), BinaryLog::ArgsBuffer::Capacity);
+    const auto message = BinaryLog::FormatMessage("{} {}", args.GetBytes());
+    ASSERT_EQ(message, std::string(BinaryLog::ArgsBuffer::Capacity - 4, 'x') + " {}" + std::string(BinaryLog::TruncatedMarker));
+}
+
+TEST(BinaryLog, ArgumentsAfterCutOffShouldBeSkipped)
+{
+    BinaryLog::ArgsBuffer args;
+    args.Add(std::string(BinaryLog::ArgsBuffer::Capacity - 12, 'x'));
+    args.Add(123456789); // doesn't fit
+    args.Add(true); // would fit, but belongs to the next placeholder
+    ASSERT_TRUE(args.IsTruncated());
+    const auto message = BinaryLog::FormatMessage("{} {} {}", args.GetBytes());
+    ASSERT_TRUE(message.ends_with(" {} {}" + std::string(BinaryLog::TruncatedMarker))) << message;
+}
+
+TEST_F(CaptureLoggerTest, LogFmtShouldBeFormattedByTextChannel)
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        LOG_FMT(INFO, "frame {} took {} ms", i, 16.5);
+    }
+    EnableAsyncLogging();
+    LOG_FMT(WARNING, "async {}", "record");
+    FlushLogger();
+
+    ASSERT_EQ(CountMessages(LogLevel::INFO), 3); // with "Log started."
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages[m_state->messages.size() - 2].second, "frame 1 took 16.5 ms");
+    ASSERT_EQ(m_state->messages.back().second, "async record");
+}
+
+TEST_F(CaptureLoggerTest, LogFmtShouldRespectLevel)
+{
+    int evaluated = 0;
+    SetLogLevel(LogLevel::INFO);
+    LOG_FMT(TRACE, "{}", ++evaluated);
+    SetLogLevel(LogLevel::TRACE);
+    ASSERT_EQ(evaluated, 0);
+    ASSERT_EQ(CountMessages(LogLevel::TRACE), 0);
+}
+
+TEST_F(CaptureLoggerTest, BinaryChannelShouldWriteSiteOnce)
+{
+    const auto path = std::filesystem::temp_directory_path() / "game_engine_test.binlog";
+    AddLogHandler(CreateBinaryLogChannel(path, 1024 * 1024));
+    for (int i = 0; i < 3; ++i)
+    {
+        LOG_FMT(DEBUG, "unique binary format {}", i);
+    }
+    FlushLogger();
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    ASSERT_EQ(content.compare(0, BinaryLog::Magic.size(), BinaryLog::Magic.data(), BinaryLog::Magic.size()), 0);
+    const auto site = content.find("unique binary format {}");
+    ASSERT_NE(site, std::string::npos);
+    ASSERT_EQ(content.find("unique binary format {}", site + 1), std::string::npos);
+    // text messages are stored as well
+    ASSERT_NE(content.find("Log started."), std::string::npos);
+}
+
+TEST_F(CaptureLoggerTest, PrefixShouldBePassedToChannel)
+{
+    LogableUser user;
+    user.Method(1);
+
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->prefixes.back(), "LogableUser");
+    ASSERT_EQ(m_state->messages.back().second, "iteration 1 of 100, state: running");
+}
+
+TEST_F(CaptureLoggerTest, LogFmtShouldKeepPrefix)
+{
+    LogableUser user;
+    user.FmtMethod(1);
+    LOG_FMT(INFO, "global {}", 2);
+    EnableAsyncLogging();
+    user.FmtMethod(3);
+    FlushLogger();
+
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages.size(), 4); // with "Log started."
+    ASSERT_EQ(m_state->prefixes[1], "LogableUser");
+    ASSERT_EQ(m_state->messages[1].second, "formatted 1");
+    ASSERT_EQ(m_state->prefixes[2], "");
+    ASSERT_EQ(m_state->prefixes[3], "LogableUser");
+    ASSERT_EQ(m_state->messages[3].second, "formatted 3");
+}
+
+TEST_F(CaptureLoggerTest, BinaryChannelShouldWritePrefixOnce)
+{
+    const auto path = std::filesystem::temp_directory_path() / "game_engine_test_prefix.binlog";
+    AddLogHandler(CreateBinaryLogChannel(path, 1024 * 1024));
+    LogableUser user;
+    for (int i = 0; i < 3; ++i)
+    {
+        user.FmtMethod(i);
+    }
+    FlushLogger();
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    const auto prefix = content.find("LogableUser");
+    ASSERT_NE(prefix, std::string::npos);
+    ASSERT_EQ(content.find("LogableUser", prefix + 1), std::string::npos);
+}
+
+TEST_F(CaptureLoggerTest, NestedPrefixesShouldBeJoined)
+{
+    const auto logger = CreatePrefixLogger("Outer", CreatePrefixLogger("Inner", ::GetLogger()));
+    logger->Log(LogLevel::INFO, "message");
+
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->prefixes.back(), "Inner Outer");
+    ASSERT_EQ(m_state->messages.back().second, "message");
+}
+
+TEST_F(CaptureLoggerTest, CategoryLevelShouldOverrideGlobalLevel)
+{
+    LogableUser user;
+    int evaluated = 0;
+    SetLogLevel(LogLevel::INFO);
+    SetLogCategoryLevel("LogableUser", LogLevel::DEBUG);
+    user.DebugMethod(evaluated);
+    LOG_DEBUG("global " << ++evaluated);
+
+    ASSERT_EQ(evaluated, 1);
+    ASSERT_EQ(CountMessages(LogLevel::DEBUG), 1);
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages.back().second, "debug 1");
+}
+
+TEST_F(CaptureLoggerTest, DisabledCategoryShouldNotFormatMessage)
+{
+    LogableUser user;
+    int evaluated = 0;
+    SetLogCategoryLevel("LogableUser", LogLevel::ERROR);
+    user.DebugMethod(evaluated);
+    LOG_DEBUG("global " << ++evaluated);
+
+    ASSERT_EQ(evaluated, 1);
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->messages.back().second, "global 1");
+}
+
+TEST_F(CaptureLoggerTest, CategoryShouldFollowGlobalLevelUntilSet)
+{
+    const auto& level = GetLogCategoryLevel("LogableUser");
+    SetLogLevel(LogLevel::WARNING);
+    ASSERT_EQ(level.load(), LogLevel::WARNING);
+
+    SetLogCategoryLevel("LogableUser", LogLevel::TRACE);
+    SetLogLevel(LogLevel::INFO);
+    ASSERT_EQ(level.load(), LogLevel::TRACE);
+
+    ResetLogCategoryLevel("LogableUser");
+    ASSERT_EQ(level.load(), LogLevel::INFO);
+    SetLogLevel(LogLevel::DEBUG);
+    ASSERT_EQ(level.load(), LogLevel::DEBUG);
+}
+
+TEST_F(CaptureLoggerTest, OversizedMessageShouldSpill)
+{
+    EnableAsyncLogging();
+    LogableUser user;
+    user.LongMethod();
+    FlushLogger();
+
+    const std::scoped_lock lock(m_state->lock);
+    ASSERT_EQ(m_state->prefixes.back(), "LogableUser");
+    ASSERT_EQ(m_state->messages.back().second, std::string(1000, 'x'));
+}
+
+// test fixture
+class LogAllocationTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (!IsAllocationTrackingEnabled())
+        {
+            GTEST_SKIP() << "Build with -DENABLE_ALLOC_TRACKING=ON to run allocation tests";
+        }
+        InitLogger(LogLevel::TRACE);
+        AddLogHandler(std::make_unique<NullLogChannel>());
+    }
+
+    void TearDown() override
+    {
+        InitLogger(LogLevel::TRACE);
+    }
+
+    static size_t CountAllocations(LogableUser& user)
+    {
+        user.Method(0); // warm-up
+        const AllocationCounter counter;
+        for (int i = 0; i < 100; ++i)
+        {
+            user.Method(i);
+        }
+        return counter.GetStats().allocations;
+    }
+};
+
+TEST_F(LogAllocationTest, LogableShouldNotAllocate)
+{
+    LogableUser user;
+    ASSERT_EQ(CountAllocations(user), 0);
+}
+
+TEST_F(LogAllocationTest, AsyncLogableShouldNotAllocate)
+{
+    EnableAsyncLogging();
+    LogableUser user;
+    ASSERT_EQ(CountAllocations(user), 0);
+}
+
+// test fixture
+class FileLogChannelTest : public testing::Test
+{
+protected:
+    const std::filesystem::path m_dir = std::filesystem::temp_directory_path() / "game_engine_file_log_test";
+    const std::filesystem::path m_path = m_dir / "test.log";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+        InitLogger(LogLevel::TRACE);
+    }
+
+    void TearDown() override
+    {
+        InitLogger(LogLevel::TRACE);
+        std::filesystem::remove_all(m_dir);
+    }
+
+    static std::string ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+};
+
+TEST_F(FileLogChannelTest, ShouldWriteTimestampedLines)
+{
+    AddLogHandler(CreateFileLogChannel(m_path, 1024 * 1024));
+    LOG_INFO("first");
+    LOG_INFO("second");
+
+    const std::regex line(R"(\d{4}-\d{2}:\d{2}:\d{2}\.\d{3} \[INFO\] (Log started\.|first|second)\n)");
+    const auto content = ReadFile(m_path);
+    const auto lines = std::distance(std::sregex_iterator(content.begin(), content.end(), line), std::sregex_iterator());
+    ASSERT_EQ(lines, 3) << content;
+}
+
+TEST_F(FileLogChannelTest, BufferedShouldWriteOnFlush)
+{
+    FileLogConfig config;
+    config.flushInterval = std::chrono::hours(1);
+    AddLogHandler(CreateFileLogChannel(m_path, config));
+    LOG_INFO("buffered");
+    ASSERT_EQ(ReadFile(m_path).find("buffered"), std::string::npos);
+
+    FlushLogger();
+    ASSERT_NE(ReadFile(m_path).find("buffered"), std::string::npos);
+}
+
+TEST_F(FileLogChannelTest, BufferedShouldFlushAfterIntervalWithoutNewMessages)
+{
+    using namespace std::chrono_literals;
+    FileLogConfig config;
+    config.flushInterval = 20ms;
+    AddLogHandler(CreateFileLogChannel(m_path, config));
+    LOG_INFO("last synchronous");
+    ASSERT_EQ(ReadFile(m_path).find("last synchronous"), std::string::npos);
+    std::this_thread::sleep_for(config.flushInterval);
+    PollLogger();
+    ASSERT_NE(ReadFile(m_path).find("last synchronous"), std::string::npos);
+
+    // the idle async writer flushes by itself
+    EnableAsyncLogging();
+    LOG_INFO("last asynchronous");
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (ReadFile(m_path).find("last asynchronous") == std::string::npos && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_NE(ReadFile(m_path).find("last asynchronous"), std::string::npos);
+    DisableAsyncLogging();
+}
+
+TEST_F(FileLogChannelTest, BufferedShouldFlushOnError)
+{
+    FileLogConfig config;
+    config.flushInterval = std::chrono::hours(1);
+    AddLogHandler(CreateFileLogChannel(m_path, config));
+    LOG_INFO("before error");
+    LOG_ERROR("error");
+
+    const auto content = ReadFile(m_path);
+    ASSERT_NE(content.find("before error"), std::string::npos);
+    ASSERT_NE(content.find("error"), std::string::npos);
+}
+
+TEST_F(FileLogChannelTest, ShouldKeepGenerations)
+{
+    FileLogConfig config;
+    config.maxLogFileBytes = 100;
+    config.generations = 3;
+    config.bufferBytes = 0;
+    AddLogHandler(CreateFileLogChannel(m_path, config));
+    for (int i = 0; i < 20; ++i)
+    {
+        LOG_INFO("message number " << i);
+    }
+
+    ASSERT_TRUE(std::filesystem::exists(m_path.string() + ".bak"));
+    ASSERT_TRUE(std::filesystem::exists(m_path.string() + ".bak.1"));
+    ASSERT_TRUE(std::filesystem::exists(m_path.string() + ".bak.2"));
+    ASSERT_FALSE(std::filesystem::exists(m_path.string() + ".bak.3"));
+    // older generations hold older messages
+    ASSERT_NE(ReadFile(m_path.string() + ".bak").find("message number 1"), std::string::npos);
+}
+
+TEST_F(FileLogChannelTest, CrashRingShouldKeepLastRecordsUntilFlush)
+{
+    AddLogHandler(CreateCrashRingLogChannel(m_path, 4));
+    for (int i = 0; i < 10; ++i)
+    {
+        LOG_INFO("message number " << i);
+    }
+    // opened up front for the signal handler, but nothing is written
+    ASSERT_TRUE(ReadFile(m_path).empty());
+
+    FlushLogger();
+    const auto content = ReadFile(m_path);
+    ASSERT_EQ(content.find("message number 5"), std::string::npos) << content;
+    ASSERT_LT(content.find("message number 6"), content.find("message number 9")) << content;
+
+    // the next dump holds only new records
+    LOG_INFO("after dump");
+    FlushLogger();
+    const auto second = ReadFile(m_path).substr(content.size());
+    ASSERT_NE(second.find("after dump"), std::string::npos);
+    ASSERT_EQ(second.find("message number"), std::string::npos);
+}
+
+TEST_F(FileLogChannelTest, CrashRingShouldMergeThreadsByTime)
+{
+    AddLogHandler(CreateCrashRingLogChannel(m_path, 8));
+    LOG_INFO("first");
+    std::thread([] { LOG_FMT(INFO, "second {}", 2); }).join();
+    LOG_INFO("third");
+    LogableUser().FmtMethod(4);
+    FlushLogger();
+
+    const auto content = ReadFile(m_path);
+    ASSERT_NE(content.find("LogableUser formatted 4"), std::string::npos) << content;
+    const auto first = content.find("first");
+    const auto second = content.find("second 2");
+    const auto third = content.find("third");
+    ASSERT_NE(second, std::string::npos) << content;
+    ASSERT_LT(first, second);
+    ASSERT_LT(second, third);
+}
+
+TEST_F(FileLogChannelTest, CrashRingShouldDumpWhileThreadsLog)
+{
+    AddLogHandler(CreateCrashRingLogChannel(m_path, 16));
+    std::atomic<bool> isDone = false;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 2000; ++i)
+            {
+                LOG_FMT(DEBUG, "writer {} record {}", t, i);
+            }
+        });
+    }
+    std::thread dumper([&] {
+        while (!isDone)
+        {
+            FlushLogger();
+        }
+    });
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    isDone = true;
+    dumper.join();
+    FlushLogger();
+
+    // records overwritten while dumped are skipped, none is torn
+    std::ifstream file(m_path);
+    const std::regex record(R"(.*\[DEBUG\] \[thread \d+\] writer \d record \d+)");
+    std::string line;
+    size_t records = 0;
+    while (std::getline(file, line))
+    {
+        if (line.find("writer") != std::string::npos)
+        {
+            ASSERT_TRUE(std::regex_match(line, record)) << line;
+            ++records;
+        }
+    }
+    ASSERT_GE(records, 4 * 16);
+    const auto content = ReadFile(m_path);
+    for (int t = 0; t < 4; ++t)
+    {
+        ASSERT_NE(content.find("writer " + std::to_string(t) + " record 1999"), std::string::npos) << content;
+    }
+}
+
+TEST_F(FileLogChannelTest, CrashRingShouldDumpOnFailedExpectation)
+{
+    AddLogHandler(CreateCrashRingLogChannel(m_path, 8));
+    LOG_DEBUG("context");
+    ASSERT_THROW(EXPECT_MSG(false, "broken"), CheckFailedException);
+
+    const auto content = ReadFile(m_path);
+    ASSERT_LT(content.find("context"), content.find("broken")) << content;
+}
+
+TEST_F(FileLogChannelTest, CrashRingShouldDumpOnFatalSignal)
+{
+    AddLogHandler(CreateCrashRingLogChannel(m_path, 8));
+    ASSERT_DEATH(
+        {
+            LOG_INFO("before crash");
+            LOG_FMT(WARNING, "value {}", 7);
+            std::raise(SIGSEGV);
+        },
+        "");
+
+    const auto content = ReadFile(m_path);
+    ASSERT_NE(content.find("signal"), std::string::npos) << content;
+    ASSERT_NE(content.find("before crash"), std::string::npos) << content;
+    // not formatted in the signal handler
+    ASSERT_NE(content.find("value {}"), std::string::npos) << content;
+}
+
+TEST_F(FileLogChannelTest, CrashRingSignalShouldDrainAsyncQueue)
+{
+    const auto logPath = m_dir / "async.log";
+    FileLogConfig config;
+    config.flushInterval = std::chrono::milliseconds{ 0 };
+    ASSERT_DEATH(
+        {
+            AddLogHandler(CreateFileLogChannel(logPath, config));
+            AddLogHandler(CreateCrashRingLogChannel(m_path, 8));
+            EnableAsyncLogging({ 1024, LogOverflowPolicy::BLOCK });
+            for (int i = 0; i < 100; ++i)
+            {
+                LOG_INFO("queued " << i);
+            }
+            std::raise(SIGSEGV);
+        },
+        "");
+
+    // buffered by the file channel, flushed by the writer thread on the handler's request
+    const auto content = ReadFile(logPath);
+    ASSERT_NE(content.find("queued 99"), std::string::npos) << content;
+}
@@ -90,3 +90,113 @@ MATRIX_TEST(CheckSerialized) {
 }
 
 
+struct TestValueMatrix : public ComponentMatrix<Dummy, ValueCellStorage> {
+    TestValueMatrix() = default;
+    TestValueMatrix(int rows, int cols) {
+        Reserve(rows * cols);
+        for (int r = 0; r < rows; ++r) {
+            EmplaceRow(cols, [r, cols](size_t c) { return Dummy(r * cols + static_cast<int>(c)); });
+        }
+    }
+};
+
+struct NonMovableDummy : public IGameObjectComponent {
+    int m_int;
+    explicit NonMovableDummy(int i = 0)
+        : m_int(i) {}
+    NonMovableDummy(NonMovableDummy &&) = delete;
+    void OnUpdate() override {}
+};
+
+struct TestNonMovableMatrix : public ComponentMatrix<NonMovableDummy, ValueCellStorage> {
+    TestNonMovableMatrix() = default;
+};
+
+MATRIX_TEST(ValueIgnoreEmpty) {
+    TestValueMatrix matrix;
+    matrix.EmplaceRow(0, [](size_t) { return Dummy(); });
+    matrix.EmplaceRow(1, [](size_t) { return Dummy(); });
+    ASSERT_EQ(matrix.GetRowsNum(), 1);
+    ASSERT_THROW(matrix.GetRow(1), std::out_of_range);
+}
+
+MATRIX_TEST(ValueSpan) {
+    TestValueMatrix matrix(3, 5);
+    for (int i = 0; i < 15; ++i) {
+        ASSERT_EQ(matrix.GetRow(i/5)[i%5].m_int, i);
+        ASSERT_EQ(matrix.At(i/5, i%5).m_int, i);
+    }
+}
+
+MATRIX_TEST(ValueSerializedIsContiguous) {
+    TestValueMatrix matrix(3, 5);
+    const auto serialized = matrix.GetSerializedMatrix();
+    ASSERT_EQ(serialized.size(), 15);
+    ASSERT_EQ(matrix.GetRow(1).data(), serialized.data() + 5);
+    int cnt = 0;
+    for (const auto &d : serialized) {
+        ASSERT_EQ(d.m_int, cnt++);
+    }
+}
+
+MATRIX_TEST(ValueGrowsWithoutReserve) {
+    TestValueMatrix matrix;
+    for (int r = 0; r < 10; ++r) {
+        matrix.EmplaceRow(3, [r](size_t c) { return Dummy(r * 3 + static_cast<int>(c)); });
+    }
+    ASSERT_EQ(matrix.GetRowsNum(), 10);
+    ASSERT_EQ(matrix.At(9, 2).m_int, 29);
+}
+
+MATRIX_TEST(ValueColumn) {
+    TestValueMatrix matrix;
+    matrix.EmplaceRow(3, [](size_t c) { return Dummy(static_cast<int>(c)); });
+    matrix.EmplaceRow(1, [](size_t c) { return Dummy(10 + static_cast<int>(c)); });
+    matrix.EmplaceRow(2, [](size_t c) { return Dummy(20 + static_cast<int>(c)); });
+    std::vector<int> column;
+    for (const auto &d : matrix.GetColumn(1)) {
+        column.push_back(d.m_int);
+    }
+    // second row is too short
+    ASSERT_EQ(column, (std::vector<int>{1, 21}));
+}
+
+MATRIX_TEST(ValueForEach) {
+    TestValueMatrix matrix(2, 3);
+    int visited = 0;
+    matrix.ForEach([&visited](size_t r, size_t c, Dummy &d) {
+        ASSERT_EQ(d.m_int, static_cast<int>(r * 3 + c));
+        ++visited;
+    });
+    ASSERT_EQ(visited, 6);
+}
+
+MATRIX_TEST(ValueGrowRow) {
+    TestValueMatrix matrix(3, 2);
+    matrix.ResizeRow(1, 4, [](size_t c) { return Dummy(100 + static_cast<int>(c)); });
+    ASSERT_EQ(matrix.GetRow(1).size(), 4);
+    ASSERT_EQ(matrix.At(1, 1).m_int, 3); // kept
+    ASSERT_EQ(matrix.At(1, 2).m_int, 102); // new
+    ASSERT_EQ(matrix.At(1, 3).m_int, 103);
+    ASSERT_EQ(matrix.At(2, 0).m_int, 4); // shifted
+    ASSERT_EQ(matrix.GetSerializedMatrix().size(), 8);
+}
+
+MATRIX_TEST(ValueShrinkRow) {
+    TestValueMatrix matrix(3, 3);
+    matrix.ResizeRow(0, 1, [](size_t) { return Dummy(); });
+    ASSERT_EQ(matrix.GetRow(0).size(), 1);
+    ASSERT_EQ(matrix.At(1, 0).m_int, 3);
+    ASSERT_EQ(matrix.At(2, 2).m_int, 8);
+    ASSERT_EQ(matrix.GetSerializedMatrix().size(), 7);
+    ASSERT_THROW(matrix.ResizeRow(0, 0, [](size_t) { return Dummy(); }), std::invalid_argument);
+}
+
+MATRIX_TEST(NonMovableNeedsReserve) {
+    TestNonMovableMatrix matrix;
+    matrix.Reserve(4);
+    matrix.EmplaceRow(2, [](size_t c) { return NonMovableDummy(static_cast<int>(c)); });
+    matrix.EmplaceRow(2, [](size_t c) { return NonMovableDummy(static_cast<int>(c)); });
+    ASSERT_EQ(matrix.At(1, 1).m_int, 1);
+    ASSERT_THROW(matrix.EmplaceRow(1, [](size_t) { return NonMovableDummy(); }), std::length_error);
+}
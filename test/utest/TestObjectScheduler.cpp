@@ -0,0 +1,334 @@
+#include <ObjectScheduler.h>
+#include <GameObject.h>
+#include <WindowBase.h>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+    constexpr float FrameTime = 1.0f / 60;
+
+    class Prop : public GameObject
+    {
+    public:
+        Prop()
+            : GameObject("prop")
+        {
+        }
+
+        size_t updates = 0;
+        float lastElapsed = 0;
+        std::function<void()> onUpdate;
+
+    protected:
+        void OnUpdate() override
+        {
+            ++updates;
+            lastElapsed = GetElapsedTime();
+            if (onUpdate)
+            {
+                onUpdate();
+            }
+        }
+    };
+}
+
+class ObjectSchedulerTest : public testing::Test
+{
+protected:
+    Prop *AddProp()
+    {
+        m_props.push_back(std::make_unique<Prop>());
+        m_scheduler.Add(m_props.back().get());
+        return m_props.back().get();
+    }
+
+    void RunFrames(size_t framesNum)
+    {
+        for (size_t i = 0; i < framesNum; ++i)
+        {
+            m_scheduler.Update(FrameTime);
+        }
+    }
+
+    ObjectScheduler m_scheduler;
+    std::vector<std::unique_ptr<Prop>> m_props;
+};
+
+TEST_F(ObjectSchedulerTest, SleepingObjectShouldNotBeUpdatedUntilWoken)
+{
+    auto *prop = AddProp();
+    m_scheduler.Update(FrameTime);
+    m_scheduler.Sleep(prop);
+    ASSERT_FALSE(m_scheduler.IsAwake(prop));
+    ASSERT_EQ(m_scheduler.GetAwakeCount(), 0);
+    RunFrames(10);
+    ASSERT_EQ(prop->updates, 1);
+
+    m_scheduler.Wake(prop);
+    RunFrames(2);
+    ASSERT_EQ(prop->updates, 3);
+}
+
+TEST_F(ObjectSchedulerTest, TimedSleepShouldWakeAfterFrames)
+{
+    auto *prop = AddProp();
+    prop->onUpdate = [this, prop] { m_scheduler.SleepFor(prop, 3); };
+    RunFrames(10); // updated at frames 1, 4, 7, 10
+    ASSERT_EQ(prop->updates, 4);
+}
+
+TEST_F(ObjectSchedulerTest, SleepLongerThanWheelShouldWakeOnTime)
+{
+    auto *prop = AddProp();
+    m_scheduler.SleepFor(prop, ObjectScheduler::WheelSize * 2 + 5);
+    RunFrames(ObjectScheduler::WheelSize * 2 + 4);
+    ASSERT_EQ(prop->updates, 0);
+    m_scheduler.Update(FrameTime);
+    ASSERT_EQ(prop->updates, 1);
+}
+
+TEST_F(ObjectSchedulerTest, EarlyWakeShouldCancelTimer)
+{
+    auto *prop = AddProp();
+    m_scheduler.SleepFor(prop, 5);
+    m_scheduler.Update(FrameTime);
+    m_scheduler.Wake(prop);
+    m_scheduler.Sleep(prop);
+    RunFrames(10);
+    ASSERT_EQ(prop->updates, 0) << "Stale timer must not wake the object sleeping until woken";
+}
+
+TEST_F(ObjectSchedulerTest, ObjectWokenDuringUpdateShouldBeUpdatedNextFrame)
+{
+    auto *sleeper = AddProp();
+    auto *waker = AddProp();
+    m_scheduler.Sleep(sleeper);
+    waker->onUpdate = [this, sleeper] { m_scheduler.Wake(sleeper); };
+    m_scheduler.Update(FrameTime);
+    ASSERT_EQ(sleeper->updates, 0);
+    m_scheduler.Update(FrameTime);
+    ASSERT_EQ(sleeper->updates, 1);
+}
+
+TEST_F(ObjectSchedulerTest, RemovedObjectShouldNotBeUpdated)
+{
+    auto *removed = AddProp();
+    auto *other = AddProp();
+    other->onUpdate = [this, removed] { m_scheduler.Remove(removed); };
+    // removed is updated before other in the first frame
+    RunFrames(3);
+    ASSERT_EQ(removed->updates, 1);
+    ASSERT_EQ(other->updates, 3);
+    ASSERT_FALSE(m_scheduler.Contains(removed));
+    ASSERT_EQ(m_scheduler.GetCount(), 1);
+
+    auto *added = AddProp();
+    RunFrames(1);
+    ASSERT_EQ(added->updates, 1);
+}
+
+TEST_F(ObjectSchedulerTest, UpdateShouldVisitOnlyAwakeObjects)
+{
+    constexpr size_t PropsNum = 10000;
+    for (size_t i = 0; i < PropsNum; ++i)
+    {
+        auto *prop = AddProp();
+        if (i % 100)
+        {
+            m_scheduler.Sleep(prop);
+        }
+    }
+    RunFrames(5);
+    ASSERT_EQ(m_scheduler.GetAwakeCount(), PropsNum / 100);
+
+    size_t updates = 0;
+    for (const auto &prop : m_props)
+    {
+        updates += prop->updates;
+    }
+    ASSERT_EQ(updates, 5 * PropsNum / 100);
+}
+
+TEST_F(ObjectSchedulerTest, TierShouldBeSpreadEvenlyOverFrames)
+{
+    for (size_t i = 0; i < 60; ++i)
+    {
+        m_scheduler.SetUpdateInterval(AddProp(), UpdateTier::HZ_10);
+    }
+    auto *everyFrame = AddProp();
+
+    for (size_t frame = 0; frame < 12; ++frame)
+    {
+        size_t before = 0;
+        for (const auto &prop : m_props)
+        {
+            before += prop->updates;
+        }
+        m_scheduler.Update(FrameTime);
+        size_t after = 0;
+        for (const auto &prop : m_props)
+        {
+            after += prop->updates;
+        }
+        ASSERT_EQ(after - before, 60 / UpdateTier::HZ_10 + 1) << "frame " << frame;
+    }
+    ASSERT_EQ(everyFrame->updates, 12);
+    ASSERT_EQ(m_props[0]->updates, 2);
+    ASSERT_NEAR(m_props[0]->lastElapsed, UpdateTier::HZ_10 * FrameTime, 1e-4);
+    ASSERT_NEAR(everyFrame->lastElapsed, FrameTime, 1e-6);
+}
+
+TEST_F(ObjectSchedulerTest, RemovedObjectShouldFreeItsBucket)
+{
+    std::vector<Prop *> props;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        props.push_back(AddProp());
+        m_scheduler.SetUpdateInterval(props.back(), 4);
+    }
+    m_scheduler.Remove(props[1]);
+    auto *added = AddProp();
+    m_scheduler.SetUpdateInterval(added, 4);
+    m_scheduler.SetUpdateInterval(props[2], 1);
+    m_scheduler.SetUpdateInterval(props[2], 4);
+
+    // one object per frame
+    for (size_t frame = 0; frame < 4; ++frame)
+    {
+        size_t before = props[0]->updates + props[2]->updates + props[3]->updates + added->updates;
+        m_scheduler.Update(FrameTime);
+        ASSERT_EQ(props[0]->updates + props[2]->updates + props[3]->updates + added->updates, before + 1);
+    }
+}
+
+TEST_F(ObjectSchedulerTest, ShouldBeIdleWithoutAwakeAndTimedObjects)
+{
+    auto *prop = AddProp();
+    ASSERT_FALSE(m_scheduler.IsIdle());
+    m_scheduler.SleepFor(prop, 2);
+    ASSERT_FALSE(m_scheduler.IsIdle()) << "Timed sleeps need the frames to go on";
+    RunFrames(2);
+    ASSERT_TRUE(m_scheduler.IsAwake(prop));
+    m_scheduler.Sleep(prop);
+    ASSERT_TRUE(m_scheduler.IsIdle());
+    m_scheduler.Remove(prop);
+    ASSERT_TRUE(m_scheduler.IsIdle());
+}
+
+TEST_F(ObjectSchedulerTest, DeactivationShouldKeepSleepState)
+{
+    auto *sleeper = AddProp();
+    auto *timed = AddProp();
+    auto *overslept = AddProp();
+    m_scheduler.Sleep(sleeper);
+    m_scheduler.SleepFor(timed, 10);
+    m_scheduler.SleepFor(overslept, 2);
+    for (auto *prop : { sleeper, timed, overslept })
+    {
+        m_scheduler.SetActive(prop, false);
+    }
+    ASSERT_TRUE(m_scheduler.IsIdle());
+    RunFrames(5);
+    ASSERT_TRUE(m_scheduler.Contains(sleeper));
+    ASSERT_FALSE(m_scheduler.IsActive(sleeper));
+
+    for (auto *prop : { sleeper, timed, overslept })
+    {
+        m_scheduler.SetActive(prop, true);
+    }
+    ASSERT_FALSE(m_scheduler.IsAwake(sleeper));
+    ASSERT_FALSE(m_scheduler.IsAwake(timed));
+    ASSERT_TRUE(m_scheduler.IsAwake(overslept));
+    RunFrames(5);
+    ASSERT_EQ(sleeper->updates, 0);
+    ASSERT_EQ(timed->updates, 1);
+    ASSERT_EQ(overslept->updates, 5);
+}
+
+TEST_F(ObjectSchedulerTest, InactiveObjectShouldNotBeUpdatedWhenWoken)
+{
+    auto *prop = AddProp();
+    m_scheduler.SetActive(prop, false);
+    m_scheduler.Sleep(prop);
+    m_scheduler.Wake(prop);
+    RunFrames(2);
+    ASSERT_EQ(prop->updates, 0);
+    ASSERT_EQ(m_scheduler.GetAwakeCount(), 0);
+
+    m_scheduler.SetActive(prop, true);
+    RunFrames(2);
+    ASSERT_EQ(prop->updates, 2);
+    ASSERT_FLOAT_EQ(prop->lastElapsed, FrameTime);
+}
+
+TEST(WindowObjects, DeactivatedObjectShouldKeepSleeping)
+{
+    HeadlessWindow window;
+    const auto prop = std::make_shared<Prop>();
+    const auto id = window.AppendObject(prop, true);
+    window.SleepObject(id);
+    window.SetObjectActive(id, false);
+    window.SetObjectActive(id, true);
+    window.Update(FrameTime);
+    ASSERT_EQ(prop->updates, 0);
+
+    window.WakeObject(id);
+    window.Update(FrameTime);
+    ASSERT_EQ(prop->updates, 1);
+}
+
+TEST_F(ObjectSchedulerTest, DeactivationShouldKeepUpdateInterval)
+{
+    auto *kept = AddProp();
+    auto *setWhileInactive = AddProp();
+    auto *other = AddProp();
+    m_scheduler.SetUpdateInterval(kept, 4);
+    m_scheduler.SetActive(kept, false);
+    m_scheduler.SetActive(setWhileInactive, false);
+    m_scheduler.SetUpdateInterval(setWhileInactive, 4);
+    // the inactive ones don't hold buckets: the active object of the tier gets the first one
+    m_scheduler.SetUpdateInterval(other, 4);
+
+    m_scheduler.SetActive(kept, true);
+    m_scheduler.SetActive(setWhileInactive, true);
+    RunFrames(8);
+    ASSERT_EQ(kept->updates, 2);
+    ASSERT_EQ(setWhileInactive->updates, 2);
+    ASSERT_EQ(other->updates, 2);
+    // spread over the tier's frames
+    for (size_t frame = 0; frame < 4; ++frame)
+    {
+        const auto before = kept->updates + setWhileInactive->updates + other->updates;
+        m_scheduler.Update(FrameTime);
+        ASSERT_LE(kept->updates + setWhileInactive->updates + other->updates, before + 1);
+    }
+}
+
+TEST(WindowObjects, InactiveObjectShouldKeepUpdateInterval)
+{
+    HeadlessWindow window;
+    const auto prop = std::make_shared<Prop>();
+    const auto id = window.AppendObject(prop, false);
+    window.SetObjectUpdateInterval(id, UpdateTier::HZ_30);
+    window.SetObjectActive(id, true);
+    for (int i = 0; i < 4; ++i)
+    {
+        window.Update(FrameTime);
+    }
+    ASSERT_EQ(prop->updates, 2);
+
+    window.SetObjectActive(id, false);
+    window.SetObjectActive(id, true);
+    for (int i = 0; i < 4; ++i)
+    {
+        window.Update(FrameTime);
+    }
+    ASSERT_EQ(prop->updates, 4);
+}
@@ -0,0 +1,120 @@
+#include <TaskScheduler.h>
+#include <GameLoop.h>
+#include <WindowBase.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace GameEngine;
+using namespace std::chrono_literals;
+
+namespace
+{
+    // done after the given number of steps
+    TaskScheduler::Step Steps(int stepsNum, std::string &log, char name)
+    {
+        return [stepsNum, &log, name]() mutable
+        {
+            log += name;
+            return --stepsNum == 0;
+        };
+    }
+}
+
+TEST(TaskScheduler, TasksShouldBeSteppedUntilDone)
+{
+    TaskScheduler tasks;
+    std::string log;
+    const auto id = tasks.Add(Steps(3, log, 'a'));
+    ASSERT_TRUE(tasks.Contains(id));
+    tasks.Run(1s);
+    ASSERT_EQ(log, "aaa");
+    ASSERT_FALSE(tasks.Contains(id));
+    ASSERT_EQ(tasks.GetCount(), 0);
+
+    const auto &stats = tasks.GetLastStats();
+    ASSERT_EQ(stats.steps, 3);
+    ASSERT_EQ(stats.completed, 1);
+    ASSERT_EQ(stats.pending, 0);
+    ASSERT_LE(stats.usedNs, stats.budgetNs);
+}
+
+TEST(TaskScheduler, HigherPriorityShouldRunFirstAndEqualOnesInTurns)
+{
+    TaskScheduler tasks;
+    std::string log;
+    tasks.Add(Steps(2, log, 'l'), TaskPriority::LOW);
+    tasks.Add(Steps(2, log, 'a'));
+    tasks.Add(Steps(2, log, 'b'));
+    tasks.Add(Steps(2, log, 'h'), TaskPriority::HIGH);
+    tasks.Run(1s);
+    ASSERT_EQ(log, "hhababll");
+}
+
+TEST(TaskScheduler, RunShouldStopWhenBudgetIsUsed)
+{
+    TaskScheduler tasks;
+    size_t steps = 0;
+    tasks.Add([&steps]
+    {
+        ++steps;
+        std::this_thread::sleep_for(1ms);
+        return false;
+    });
+    tasks.Run(5ms);
+    ASSERT_GE(steps, 1);
+    ASSERT_LE(steps, 5);
+    ASSERT_EQ(tasks.GetLastStats().pending, 1);
+
+    // no budget: the task waits
+    tasks.Run(0ns);
+    ASSERT_EQ(tasks.GetLastStats().steps, 0);
+}
+
+TEST(TaskScheduler, StarvingTaskShouldRunWithoutBudget)
+{
+    TaskScheduler tasks;
+    std::string log;
+    tasks.Add(Steps(100, log, 'l'), TaskPriority::LOW);
+    for (uint64_t i = 0; i < TaskScheduler::StarvationRuns; ++i)
+    {
+        tasks.Run(0ns);
+    }
+    ASSERT_TRUE(log.empty());
+    tasks.Run(0ns);
+    ASSERT_EQ(log, "l");
+}
+
+TEST(TaskScheduler, StepMayAddAndCancelTasks)
+{
+    TaskScheduler tasks;
+    std::string log;
+    TaskId self = 0;
+    self = tasks.Add([&]
+    {
+        log += 's';
+        tasks.Add(Steps(1, log, 'n'));
+        tasks.Cancel(self);
+        return false;
+    }, TaskPriority::HIGH);
+    tasks.Run(1s);
+    ASSERT_EQ(log, "sn");
+    ASSERT_EQ(tasks.GetCount(), 0);
+}
+
+TEST(TaskScheduler, GameLoopShouldRunTasksBetweenFrames)
+{
+    GameLoop loop(GameLoopMode::HEADLESS);
+    loop.SetWindow(std::make_shared<HeadlessWindow>(Size2D{ 10, 10 }));
+    loop.SetFrameRate(100);
+    size_t steps = 0;
+    loop.GetTasks().Add([&steps]
+    {
+        return ++steps == 1000;
+    });
+    loop.RunFrames(3);
+    ASSERT_EQ(steps, 1000);
+    ASSERT_EQ(loop.GetTasks().GetCount(), 0);
+}
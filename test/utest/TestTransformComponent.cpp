@@ -1,6 +1,11 @@
 #include <TransformComponent.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #define FIXTURE TransformComponentTest
 #define TRANSFORM_TEST(NAME) TEST_F(FIXTURE, NAME)
 
@@ -18,7 +23,9 @@ private:
 protected:
     TransformTest m_transform;
     FIXTURE()
-        : m_transform({}) {}
+        : m_transform({}) {
+        TransformComponent::ClearChanged();
+    }
 };
 
 TRANSFORM_TEST(CheckPosition) {
@@ -217,3 +224,72 @@ TRANSFORM_TEST(CheckCombinedFlipCancelHorizontal) {
 }
 
 
+
+TRANSFORM_TEST(MutatorsBumpVersion) {
+    const auto version = m_transform.GetVersion();
+    m_transform.Move({1, 1});
+    m_transform.Rotate(10);
+    m_transform.Resize({2, 2});
+    m_transform.FlipHorizontally();
+    ASSERT_EQ(m_transform.GetVersion(), version + 4);
+}
+
+TRANSFORM_TEST(ChangedListedOnce) {
+    ASSERT_FALSE(m_transform.IsChanged());
+    m_transform.SetPosition({1, 1});
+    m_transform.SetPosition({2, 2});
+    ASSERT_TRUE(m_transform.IsChanged());
+    const auto changed = TransformComponent::GetChanged();
+    ASSERT_EQ(changed.size(), 1);
+    ASSERT_EQ(changed[0], &m_transform);
+}
+
+TRANSFORM_TEST(ClearChangedResetsList) {
+    m_transform.Rotate(1);
+    TransformComponent::ClearChanged();
+    ASSERT_FALSE(m_transform.IsChanged());
+    ASSERT_TRUE(TransformComponent::GetChanged().empty());
+    // reading doesn't change
+    (void)m_transform.GetRect();
+    ASSERT_TRUE(TransformComponent::GetChanged().empty());
+}
+
+TRANSFORM_TEST(DestroyedOnOtherThreadLeavesOwnList) {
+    class Transform : public TransformComponent {
+    public:
+        Transform() : TransformComponent({1, 1}) {}
+    };
+    auto moved = std::make_unique<Transform>();
+    Transform kept;
+    m_transform.Move({1, 1});
+    std::atomic<ChangedTransforms *> workerList = nullptr;
+    std::atomic<bool> isChecked = false;
+    std::thread worker([&] {
+        moved->Move({1, 1});
+        kept.Move({1, 1});
+        workerList = &TransformComponent::GetChangedList();
+        while (!isChecked) {
+            std::this_thread::yield();
+        }
+    });
+    while (!workerList) {
+        std::this_thread::yield();
+    }
+    moved.reset();
+    const auto workerChanged = workerList.load()->Get();
+    const std::vector<TransformComponent *> workerChangedCopy(workerChanged.begin(), workerChanged.end());
+    isChecked = true;
+    worker.join();
+    ASSERT_EQ(workerChangedCopy.size(), 1);
+    ASSERT_EQ(workerChangedCopy[0], &kept);
+    // the list of the ended thread has let the transform go
+    ASSERT_FALSE(kept.IsChanged());
+    const auto changed = TransformComponent::GetChanged();
+    ASSERT_EQ(changed.size(), 1);
+    ASSERT_EQ(changed[0], &m_transform);
+}
+
+TRANSFORM_TEST(FailedMutationIsNotChange) {
+    ASSERT_ANY_THROW(m_transform.Downscale(0));
+    ASSERT_FALSE(m_transform.IsChanged());
+}
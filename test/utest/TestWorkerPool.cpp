@@ -0,0 +1,51 @@
+#include <WorkerPool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace GameEngine;
+
+TEST(WorkerPool, ShouldRunEveryJobOnce)
+{
+    WorkerPool pool(3);
+    ASSERT_EQ(pool.GetThreadsNum(), 3);
+    std::vector<std::atomic<int>> runs(100);
+    auto job = [&runs](size_t i) { ++runs[i]; };
+    for (int batch = 0; batch < 10; ++batch)
+    {
+        pool.Run(runs.size(), WorkerPool::Job::Bind(job));
+    }
+    for (const auto &count : runs)
+    {
+        ASSERT_EQ(count, 10);
+    }
+}
+
+TEST(WorkerPool, ShouldRethrowAfterTheBatch)
+{
+    WorkerPool pool(2);
+    std::atomic<int> runs = 0;
+    auto failing = [&runs](size_t i)
+    {
+        ++runs;
+        if (i == 1)
+        {
+            throw std::runtime_error("job failed");
+        }
+    };
+    ASSERT_THROW(pool.Run(8, WorkerPool::Job::Bind(failing)), std::runtime_error);
+    ASSERT_EQ(runs, 8);
+
+    // still usable
+    runs = 0;
+    auto counting = [&runs](size_t) { ++runs; };
+    pool.Run(4, WorkerPool::Job::Bind(counting));
+    ASSERT_EQ(runs, 4);
+
+    WorkerPool inlinePool(0);
+    inlinePool.Run(4, WorkerPool::Job::Bind(counting));
+    ASSERT_EQ(runs, 8);
+}
@@ -0,0 +1,202 @@
+// Converts binary log written by BinaryLogChannel to text in the format of FileLogChannel
+#include <BinaryLogFormat.h>
+#include <Logger.h>
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace GameEngine;
+
+namespace
+{
+#define LOG_X(name) #name,
+    constexpr const char* LogLevelTags[] = {_LOG_LEVELS_};
+#undef LOG_X
+
+    struct Site
+    {
+        uint8_t level = 0;
+        uint32_t line = 0;
+        std::string file;
+        std::string format;
+    };
+
+    const char* GetLevelTag(uint8_t level)
+    {
+        return level < std::size(LogLevelTags) ? LogLevelTags[level] : "?";
+    }
+
+    void PrintLine(std::ostream& out, int64_t systemNs, uint8_t level, const std::string_view prefix, const std::string_view message)
+    {
+        const std::time_t t = systemNs / 1'000'000'000;
+        std::tm tm;
+#ifdef WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        char time[32];
+        std::strftime(time, sizeof(time), "%m%d-%H:%M:%S", &tm);
+        char millis[8];
+        std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>((systemNs / 1'000'000) % 1000));
+        out << time << millis << " [" << GetLevelTag(level) << "] ";
+        if (!prefix.empty())
+        {
+            out << prefix << ' ';
+        }
+        out << message;
+        if (message.empty() || message.back() != '\n')
+        {
+            out << '\n';
+        }
+    }
+
+    bool ReadString16(BinaryLog::Reader& reader, std::string& str)
+    {
+        uint16_t size = 0;
+        std::string_view view;
+        if (!reader.Read(size) || !reader.Read(view, size))
+        {
+            return false;
+        }
+        str = view;
+        return true;
+    }
+
+    bool Decode(std::span<const std::byte> bytes, std::ostream& out)
+    {
+        BinaryLog::Reader reader(bytes);
+        std::array<char, BinaryLog::Magic.size()> magic;
+        uint32_t version = 0;
+        if (!reader.Read(magic) || magic != BinaryLog::Magic || !reader.Read(version) || version != BinaryLog::Version)
+        {
+            std::cerr << "Not a binary log or unsupported version" << std::endl;
+            return false;
+        }
+
+        int64_t anchorSystemNs = 0;
+        int64_t anchorSteadyNs = 0;
+        std::unordered_map<uint32_t, Site> sites;
+        std::unordered_map<uint32_t, std::string> prefixes;
+
+        while (!reader.IsEmpty())
+        {
+            uint8_t kind = 0;
+            reader.Read(kind);
+            switch (static_cast<BinaryLog::RecordKind>(kind))
+            {
+                case BinaryLog::RecordKind::ANCHOR:
+                {
+                    if (!reader.Read(anchorSystemNs) || !reader.Read(anchorSteadyNs))
+                    {
+                        std::cerr << "Truncated anchor" << std::endl;
+                        return false;
+                    }
+                    break;
+                }
+                case BinaryLog::RecordKind::SITE:
+                {
+                    uint32_t id = 0;
+                    Site site;
+                    if (!reader.Read(id) || !reader.Read(site.level) || !reader.Read(site.line)
+                        || !ReadString16(reader, site.file) || !ReadString16(reader, site.format))
+                    {
+                        std::cerr << "Truncated site" << std::endl;
+                        return false;
+                    }
+                    sites[id] = std::move(site);
+                    break;
+                }
+                case BinaryLog::RecordKind::PREFIX:
+                {
+                    uint32_t id = 0;
+                    std::string prefix;
+                    if (!reader.Read(id) || !ReadString16(reader, prefix))
+                    {
+                        std::cerr << "Truncated prefix" << std::endl;
+                        return false;
+                    }
+                    prefixes[id] = std::move(prefix);
+                    break;
+                }
+                case BinaryLog::RecordKind::RECORD:
+                {
+                    uint32_t id = 0;
+                    uint32_t prefixId = 0;
+                    int64_t steadyNs = 0;
+                    uint16_t size = 0;
+                    std::string_view args;
+                    if (!reader.Read(id) || !reader.Read(prefixId) || !reader.Read(steadyNs) || !reader.Read(size) || !reader.Read(args, size))
+                    {
+                        std::cerr << "Truncated record" << std::endl;
+                        return false;
+                    }
+                    const auto site = sites.find(id);
+                    if (site == sites.end())
+                    {
+                        std::cerr << "Unknown site " << id << std::endl;
+                        return false;
+                    }
+                    const auto prefix = prefixes.find(prefixId);
+                    if (prefixId && prefix == prefixes.end())
+                    {
+                        std::cerr << "Unknown prefix " << prefixId << std::endl;
+                        return false;
+                    }
+                    const std::span argBytes{ reinterpret_cast<const std::byte*>(args.data()), args.size() };
+                    PrintLine(out, anchorSystemNs + (steadyNs - anchorSteadyNs), site->second.level,
+                              prefixId ? std::string_view{ prefix->second } : std::string_view{},
+                              BinaryLog::FormatMessage(site->second.format, argBytes));
+                    break;
+                }
+                case BinaryLog::RecordKind::TEXT:
+                {
+                    int64_t systemNs = 0;
+                    uint8_t level = 0;
+                    std::string prefix;
+                    uint32_t size = 0;
+                    std::string_view text;
+                    if (!reader.Read(systemNs) || !reader.Read(level) || !ReadString16(reader, prefix)
+                        || !reader.Read(size) || !reader.Read(text, size))
+                    {
+                        std::cerr << "Truncated text" << std::endl;
+                        return false;
+                    }
+                    PrintLine(out, systemNs, level, prefix, text);
+                    break;
+                }
+                default:
+                {
+                    std::cerr << "Unknown record kind " << static_cast<int>(kind) << std::endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <binary log file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+    const std::vector<char> content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    const std::span bytes{ reinterpret_cast<const std::byte*>(content.data()), content.size() };
+
+    return Decode(bytes, std::cout) ? 0 : 1;
+}